@@ -0,0 +1,64 @@
+#include "benchmark-runner.hpp"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+
+benchmark_runner::benchmark_runner(size_t warmup_runs, size_t repetitions)
+    : warmup_runs(warmup_runs), repetitions(std::max<size_t>(repetitions, 1)), document(nullptr) {}
+
+benchmark_result benchmark_runner::summarize(std::string name, uint64_t operations, uint64_t bytes, indexed_stack<uint64_t>& durations){
+    std::sort(durations.begin(), durations.end());
+    const size_t count = durations.get_size();
+
+    auto median_of = [count](const indexed_stack<uint64_t>& sorted) -> double {
+        return count % 2 ? static_cast<double>(sorted[count / 2]) : (static_cast<double>(sorted[count / 2 - 1]) + static_cast<double>(sorted[count / 2])) / 2.0;
+    };
+    const double median = median_of(durations);
+
+    indexed_stack<uint64_t> deviations;
+    for(uint64_t duration : durations){
+        const double deviation = static_cast<double>(duration) - median;
+        deviations.push(static_cast<uint64_t>(deviation < 0 ? -deviation : deviation));
+    }
+    std::sort(deviations.begin(), deviations.end());
+
+    return benchmark_result{
+        .name = std::move(name),
+        .operations = operations,
+        .bytes = bytes,
+        .median_ns = median,
+        .mad_ns = median_of(deviations),
+        .min_ns = static_cast<double>(durations[0]),
+        .max_ns = static_cast<double>(durations[count - 1])
+    };
+}
+
+void benchmark_runner::print_result(const benchmark_result& result){
+    const std::string throughput = result.bytes == 0 ? std::string("-") : std::format("{:.2f}", result.gb_per_s());
+    std::cout << std::format("  {:<60} {:>10} {:>12.3f} {:>12.1f} {:>8} {:>7.2f}% {:>12.3f} {:>12.3f}\n",
+        result.name, result.operations, result.median_ns / 1e6, result.ns_per_op(), throughput,
+        result.spread() * 100, result.min_ns / 1e6, result.max_ns / 1e6
+    );
+}
+
+const indexed_stack<benchmark_result>& benchmark_runner::get_results() const noexcept {
+    return results;
+}
+
+void benchmark_runner::compare(const benchmark_result& result, const benchmark_result& baseline) const {
+    const double ratio = baseline.ns_per_op() == 0 ? 0.0 : result.ns_per_op() / baseline.ns_per_op();
+    std::cout << std::format("    {:.2f}x the time of {} ({})\n", ratio, baseline.name, ratio <= 1.0 ? "faster" : "slower");
+}
+
+void benchmark_runner::set_results(results_document* document) noexcept {
+    this->document = document;
+}
+
+void benchmark_runner::print_section(std::string_view title){
+    section = title;
+    std::cout << std::format("{} ({} warm-up runs, {} repetitions):\n", title, warmup_runs, repetitions);
+    std::cout << std::format("  {:<60} {:>10} {:>12} {:>12} {:>8} {:>8} {:>12} {:>12}\n",
+        "benchmark", "ops", "median (ms)", "ns/op", "GB/s", "MAD", "min (ms)", "max (ms)"
+    );
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#ifndef BENCHMARK_RUNNER_HPP
+#define BENCHMARK_RUNNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <format>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "../../src/common/indexed-stack/indexed-stack.hpp"
+#include "../../src/common/gc-pause/gc-pause.hpp"
+#include "../../src/common/results-document/results-document.hpp"
+
+/// number of untimed runs before the measured repetitions.
+constexpr size_t DEFAULT_WARMUP_RUNS = 3;
+
+/// number of measured repetitions of a benchmark.
+constexpr size_t DEFAULT_REPETITIONS = 15;
+
+/**
+ * @struct benchmark_result
+ * @brief distribution of the durations of a benchmark's repetitions.
+*/
+struct benchmark_result {
+    /// name of the benchmark.
+    std::string name;
+
+    /// number of operations done by a single repetition.
+    uint64_t operations;
+
+    /// number of bytes processed by a single repetition, 0 if benchmark doesn't measure throughput.
+    uint64_t bytes;
+
+    /// median duration of a repetition in nanoseconds.
+    double median_ns;
+
+    /// median absolute deviation of the durations in nanoseconds.
+    double mad_ns;
+
+    /// shortest repetition in nanoseconds.
+    double min_ns;
+
+    /// longest repetition in nanoseconds.
+    double max_ns;
+
+    /**
+     * @brief calculates the median duration of an operation.
+     * @returns nanoseconds per operation, 0 if benchmark has no operations.
+    */
+    double ns_per_op() const noexcept {
+        return operations == 0 ? 0.0 : median_ns / static_cast<double>(operations);
+    }
+
+    /**
+     * @brief calculates the median throughput.
+     * @returns gigabytes per second, 0 if benchmark doesn't measure throughput.
+    */
+    double gb_per_s() const noexcept {
+        return bytes == 0 || median_ns == 0 ? 0.0 : static_cast<double>(bytes) / median_ns;
+    }
+
+    /**
+     * @brief calculates the relative spread of the durations.
+     * @returns median absolute deviation / median, 0 if median is 0.
+    */
+    double spread() const noexcept {
+        return median_ns == 0 ? 0.0 : mad_ns / median_ns;
+    }
+};
+
+/**
+ * @class benchmark_runner
+ * @brief runs benchmarks with warm-up and repetitions, reports median and spread of each.
+ * @details setup of each repetition isn't timed. Body is timed on the steady clock,
+ * unless it returns its own duration in nanoseconds as uint64_t.
+*/
+class benchmark_runner {
+private:
+    /// number of untimed runs before the measured repetitions.
+    size_t warmup_runs;
+
+    /// number of measured repetitions.
+    size_t repetitions;
+
+    /// results of the benchmarks, in the order they ran.
+    indexed_stack<benchmark_result> results;
+
+    /// document the durations per operation are added to, nullptr if they aren't recorded.
+    results_document* document;
+
+    /// title of the current group of benchmarks.
+    std::string section;
+
+    /**
+     * @brief runs the body once.
+     * @param body - reference to the timed body.
+     * @returns duration of the body in nanoseconds.
+    */
+    template<typename body_fn>
+    static uint64_t time_body(body_fn& body) {
+        if constexpr (std::is_void_v<std::invoke_result_t<body_fn&>>){
+            const uint64_t start_ns = gc_pause_report::clock_ns();
+            body();
+            return gc_pause_report::clock_ns() - start_ns;
+        }
+        else {
+            return static_cast<uint64_t>(body());
+        }
+    }
+
+    /**
+     * @brief calculates the distribution of the durations.
+     * @param name - name of the benchmark.
+     * @param operations - number of operations of a repetition.
+     * @param bytes - number of bytes processed by a repetition.
+     * @param durations - reference to the durations of the repetitions in nanoseconds, sorted in place.
+     * @returns result of the benchmark.
+    */
+    static benchmark_result summarize(std::string name, uint64_t operations, uint64_t bytes, indexed_stack<uint64_t>& durations);
+
+    /**
+     * @brief prints the result as a row of the report.
+     * @param result - const reference to the result.
+    */
+    static void print_result(const benchmark_result& result);
+
+public:
+    /**
+     * @brief creates the instance of the benchmark runner.
+     * @param warmup_runs - number of untimed runs before the measured repetitions, defaults to DEFAULT_WARMUP_RUNS.
+     * @param repetitions - number of measured repetitions, at least 1, defaults to DEFAULT_REPETITIONS.
+    */
+    benchmark_runner(size_t warmup_runs = DEFAULT_WARMUP_RUNS, size_t repetitions = DEFAULT_REPETITIONS);
+
+    /**
+     * @brief deletes the instance of the benchmark runner.
+    */
+    ~benchmark_runner() = default;
+
+    /**
+     * @brief runs the benchmark and prints its result.
+     * @param name - name of the benchmark.
+     * @param operations - number of operations done by a single run of the body.
+     * @param bytes - number of bytes processed by a single run of the body, 0 if throughput isn't measured.
+     * @param setup - untimed preparation, called before every run of the body.
+     * @param body - timed part of the benchmark.
+     * @returns result of the benchmark.
+    */
+    template<typename setup_fn, typename body_fn>
+    benchmark_result run(std::string name, uint64_t operations, uint64_t bytes, setup_fn&& setup, body_fn&& body) {
+        for(size_t i = 0; i < warmup_runs; ++i){
+            setup();
+            time_body(body);
+        }
+
+        indexed_stack<uint64_t> durations;
+        for(size_t i = 0; i < repetitions; ++i){
+            setup();
+            durations.push(time_body(body));
+        }
+
+        if(document != nullptr){
+            indexed_stack<double> ns_per_op;
+            for(uint64_t duration : durations){
+                ns_per_op.push(static_cast<double>(duration) / static_cast<double>(std::max<uint64_t>(operations, 1)));
+            }
+            document->add_metric(std::format("{}/{}", section, name), "ns/op", metric_goal::lower, std::move(ns_per_op));
+        }
+
+        results.push(summarize(std::move(name), operations, bytes, durations));
+        print_result(results.peek());
+        return results.peek();
+    }
+
+    /**
+     * @brief getter for the results of the benchmarks.
+     * @returns const reference to the results, in the order benchmarks ran.
+    */
+    const indexed_stack<benchmark_result>& get_results() const noexcept;
+
+    /**
+     * @brief prints how the result compares to the baseline.
+     * @param result - const reference to the result of the measured implementation.
+     * @param baseline - const reference to the result of the baseline implementation.
+     * @details ratio of the median durations per operation, below 1 means the measured implementation is faster.
+    */
+    void compare(const benchmark_result& result, const benchmark_result& baseline) const;
+
+    /**
+     * @brief records the durations per operation of the following benchmarks.
+     * @param document - pointer to the document the metrics are added to, nullptr stops recording.
+     * @details metrics are named section/benchmark, the document must outlive the recording.
+    */
+    void set_results(results_document* document) noexcept;
+
+    /**
+     * @brief prints the header of the report and the section title.
+     * @param title - title of the group of benchmarks.
+    */
+    void print_section(std::string_view title);
+
+    /**
+     * @brief prevents the compiler from optimizing away the value.
+     * @param value - const reference to the value that is kept.
+    */
+    template<typename T>
+    static void do_not_optimize(const T& value) noexcept {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "../src/common/results-document/results-document.hpp"
+#include "../src/results-comparison/results-comparison.hpp"
+
+int main(int argc, char** argv) {
+    const std::string usage = std::format(
+        "Usage: {} [--significance P] [--min-change F] <baseline.json> <candidate.json>\n"
+        "  --significance        p-value at or below which a difference is significant (default {})\n"
+        "  --min-change          smallest relative change of the median that is flagged (default {})\n"
+        "Exits with 1 if any metric regressed, 2 if the arguments or the documents are invalid.\n",
+        argv[0], DEFAULT_SIGNIFICANCE, DEFAULT_MIN_CHANGE
+    );
+
+    auto parse_fraction = [](std::string_view value, double& result) -> bool {
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+        return error == std::errc() && end == value.data() + value.size() && result > 0 && result < 1;
+    };
+
+    double significance = DEFAULT_SIGNIFICANCE;
+    double min_change = DEFAULT_MIN_CHANGE;
+    std::string paths[2];
+    size_t path_count = 0;
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg == "--help" || arg == "-h"){
+            std::cout << usage;
+            return 0;
+        }
+        if(arg == "--significance" || arg == "--min-change"){
+            double& target = arg == "--significance" ? significance : min_change;
+            if(i + 1 == argc || !parse_fraction(argv[i + 1], target)){
+                std::cerr << std::format("Invalid value for {}, expected a number within (0, 1)\n{}", arg, usage);
+                return 2;
+            }
+            ++i;
+        }
+        else if(path_count < 2){
+            paths[path_count++] = arg;
+        }
+        else {
+            std::cerr << usage;
+            return 2;
+        }
+    }
+    if(path_count != 2){
+        std::cerr << usage;
+        return 2;
+    }
+
+    results_document baseline;
+    results_document candidate;
+    for(size_t i = 0; i < 2; ++i){
+        results_document& document = i == 0 ? baseline : candidate;
+        if(!document.load(paths[i])){
+            std::cerr << std::format("Failed to read results document {}\n", paths[i]);
+            return 2;
+        }
+    }
+
+    std::cout << std::format("Baseline:  {} ({} at {})\n", paths[0], baseline.get_tool(), baseline.get_revision());
+    std::cout << std::format("Candidate: {} ({} at {})\n", paths[1], candidate.get_tool(), candidate.get_revision());
+
+    results_comparison comparison(significance, min_change);
+    comparison.compare(baseline, candidate);
+    std::cout << comparison.report();
+
+    return comparison.count(comparison_verdict::regression) == 0 ? 0 : 1;
+}
\ No newline at end of file
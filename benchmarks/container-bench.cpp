@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark-runner/benchmark-runner.hpp"
+#include "../src/common/hash-map/hash-map.hpp"
+#include "../src/common/queue/queue.hpp"
+#include "../src/common/indexed-stack/indexed-stack.hpp"
+#include "../src/common/thread-pool/thread-pool.hpp"
+
+/// number of keys of the hash map benchmarks.
+constexpr size_t MAP_BENCH_KEYS = 100'000;
+
+/// load factors of the hash map after all keys are inserted, hash_map resizes above MAX_LOAD_FACTOR.
+constexpr double MAP_BENCH_LOAD_FACTORS[] = {0.25, 0.5, 0.75};
+
+/// number of elements of the queue and indexed_stack benchmarks.
+constexpr size_t SEQUENCE_BENCH_ELEMENTS = 100'000;
+
+/// depth of the stack during the steady push/pop benchmark.
+constexpr size_t STACK_BENCH_STEADY_DEPTH = 1'000;
+
+/// number of enqueue round trips of the thread pool latency benchmark.
+constexpr size_t POOL_BENCH_ROUND_TRIPS = 2'000;
+
+/// number of threads spawned by the thread-per-task baseline of the latency benchmark.
+constexpr size_t POOL_BENCH_SPAWNED_THREADS = 200;
+
+/// number of tasks enqueued by each producer of the thread pool throughput benchmark.
+constexpr size_t POOL_BENCH_TASKS_PER_PRODUCER = 20'000;
+
+/// numbers of threads that enqueue tasks at the same time.
+constexpr size_t POOL_BENCH_PRODUCERS[] = {1, 2, 4, 8};
+
+/**
+ * @class container_benchmark
+ * @brief microbenchmarks of the custom containers, each reported next to its standard library baseline.
+*/
+class container_benchmark {
+private:
+    /// runner that times the benchmarks.
+    benchmark_runner& runner;
+
+    /// number of worker threads of the benchmarked thread pools.
+    size_t pool_thread_count;
+
+    /**
+     * @brief generates the i-th key of a benchmark.
+     * @tparam K - type of the key.
+     * @param i - index of the key.
+     * @param long_key - whether string keys exceed the small string buffer.
+     * @returns unique key.
+    */
+    template<typename K>
+    static K make_key(size_t i, bool long_key) {
+        if constexpr (std::is_same_v<K, size_t>){
+            return i * 0x9E3779B97F4A7C15ull;
+        }
+        else {
+            return long_key ? std::format("segment/allocation-site/root-{:032}", i) : std::format("r{:06}", i);
+        }
+    }
+
+    /**
+     * @brief measures insert, find and erase of hash_map and std::unordered_map at each load factor.
+     * @tparam K - type of the key.
+     * @param key_name - name of the key type in the report.
+     * @param long_key - whether string keys exceed the small string buffer.
+    */
+    template<typename K>
+    void hash_map_operations(std::string_view key_name, bool long_key) {
+        std::vector<K> keys;
+        keys.reserve(MAP_BENCH_KEYS);
+        for(size_t i = 0; i < MAP_BENCH_KEYS; ++i){
+            keys.push_back(make_key<K>(i, long_key));
+        }
+
+        for(double load_factor : MAP_BENCH_LOAD_FACTORS){
+            const size_t buckets = static_cast<size_t>(static_cast<double>(MAP_BENCH_KEYS) / load_factor) + 1;
+            std::unique_ptr<hash_map<K, size_t>> map;
+            std::unique_ptr<std::unordered_map<K, size_t>> baseline;
+
+            auto reset_map = [&](bool fill) -> void {
+                map = std::make_unique<hash_map<K, size_t>>(buckets);
+                if(!fill) return;
+                for(size_t i = 0; i < keys.size(); ++i){
+                    map->insert(keys[i], i);
+                }
+            };
+            auto reset_baseline = [&](bool fill) -> void {
+                baseline = std::make_unique<std::unordered_map<K, size_t>>();
+                baseline->rehash(buckets);
+                if(!fill) return;
+                for(size_t i = 0; i < keys.size(); ++i){
+                    baseline->emplace(keys[i], i);
+                }
+            };
+
+            const std::string label = std::format("{} keys, load factor {:.2f}", key_name, load_factor);
+            benchmark_result measured = runner.run(std::format("hash_map insert, {}", label), keys.size(), 0, [&] -> void { reset_map(false); }, [&] -> void {
+                for(size_t i = 0; i < keys.size(); ++i){
+                    map->insert(keys[i], i);
+                }
+            });
+            runner.compare(measured, runner.run(std::format("unordered_map insert, {}", label), keys.size(), 0, [&] -> void { reset_baseline(false); }, [&] -> void {
+                for(size_t i = 0; i < keys.size(); ++i){
+                    baseline->emplace(keys[i], i);
+                }
+            }));
+
+            reset_map(true);
+            reset_baseline(true);
+            measured = runner.run(std::format("hash_map find, {}", label), keys.size(), 0, [] -> void {}, [&] -> void {
+                for(const K& key : keys){
+                    benchmark_runner::do_not_optimize(map->find(key));
+                }
+            });
+            runner.compare(measured, runner.run(std::format("unordered_map find, {}", label), keys.size(), 0, [] -> void {}, [&] -> void {
+                for(const K& key : keys){
+                    benchmark_runner::do_not_optimize(baseline->find(key));
+                }
+            }));
+
+            measured = runner.run(std::format("hash_map erase, {}", label), keys.size(), 0, [&] -> void { reset_map(true); }, [&] -> void {
+                for(const K& key : keys){
+                    benchmark_runner::do_not_optimize(map->erase(key));
+                }
+            });
+            runner.compare(measured, runner.run(std::format("unordered_map erase, {}", label), keys.size(), 0, [&] -> void { reset_baseline(true); }, [&] -> void {
+                for(const K& key : keys){
+                    benchmark_runner::do_not_optimize(baseline->erase(key));
+                }
+            }));
+        }
+    }
+
+public:
+    /**
+     * @brief creates the container benchmarks.
+     * @param runner - reference to the runner that times the benchmarks.
+     * @param pool_thread_count - number of worker threads of the benchmarked thread pools.
+    */
+    container_benchmark(benchmark_runner& runner, size_t pool_thread_count) : runner(runner), pool_thread_count(pool_thread_count) {}
+
+    /**
+     * @brief measures hash_map with integer, short string and long string keys.
+    */
+    void hash_maps() {
+        runner.print_section("hash_map vs std::unordered_map");
+        hash_map_operations<size_t>("size_t", false);
+        hash_map_operations<std::string>("short string", false);
+        hash_map_operations<std::string>("long string", true);
+    }
+
+    /**
+     * @brief measures push and pop of queue and std::deque.
+    */
+    void queues() {
+        runner.print_section("queue vs std::deque");
+        std::unique_ptr<queue<size_t>> fifo;
+        std::unique_ptr<std::deque<size_t>> baseline;
+
+        auto reset_queue = [&](bool fill) -> void {
+            fifo = std::make_unique<queue<size_t>>();
+            for(size_t i = 0; fill && i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                fifo->push(i);
+            }
+        };
+        auto reset_baseline = [&](bool fill) -> void {
+            baseline = std::make_unique<std::deque<size_t>>();
+            for(size_t i = 0; fill && i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                baseline->push_back(i);
+            }
+        };
+
+        benchmark_result measured = runner.run("queue push", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_queue(false); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                fifo->push(i);
+            }
+        });
+        runner.compare(measured, runner.run("deque push_back", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_baseline(false); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                baseline->push_back(i);
+            }
+        }));
+
+        measured = runner.run("queue pop", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_queue(true); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                benchmark_runner::do_not_optimize(fifo->pop());
+            }
+        });
+        runner.compare(measured, runner.run("deque pop_front", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_baseline(true); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                benchmark_runner::do_not_optimize(baseline->front());
+                baseline->pop_front();
+            }
+        }));
+    }
+
+    /**
+     * @brief measures growing push, shrinking pop and steady push/pop of indexed_stack and std::vector.
+    */
+    void indexed_stacks() {
+        runner.print_section("indexed_stack vs std::vector");
+        std::unique_ptr<indexed_stack<size_t>> stack;
+        std::unique_ptr<std::vector<size_t>> baseline;
+
+        auto reset_stack = [&](size_t elements) -> void {
+            stack = std::make_unique<indexed_stack<size_t>>();
+            for(size_t i = 0; i < elements; ++i){
+                stack->push(i);
+            }
+        };
+        auto reset_baseline = [&](size_t elements) -> void {
+            baseline = std::make_unique<std::vector<size_t>>();
+            for(size_t i = 0; i < elements; ++i){
+                baseline->push_back(i);
+            }
+        };
+
+        benchmark_result measured = runner.run("indexed_stack push, growing", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_stack(0); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                stack->push(i);
+            }
+        });
+        runner.compare(measured, runner.run("vector push_back, growing", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_baseline(0); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                baseline->push_back(i);
+            }
+        }));
+
+        measured = runner.run("indexed_stack pop, shrinking", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_stack(SEQUENCE_BENCH_ELEMENTS); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                stack->pop();
+            }
+        });
+        runner.compare(measured, runner.run("vector pop_back", SEQUENCE_BENCH_ELEMENTS, 0, [&] -> void { reset_baseline(SEQUENCE_BENCH_ELEMENTS); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                baseline->pop_back();
+            }
+        }));
+
+        measured = runner.run(std::format("indexed_stack push/pop at depth {}", STACK_BENCH_STEADY_DEPTH), SEQUENCE_BENCH_ELEMENTS, 0,
+            [&] -> void { reset_stack(STACK_BENCH_STEADY_DEPTH); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                stack->push(i);
+                stack->pop();
+            }
+        });
+        runner.compare(measured, runner.run(std::format("vector push_back/pop_back at depth {}", STACK_BENCH_STEADY_DEPTH), SEQUENCE_BENCH_ELEMENTS, 0,
+            [&] -> void { reset_baseline(STACK_BENCH_STEADY_DEPTH); }, [&] -> void {
+            for(size_t i = 0; i < SEQUENCE_BENCH_ELEMENTS; ++i){
+                baseline->push_back(i);
+                baseline->pop_back();
+            }
+        }));
+    }
+
+    /**
+     * @brief measures the enqueue round trip latency and the task throughput of thread_pool.
+     * @details round trip is the time from enqueue until the caller sees the task finished,
+     * its baseline spawns and joins a thread per task. Throughput is measured with 1 to N producers enqueueing at the same time.
+    */
+    void thread_pools() {
+        runner.print_section(std::format("thread_pool ({} workers)", pool_thread_count));
+        {
+            thread_pool pool(pool_thread_count);
+            std::atomic<bool> done{false};
+            benchmark_result measured = runner.run("thread_pool enqueue round trip", POOL_BENCH_ROUND_TRIPS, 0, [] -> void {}, [&] -> void {
+                for(size_t i = 0; i < POOL_BENCH_ROUND_TRIPS; ++i){
+                    done.store(false, std::memory_order_relaxed);
+                    pool.enqueue([&done] -> void {
+                        done.store(true, std::memory_order_release);
+                        done.notify_one();
+                    });
+                    done.wait(false, std::memory_order_acquire);
+                }
+            });
+            runner.compare(measured, runner.run("thread per task round trip", POOL_BENCH_SPAWNED_THREADS, 0, [] -> void {}, [&] -> void {
+                for(size_t i = 0; i < POOL_BENCH_SPAWNED_THREADS; ++i){
+                    std::jthread worker([&done] -> void { done.store(true, std::memory_order_release); });
+                }
+            }));
+        }
+
+        for(size_t producers : POOL_BENCH_PRODUCERS){
+            thread_pool pool(pool_thread_count);
+            const size_t tasks = producers * POOL_BENCH_TASKS_PER_PRODUCER;
+            runner.run(std::format("thread_pool throughput, {} producers", producers), tasks, 0, [] -> void {}, [&] -> uint64_t {
+                std::latch start_latch(static_cast<std::ptrdiff_t>(producers) + 1);
+                std::latch completion_latch(static_cast<std::ptrdiff_t>(tasks));
+                std::unique_ptr<std::jthread[]> threads = std::make_unique<std::jthread[]>(producers);
+                for(size_t p = 0; p < producers; ++p){
+                    threads[p] = std::jthread([&] -> void {
+                        start_latch.arrive_and_wait();
+                        for(size_t i = 0; i < POOL_BENCH_TASKS_PER_PRODUCER; ++i){
+                            pool.enqueue([&completion_latch] -> void { completion_latch.count_down(); });
+                        }
+                    });
+                }
+
+                const uint64_t start_ns = gc_pause_report::clock_ns();
+                start_latch.arrive_and_wait();
+                completion_latch.wait();
+                const uint64_t duration_ns = gc_pause_report::clock_ns() - start_ns;
+                for(size_t p = 0; p < producers; ++p){
+                    threads[p].join();
+                }
+                return duration_ns;
+            });
+        }
+    }
+
+};
+
+int main(int argc, char** argv) {
+    std::string results_path;
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg == "--results-json" && i + 1 < argc){
+            results_path = argv[++i];
+        }
+        else {
+            std::cerr << std::format("Usage: {} [--results-json <path>]\n", argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    const size_t pool_thread_count = std::max(2u, std::thread::hardware_concurrency());
+
+    benchmark_runner runner;
+    results_document results("gcsim-container-bench");
+    results.set_config(std::format("pool-threads={}\nwarmup-runs={}\nrepetitions={}\n", pool_thread_count, DEFAULT_WARMUP_RUNS, DEFAULT_REPETITIONS));
+    if(!results_path.empty()) runner.set_results(&results);
+    container_benchmark benchmark(runner, pool_thread_count);
+
+    benchmark.hash_maps();
+    benchmark.queues();
+    benchmark.indexed_stacks();
+    benchmark.thread_pools();
+
+    if(!results_path.empty()){
+        if(!results.write(results_path)){
+            std::cerr << std::format("Failed to write results to {}\n", results_path);
+            return 1;
+        }
+        std::cout << std::format("Results written to {}\n", results_path);
+    }
+
+    return 0;
+}
\ No newline at end of file
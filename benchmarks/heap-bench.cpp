@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "benchmark-runner/benchmark-runner.hpp"
+#include "../src/heap-manager/heap-manager.hpp"
+#include "../src/heap-manager/heap-bench-access.hpp"
+#include "../src/root-set-table/global-root.hpp"
+
+/// maximum number of allocations timed by a repetition of the allocate benchmark.
+constexpr size_t ALLOCATE_BENCH_OPS = 4096;
+
+/// object sizes of the allocate benchmark, one per object size category.
+constexpr uint32_t ALLOCATE_BENCH_SIZES[] = {64, 1024, 64 * 1024};
+
+/// percent of the blocks that stay live, live blocks are spread evenly between the free ones.
+constexpr size_t OCCUPANCY_LEVELS[] = {0, 10, 50, 90};
+
+/// size of the objects that fill the segment of the sweep and coalesce benchmarks.
+constexpr uint32_t SEGMENT_BENCH_OBJECT_SIZE = 64;
+
+/// numbers of roots of the mark benchmark.
+constexpr size_t MARK_BENCH_ROOT_COUNTS[] = {100, 1'000, 10'000};
+
+/// numbers of threads that search for a segment at the same time.
+constexpr size_t FIND_SEGMENT_BENCH_THREADS[] = {1, 2, 4, 8};
+
+/// number of segment searches of each thread.
+constexpr size_t FIND_SEGMENT_BENCH_OPS = 20'000;
+
+/**
+ * @class heap_benchmark
+ * @brief microbenchmarks of the heap hot paths, each measured in isolation on a prepared heap.
+ * @details periodic gc is deferred before every timed run, timed runs are much shorter than the minimum gc interval.
+*/
+class heap_benchmark {
+private:
+    /// heap that is benchmarked.
+    heap_manager heap_mng;
+
+    /// runner that times the benchmarks.
+    benchmark_runner& runner;
+
+    /**
+     * @brief moves the time of the last gc to now, so neither periodic nor allocation triggered gc runs for MIN_GC_INTERVAL.
+    */
+    void defer_gc() noexcept {
+        heap_bench_access::defer_gc(heap_mng);
+    }
+
+    /**
+     * @brief fills the segments of the category with objects, then frees the objects that don't stay live.
+     * @param category - object size category of the segments.
+     * @param bytes - size of the objects, aligned to 16 bytes.
+     * @param occupancy - percent of the objects that stay live.
+     * @details freed objects are swept and coalesced, so free space is split into holes between the live objects.
+    */
+    void prepare_category(segment_category category, uint32_t bytes, size_t occupancy) {
+        std::lock_guard<profiled_mutex> root_set_lock(heap_bench_access::root_set_mutex(heap_mng));
+        std::unique_lock<profiled_mutex> locks[TOTAL_SEGMENTS];
+        for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+            locks[i] = std::unique_lock<profiled_mutex>(heap_bench_access::segment_lock(heap_mng, i));
+        }
+
+        for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+            heap_bench_access::reset_segment(heap_mng, i);
+            if(heap_bench_access::get_segment_category(heap_mng, i) != category) continue;
+
+            while(heap_bench_access::allocate_from_segment(heap_mng, i, bytes));
+            keep_live(i, occupancy);
+            heap_bench_access::sweep_segment(heap_mng, i);
+            heap_bench_access::coalesce_segment(heap_mng, i);
+        }
+        defer_gc();
+    }
+
+    /**
+     * @brief marks the allocated blocks of the segment that stay live.
+     * @param segment_index - index of the segment.
+     * @param occupancy - percent of the allocated blocks that are marked.
+     * @warning segment must be locked.
+    */
+    void keep_live(size_t segment_index, size_t occupancy) {
+        segment& seg = heap_bench_access::get_segment(heap_mng, segment_index);
+        uint8_t* ptr = seg.segment_memory;
+        const uint8_t* end_ptr = seg.segment_memory + SEGMENT_SIZE;
+
+        for(size_t block = 0; ptr + sizeof(header) <= end_ptr; ++block){
+            header* hdr = reinterpret_cast<header*>(ptr);
+            if(!hdr->is_free() && (block + 1) * occupancy / 100 > block * occupancy / 100){
+                hdr->set_marked(true);
+            }
+            ptr += sizeof(header) + static_cast<size_t>(hdr->size);
+        }
+    }
+
+    /**
+     * @brief calculates how many objects can be allocated without running out of free space.
+     * @param category - object size category of the segments.
+     * @param bytes - size of the objects.
+     * @param occupancy - percent of the category occupied by live objects.
+     * @returns number of allocations of a timed run.
+    */
+    size_t allocation_ops(segment_category category, uint32_t bytes, size_t occupancy) const noexcept {
+        const size_t blocks = heap_bench_access::get_category_segment_count(heap_mng, category) * (SEGMENT_SIZE / (bytes + sizeof(header)));
+        return std::clamp<size_t>(blocks * (100 - occupancy) / 100 / 2, 1, ALLOCATE_BENCH_OPS);
+    }
+
+public:
+    /**
+     * @brief creates the heap for the benchmarks.
+     * @param runner - reference to the runner that times the benchmarks.
+     * @param gc_thread_count - number of gc threads of the heap.
+    */
+    heap_benchmark(benchmark_runner& runner, size_t gc_thread_count) : heap_mng(1, gc_thread_count), runner(runner) {}
+
+    /**
+     * @brief measures allocate of each size category at each occupancy level.
+    */
+    void allocate() {
+        runner.print_section("allocate");
+        for(uint32_t bytes : ALLOCATE_BENCH_SIZES){
+            const segment_category category = heap_bench_access::get_object_category(bytes);
+            for(size_t occupancy : OCCUPANCY_LEVELS){
+                const size_t ops = allocation_ops(category, bytes, occupancy);
+                runner.run(std::format("allocate {}B, {}% occupied", bytes, occupancy), ops, ops * bytes,
+                    [&] -> void { prepare_category(category, bytes, occupancy); },
+                    [&] -> void {
+                        for(size_t i = 0; i < ops; ++i){
+                            benchmark_runner::do_not_optimize(heap_mng.allocate(bytes));
+                        }
+                    }
+                );
+            }
+        }
+    }
+
+    /**
+     * @brief measures sweep_segment throughput at each occupancy level.
+    */
+    void sweep_segment() {
+        runner.print_section("sweep_segment");
+        const size_t segment_index = 0;
+        for(size_t occupancy : OCCUPANCY_LEVELS){
+            runner.run(std::format("sweep {}B objects, {}% live", SEGMENT_BENCH_OBJECT_SIZE, occupancy), 1, SEGMENT_SIZE,
+                [&] -> void {
+                    prepare_category(heap_bench_access::get_segment_category(heap_mng, segment_index), SEGMENT_BENCH_OBJECT_SIZE, 100);
+                    std::lock_guard<profiled_mutex> segment_lock(heap_bench_access::segment_lock(heap_mng, segment_index));
+                    keep_live(segment_index, occupancy);
+                },
+                [&] -> void {
+                    std::lock_guard<profiled_mutex> segment_lock(heap_bench_access::segment_lock(heap_mng, segment_index));
+                    benchmark_runner::do_not_optimize(heap_bench_access::sweep_segment(heap_mng, segment_index));
+                }
+            );
+        }
+    }
+
+    /**
+     * @brief measures coalesce_segment throughput at each occupancy level.
+    */
+    void coalesce_segment() {
+        runner.print_section("coalesce_segment");
+        const size_t segment_index = 0;
+        for(size_t occupancy : OCCUPANCY_LEVELS){
+            runner.run(std::format("coalesce {}B objects, {}% live", SEGMENT_BENCH_OBJECT_SIZE, occupancy), 1, SEGMENT_SIZE,
+                [&] -> void {
+                    prepare_category(heap_bench_access::get_segment_category(heap_mng, segment_index), SEGMENT_BENCH_OBJECT_SIZE, 100);
+                    std::lock_guard<profiled_mutex> segment_lock(heap_bench_access::segment_lock(heap_mng, segment_index));
+                    keep_live(segment_index, occupancy);
+                    heap_bench_access::sweep_segment(heap_mng, segment_index);
+                },
+                [&] -> void {
+                    std::lock_guard<profiled_mutex> segment_lock(heap_bench_access::segment_lock(heap_mng, segment_index));
+                    heap_bench_access::coalesce_segment(heap_mng, segment_index);
+                }
+            );
+        }
+    }
+
+    /**
+     * @brief measures the mark phase of the gc for each number of roots.
+     * @details each root is a global root that references one object, mark duration is taken from the pause of the cycle.
+    */
+    void mark() {
+        runner.print_section(std::format("mark ({} gc threads)", heap_mng.get_gc_thread_count()));
+        for(size_t root_count : MARK_BENCH_ROOT_COUNTS){
+            runner.run(std::format("mark {} global roots", root_count), root_count, 0,
+                [&] -> void {
+                    heap_mng.reset();
+                    for(size_t i = 0; i < root_count; ++i){
+                        heap_mng.add_root("g" + std::to_string(i), std::make_unique<global_root>(heap_mng.allocate(SEGMENT_BENCH_OBJECT_SIZE)));
+                    }
+                },
+                [&] -> uint64_t {
+                    const uint64_t since_ns = gc_pause_report::clock_ns();
+                    heap_mng.collect_garbage();
+                    const indexed_stack<gc_pause> pauses = heap_mng.get_gc_pauses(since_ns);
+                    return pauses.empty() ? 0 : pauses[0].mark_ns;
+                }
+            );
+        }
+        heap_mng.reset();
+    }
+
+    /**
+     * @brief measures find_suitable_segment while several threads search for a segment at the same time.
+     * @details ns/op is the wall time of a run divided by the searches of all threads.
+    */
+    void find_suitable_segment() {
+        runner.print_section("find_suitable_segment");
+        for(size_t thread_count : FIND_SEGMENT_BENCH_THREADS){
+            runner.run(std::format("find segment, {} threads", thread_count), thread_count * FIND_SEGMENT_BENCH_OPS, 0,
+                [&] -> void { prepare_category(segment_category::small, SEGMENT_BENCH_OBJECT_SIZE, 50); },
+                [&] -> uint64_t {
+                    std::latch start_latch(static_cast<std::ptrdiff_t>(thread_count) + 1);
+                    std::unique_ptr<std::jthread[]> threads = std::make_unique<std::jthread[]>(thread_count);
+                    for(size_t t = 0; t < thread_count; ++t){
+                        threads[t] = std::jthread([&] -> void {
+                            start_latch.arrive_and_wait();
+                            for(size_t i = 0; i < FIND_SEGMENT_BENCH_OPS; ++i){
+                                benchmark_runner::do_not_optimize(heap_bench_access::find_suitable_segment(heap_mng, SEGMENT_BENCH_OBJECT_SIZE));
+                            }
+                        });
+                    }
+
+                    const uint64_t start_ns = gc_pause_report::clock_ns();
+                    start_latch.arrive_and_wait();
+                    for(size_t t = 0; t < thread_count; ++t){
+                        threads[t].join();
+                    }
+                    return gc_pause_report::clock_ns() - start_ns;
+                }
+            );
+        }
+    }
+
+};
+
+int main(int argc, char** argv) {
+    std::string results_path;
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg == "--results-json" && i + 1 < argc){
+            results_path = argv[++i];
+        }
+        else {
+            std::cerr << std::format("Usage: {} [--results-json <path>]\n", argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    const size_t gc_thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    benchmark_runner runner;
+    results_document results("gcsim-heap-bench");
+    results.set_config(std::format("gc-threads={}\nwarmup-runs={}\nrepetitions={}\n", gc_thread_count, DEFAULT_WARMUP_RUNS, DEFAULT_REPETITIONS));
+    if(!results_path.empty()) runner.set_results(&results);
+    heap_benchmark benchmark(runner, gc_thread_count);
+
+    benchmark.allocate();
+    benchmark.sweep_segment();
+    benchmark.coalesce_segment();
+    benchmark.find_suitable_segment();
+    benchmark.mark();
+
+    if(!results_path.empty()){
+        if(!results.write(results_path)){
+            std::cerr << std::format("Failed to write results to {}\n", results_path);
+            return 1;
+        }
+        std::cout << std::format("Results written to {}\n", results_path);
+    }
+
+    return 0;
+}
\ No newline at end of file
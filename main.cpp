@@ -1,26 +1,245 @@
+#include <algorithm>
 #include <iostream>
+#include <memory>
 
 #include "src/allocators/allocators.hpp"
 #include "src/heap-manager/heap-manager.hpp"
+#include "src/workload-config/workload-config.hpp"
+#include "src/alloc-trace/alloc-trace.hpp"
+#include "src/trace-replayer/trace-replayer.hpp"
+#include "src/request-server/request-server.hpp"
+#include "src/scalability-harness/scalability-harness.hpp"
+#include "src/common/results-document/results-document.hpp"
+#include "src/malloc-baseline/malloc-baseline.hpp"
 
-int main() {
-    constexpr size_t hm_thread_count = 8;
-    constexpr size_t gc_thread_count = 8;
-    heap_manager heap_mng(hm_thread_count, gc_thread_count);
+int main(int argc, char** argv) {
+    workload_config config;
+    try {
+        config = workload_config::parse(argc, argv);
+    }
+    catch(const std::invalid_argument& e){
+        std::cerr << std::format("{}\n{}", e.what(), workload_config::usage(argv[0]));
+        return 1;
+    }
+
+    if(config.help){
+        std::cout << workload_config::usage(argv[0]);
+        return 0;
+    }
+    std::cout << std::format("Workload configuration:\n{}\n", config.describe());
+
+    // the document reads the git revision when it is created, so it only exists if results are written
+    std::unique_ptr<results_document> results = config.results_json.empty() ? nullptr : std::make_unique<results_document>("gcsim");
+    results_document* recorded_results = results.get();
+    if(recorded_results != nullptr) recorded_results->set_config(config.describe());
+    auto write_results = [&config, recorded_results] -> void {
+        if(recorded_results == nullptr) return;
+        if(recorded_results->write(config.results_json)){
+            std::cout << std::format("Results written to {} ({} metrics)\n", config.results_json, recorded_results->get_metrics().get_size());
+        }
+        else {
+            std::cerr << std::format("Failed to write results to {}\n", config.results_json);
+        }
+    };
+
+    // every run ends here, so the reports and the trace cover the malloc and scalability runs as well
+    auto finish = [&write_results](int exit_code) -> int {
+        if(exit_code == 0) write_results();
 
-    size_t alloc_thread_counts[] = {1, 2, 5, 10};
-    const size_t len = sizeof(alloc_thread_counts) / sizeof(size_t);
+        if constexpr (LOCK_PROFILING_ENABLED){
+            allocators::print_lock_contention();
+        }
 
-    constexpr size_t tls_count = 5;
-    constexpr size_t global_count = 5;
-    constexpr size_t register_count = 5;
+        if constexpr (TRACING_ENABLED){
+            if(tracer::dump(TRACE_OUTPUT_PATH)){
+                std::cout << std::format("Trace written to {}\n", TRACE_OUTPUT_PATH);
+            }
+            else {
+                std::cerr << std::format("Failed to write trace to {}\n", TRACE_OUTPUT_PATH);
+            }
+        }
 
-    for(size_t i = 0; i < len; ++i){
-        std::cout << std::format("Allocators using {} threads in stress mode: \n", alloc_thread_counts[i]);
-        allocators allocator(heap_mng, alloc_thread_counts[i]);
-        allocator.simulate_alloc(tls_count, global_count, register_count, simulation_mode::stress);
-        std::cout << "\n";
+        return exit_code;
+    };
+
+    // recorded simulations repeat, so every metric has a sample per trial for the comparison tool
+    const size_t trials = recorded_results == nullptr ? 1 : config.trials;
+
+    auto record_simulation = [recorded_results](const std::string& prefix, const indexed_stack<simulation_result>& trial_results) -> void {
+        if(recorded_results == nullptr) return;
+        auto record = [recorded_results, &prefix, &trial_results](const char* name, const char* unit, metric_goal goal, auto metric) -> void {
+            indexed_stack<double> samples;
+            for(const simulation_result& result : trial_results){
+                samples.push(static_cast<double>(metric(result)));
+            }
+            recorded_results->add_metric(std::format("{}/{}", prefix, name), unit, goal, std::move(samples));
+        };
+        record("throughput", "allocs/s", metric_goal::higher, [](const simulation_result& result) -> double { return result.allocations_per_s(); });
+        record("failed allocations", "allocations", metric_goal::lower, [](const simulation_result& result) -> uint64_t { return result.failed_allocations; });
+        record("peak rss", "bytes", metric_goal::lower, [](const simulation_result& result) -> uint64_t { return result.peak_rss_bytes; });
+        if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+            record("allocation p50", "ns", metric_goal::lower, [](const simulation_result& result) -> uint64_t { return result.allocation_p50_ns; });
+            record("allocation p99", "ns", metric_goal::lower, [](const simulation_result& result) -> uint64_t { return result.allocation_p99_ns; });
+            record("allocation p99.9", "ns", metric_goal::lower, [](const simulation_result& result) -> uint64_t { return result.allocation_p999_ns; });
+        }
+    };
+
+    auto median_trial = [](const indexed_stack<simulation_result>& trial_results) -> const simulation_result& {
+        indexed_stack<size_t> order;
+        for(size_t i = 0; i < trial_results.get_size(); ++i) order.push(i);
+        std::sort(order.begin(), order.end(), [&trial_results](size_t lhs, size_t rhs) -> bool {
+            return trial_results[lhs].allocations_per_s() < trial_results[rhs].allocations_per_s();
+        });
+        return trial_results[order[order.get_size() / 2]];
+    };
+
+    auto run_baseline = [&config, trials, &record_simulation](size_t thread_count) -> indexed_stack<simulation_result> {
+        std::cout << std::format("{} using {} threads in {} mode: \n", malloc_baseline::allocator_name(), thread_count, workload_config::simulation_mode_name(config.mode));
+        malloc_baseline baseline(thread_count, config);
+        indexed_stack<simulation_result> trial_results;
+        for(size_t trial = 0; trial < trials; ++trial){
+            if(trials > 1) std::cout << std::format("Trial {}/{}:\n", trial + 1, trials);
+            trial_results.push(baseline.simulate_alloc());
+            allocators::print_baseline_result(trial_results.peek(), baseline.get_free_count());
+        }
+        record_simulation(std::format("malloc/{}/mutator threads {}", workload_config::simulation_mode_name(config.mode), thread_count), trial_results);
+        return trial_results;
+    };
+
+    if(config.backend == allocation_backend::malloc){
+        for(size_t thread_count : config.mutator_threads){
+            run_baseline(thread_count);
+            std::cout << "\n";
+        }
+        return finish(0);
     }
-    
-    return 0;
+
+    if(config.scalability){
+        scalability_harness harness(config);
+        harness.run(recorded_results);
+        std::cout << std::format("\n{}", harness.summary());
+        if(harness.write_csv(config.scalability_csv)){
+            std::cout << std::format("Scalability results written to {}\n", config.scalability_csv);
+        }
+        else {
+            std::cerr << std::format("Failed to write scalability results to {}\n", config.scalability_csv);
+        }
+        return finish(0);
+    }
+
+    {
+        heap_manager heap_mng(config.hm_threads, config.gc_threads, config.policy);
+        heap_mng.set_heap_limit(config.heap_mb << 20);
+
+        auto record_gc_pauses = [&heap_mng, recorded_results](const std::string& prefix, uint64_t start_ns) -> void {
+            if(recorded_results == nullptr) return;
+            indexed_stack<double> pauses;
+            for(const gc_pause& pause : heap_mng.get_gc_pauses(start_ns)){
+                pauses.push(static_cast<double>(pause.total_ns));
+            }
+            recorded_results->add_metric(prefix + "/gc pause", "ns", metric_goal::lower, std::move(pauses));
+        };
+        heap_mng.set_sampling_interval(config.sampling_interval);
+        heap_mng.set_census_enabled(config.census);
+
+        if(!config.replay_path.empty()){
+            trace_replayer replayer;
+            if(!replayer.load(config.replay_path)){
+                std::cerr << std::format("Failed to read allocation trace {}\n", config.replay_path);
+                return finish(1);
+            }
+
+            std::cout << std::format("Replaying {} with {} timing\n", config.replay_path, trace_replayer::replay_timing_name(config.timing));
+            const uint64_t replay_start_ns = gc_pause_report::clock_ns();
+            const replay_stats stats = replayer.replay(heap_mng, config.timing);
+            allocators::print_replay_stats(replayer, stats);
+            allocators::print_heap_stats(heap_mng.stats());
+            allocators::print_gc_pauses(gc_pause_report(heap_mng.get_gc_pauses(replay_start_ns), replay_start_ns, replay_start_ns + stats.duration_ns));
+            if(recorded_results != nullptr){
+                indexed_stack<double> duration;
+                duration.push(static_cast<double>(stats.duration_ns));
+                recorded_results->add_metric("replay/duration", "ns", metric_goal::lower, std::move(duration));
+                record_gc_pauses("replay", replay_start_ns);
+            }
+            std::cout << "\n";
+        }
+        else if(!config.request_rates.empty()){
+            for(size_t thread_count : config.mutator_threads){
+                std::cout << std::format("Serving requests with {} workers: \n", thread_count);
+                request_server server(heap_mng, thread_count, config);
+                indexed_stack<request_load_stats> loads;
+                for(uint64_t rate : config.request_rates){
+                    const request_load_stats stats = server.run_load(static_cast<double>(rate));
+                    allocators::print_request_load(stats);
+                    allocators::print_gc_pauses(gc_pause_report(heap_mng.get_gc_pauses(stats.start_ns), stats.start_ns, stats.start_ns + stats.duration_ns));
+                    if(recorded_results != nullptr){
+                        const std::string prefix = std::format("requests/workers {}/offered {}/s", thread_count, rate);
+                        const std::pair<const char*, uint64_t> latencies[] = {{"p50", stats.latency.p50}, {"p99", stats.latency.p99}, {"p99.9", stats.latency.p999}};
+                        for(const auto& [percentile, latency] : latencies){
+                            indexed_stack<double> sample;
+                            sample.push(static_cast<double>(latency));
+                            recorded_results->add_metric(std::format("{}/latency {}", prefix, percentile), "ns", metric_goal::lower, std::move(sample));
+                        }
+                        indexed_stack<double> achieved;
+                        achieved.push(stats.achieved_rate());
+                        recorded_results->add_metric(prefix + "/achieved rate", "requests/s", metric_goal::higher, std::move(achieved));
+                        record_gc_pauses(prefix, stats.start_ns);
+                    }
+                    loads.push(stats);
+                }
+                allocators::print_request_loads(loads, thread_count);
+                heap_mng.reset();
+                std::cout << "\n";
+            }
+        }
+        else {
+            if(!config.record_path.empty() && !alloc_trace::start(config.record_path)){
+                std::cerr << std::format("Failed to open allocation trace {}\n", config.record_path);
+            }
+
+            for(size_t thread_count : config.mutator_threads){
+                std::cout << std::format("Allocators using {} threads in {} mode: \n", thread_count, workload_config::simulation_mode_name(config.mode));
+                allocators allocator(heap_mng, thread_count, config);
+                indexed_stack<simulation_result> trial_results;
+                for(size_t trial = 0; trial < trials; ++trial){
+                    if(trials > 1) std::cout << std::format("Trial {}/{}:\n", trial + 1, trials);
+                    trial_results.push(allocator.simulate_alloc());
+                }
+                const std::string prefix = std::format("simulation/{}/mutator threads {}", workload_config::simulation_mode_name(config.mode), thread_count);
+                record_simulation(prefix, trial_results);
+                record_gc_pauses(prefix, trial_results[0].start_ns);
+                std::cout << "\n";
+
+                if(config.backend == allocation_backend::both){
+                    const indexed_stack<simulation_result> baseline_results = run_baseline(thread_count);
+                    allocators::print_backend_comparison(median_trial(trial_results), median_trial(baseline_results), malloc_baseline::allocator_name());
+                    std::cout << "\n";
+                }
+            }
+
+            if(alloc_trace::is_recording()){
+                if(alloc_trace::stop()){
+                    std::cout << std::format("Allocation trace written to {} ({} events, {} bytes, {} unresolved references, {} dropped events)\n",
+                        config.record_path, alloc_trace::get_event_count(), alloc_trace::get_written_bytes(), 
+                        alloc_trace::get_unresolved_refs(), alloc_trace::get_dropped_events()
+                    );
+                }
+                else {
+                    std::cerr << std::format("Failed to write allocation trace to {}\n", config.record_path);
+                }
+            }
+        }
+
+        if(config.sampling_interval != 0){
+            allocators::print_allocation_sites(heap_mng.get_allocation_sites());
+            if(heap_mng.write_allocation_profile(ALLOCATION_PROFILE_PATH)){
+                std::cout << std::format("Allocation profile written to {}\n", ALLOCATION_PROFILE_PATH);
+            }
+            else {
+                std::cerr << std::format("Failed to write allocation profile to {}\n", ALLOCATION_PROFILE_PATH);
+            }
+        }
+    }
+
+    return finish(0);
 }
@@ -0,0 +1,218 @@
+#include "alloc-trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+std::unique_ptr<alloc_trace_buffer> alloc_trace::buffers[MAX_ALLOC_TRACE_THREADS];
+
+std::atomic<size_t> alloc_trace::registered_threads{0};
+
+std::atomic<uint64_t> alloc_trace::session{0};
+
+std::atomic<bool> alloc_trace::recording{false};
+
+std::atomic<uint64_t> alloc_trace::epoch{0};
+
+std::atomic<uint64_t> alloc_trace::next_root_id{1};
+
+uint64_t alloc_trace::start_ns = 0;
+
+std::atomic<uint64_t> alloc_trace::event_count{0};
+
+std::atomic<uint64_t> alloc_trace::dropped_events{0};
+
+std::atomic<uint64_t> alloc_trace::unresolved_refs{0};
+
+uint64_t alloc_trace::written_bytes = 0;
+
+std::ofstream alloc_trace::output;
+
+std::mutex alloc_trace::output_mutex;
+
+alloc_trace_buffer::alloc_trace_buffer(uint32_t thread_id, uint64_t start_ns) noexcept 
+    : size(0), last_event_ns(start_ns), epoch(0), recent{}, allocations(0), thread_id(thread_id) {}
+
+bool alloc_trace::start(const std::string& path){
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    if(recording.load(std::memory_order_acquire)) return false;
+
+    output = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if(!output) return false;
+    output.write(ALLOC_TRACE_MAGIC, ALLOC_TRACE_MAGIC_LENGTH);
+
+    for(std::unique_ptr<alloc_trace_buffer>& buffer : buffers){
+        buffer.reset();
+    }
+    registered_threads.store(0, std::memory_order_relaxed);
+    epoch.store(0, std::memory_order_relaxed);
+    next_root_id.store(1, std::memory_order_relaxed);
+    event_count.store(0, std::memory_order_relaxed);
+    dropped_events.store(0, std::memory_order_relaxed);
+    unresolved_refs.store(0, std::memory_order_relaxed);
+    written_bytes = ALLOC_TRACE_MAGIC_LENGTH;
+    start_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+    );
+
+    session.fetch_add(1, std::memory_order_acq_rel);
+    recording.store(true, std::memory_order_release);
+    return true;
+}
+
+bool alloc_trace::stop(){
+    if(!recording.exchange(false, std::memory_order_acq_rel)) return false;
+
+    const size_t thread_count = std::min(registered_threads.load(std::memory_order_acquire), MAX_ALLOC_TRACE_THREADS);
+    for(size_t i = 0; i < thread_count; ++i){
+        if(buffers[i]) flush(*buffers[i]);
+    }
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    output.flush();
+    const bool written = output.good();
+    output.close();
+    return written;
+}
+
+uint64_t alloc_trace::get_event_count() noexcept {
+    return event_count.load(std::memory_order_relaxed);
+}
+
+uint64_t alloc_trace::get_dropped_events() noexcept {
+    return dropped_events.load(std::memory_order_relaxed);
+}
+
+uint64_t alloc_trace::get_unresolved_refs() noexcept {
+    return unresolved_refs.load(std::memory_order_relaxed);
+}
+
+uint64_t alloc_trace::get_written_bytes() noexcept {
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    return written_bytes;
+}
+
+uint64_t alloc_trace::record_root_add(root_kind kind) noexcept {
+    if(!is_recording()) return 0;
+    const uint64_t root_id = next_root_id.fetch_add(1, std::memory_order_relaxed);
+    record_root_event(alloc_trace_op::root_add, root_id, 1, static_cast<uint64_t>(kind));
+    return root_id;
+}
+
+void alloc_trace::record_reset() noexcept {
+    if(!is_recording()) return;
+    alloc_trace_buffer* buffer = begin_event(alloc_trace_op::reset);
+    const uint64_t next_epoch = epoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if(buffer) buffer->epoch = next_epoch;
+}
+
+alloc_trace_buffer* alloc_trace::current_buffer() noexcept {
+    thread_local alloc_trace_buffer* buffer = nullptr;
+    thread_local uint64_t buffer_session = 0;
+
+    const uint64_t current_session = session.load(std::memory_order_acquire);
+    if(buffer_session != current_session){
+        buffer_session = current_session;
+        buffer = nullptr;
+        const size_t slot = registered_threads.fetch_add(1, std::memory_order_acq_rel);
+        if(slot < MAX_ALLOC_TRACE_THREADS){
+            try {
+                buffers[slot] = std::make_unique<alloc_trace_buffer>(static_cast<uint32_t>(slot + 1), start_ns);
+                buffer = buffers[slot].get();
+            }
+            catch(...) {
+                buffer = nullptr;
+            }
+        }
+    }
+    return buffer;
+}
+
+void alloc_trace::flush(alloc_trace_buffer& buffer) noexcept {
+    if(buffer.size == 0) return;
+
+    uint8_t chunk_head[20];
+    size_t head_length = write_varint(chunk_head, buffer.thread_id);
+    head_length += write_varint(chunk_head + head_length, buffer.size);
+
+    std::lock_guard<std::mutex> output_lock(output_mutex);
+    output.write(reinterpret_cast<const char*>(chunk_head), static_cast<std::streamsize>(head_length));
+    output.write(reinterpret_cast<const char*>(buffer.data), static_cast<std::streamsize>(buffer.size));
+    written_bytes += head_length + buffer.size;
+    buffer.size = 0;
+}
+
+alloc_trace_buffer* alloc_trace::begin_event(alloc_trace_op op) noexcept {
+    alloc_trace_buffer* buffer = current_buffer();
+    if(!buffer){
+        dropped_events.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if(buffer->size + 2 * ALLOC_TRACE_MAX_EVENT_SIZE > ALLOC_TRACE_BUFFER_SIZE){
+        flush(*buffer);
+    }
+
+    const uint64_t now_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+    );
+    const uint64_t current_epoch = epoch.load(std::memory_order_acquire);
+    if(buffer->epoch != current_epoch){
+        put_event_head(*buffer, alloc_trace_op::epoch, now_ns);
+        buffer->size += write_varint(buffer->data + buffer->size, current_epoch);
+        buffer->epoch = current_epoch;
+        event_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    put_event_head(*buffer, op, now_ns);
+    event_count.fetch_add(1, std::memory_order_relaxed);
+    return buffer;
+}
+
+void alloc_trace::put_event_head(alloc_trace_buffer& buffer, alloc_trace_op op, uint64_t now_ns) noexcept {
+    buffer.data[buffer.size++] = static_cast<uint8_t>(op);
+    buffer.size += write_varint(buffer.data + buffer.size, now_ns > buffer.last_event_ns ? now_ns - buffer.last_event_ns : 0);
+    buffer.last_event_ns = std::max(buffer.last_event_ns, now_ns);
+}
+
+uint64_t alloc_trace::object_ref(const alloc_trace_buffer& buffer, const header* obj) noexcept {
+    if(!obj) return 0;
+
+    const uint64_t candidates = std::min<uint64_t>(buffer.allocations, ALLOC_TRACE_RECENT_OBJECTS);
+    for(uint64_t distance = 0; distance < candidates; ++distance){
+        if(buffer.recent[(buffer.allocations - 1 - distance) % ALLOC_TRACE_RECENT_OBJECTS] == obj){
+            return distance + 1;
+        }
+    }
+    unresolved_refs.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+}
+
+void alloc_trace::record_allocation_event(alloc_trace_op op, uint64_t root_id, header* obj, uint32_t bytes) noexcept {
+    alloc_trace_buffer* buffer = begin_event(op);
+    if(!buffer) return;
+
+    if(op == alloc_trace_op::alloc_in_scope){
+        buffer->size += write_varint(buffer->data + buffer->size, root_id);
+    }
+    buffer->size += write_varint(buffer->data + buffer->size, bytes);
+    buffer->recent[buffer->allocations % ALLOC_TRACE_RECENT_OBJECTS] = obj;
+    ++buffer->allocations;
+}
+
+void alloc_trace::record_root_event(alloc_trace_op op, uint64_t root_id, size_t operand_count, uint64_t first, uint64_t second) noexcept {
+    alloc_trace_buffer* buffer = begin_event(op);
+    if(!buffer) return;
+
+    buffer->size += write_varint(buffer->data + buffer->size, root_id);
+    if(operand_count > 0) buffer->size += write_varint(buffer->data + buffer->size, first);
+    if(operand_count > 1) buffer->size += write_varint(buffer->data + buffer->size, second);
+}
+
+void alloc_trace::record_object_event(alloc_trace_op op, uint64_t root_id, uint64_t slot, bool has_slot, const header* obj) noexcept {
+    alloc_trace_buffer* buffer = begin_event(op);
+    if(!buffer) return;
+
+    buffer->size += write_varint(buffer->data + buffer->size, root_id);
+    if(has_slot) buffer->size += write_varint(buffer->data + buffer->size, slot);
+    buffer->size += write_varint(buffer->data + buffer->size, object_ref(*buffer, obj));
+}
\ No newline at end of file
@@ -0,0 +1,434 @@
+#ifndef ALLOC_TRACE_HPP
+#define ALLOC_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "../common/header/header.hpp"
+#include "../common/stats/live-census.hpp"
+
+/// magic bytes at the start of an allocation trace file.
+constexpr char ALLOC_TRACE_MAGIC[] = "GCSIMAT1";
+
+/// length of the magic bytes, without the terminator.
+constexpr size_t ALLOC_TRACE_MAGIC_LENGTH = sizeof(ALLOC_TRACE_MAGIC) - 1;
+
+/// size of the per-thread buffer, full buffer is flushed to the file as one chunk.
+constexpr size_t ALLOC_TRACE_BUFFER_SIZE = 64 * 1024;
+
+/// maximum encoded size of a single event: opcode followed by up to four varints.
+constexpr size_t ALLOC_TRACE_MAX_EVENT_SIZE = 1 + 4 * 10;
+
+/// maximum number of recorded threads, events of later threads are dropped.
+constexpr size_t MAX_ALLOC_TRACE_THREADS = 256;
+
+/// number of the most recent allocations of a thread that root operations can reference.
+constexpr size_t ALLOC_TRACE_RECENT_OBJECTS = 64;
+
+/**
+ * @enum alloc_trace_op
+ * @brief opcode of a trace event.
+ * @details every event is the opcode, the varint nanoseconds since the previous event of the thread and the operands:
+ * epoch - epoch; the thread's following events happen after the epoch-th heap reset.
+ * alloc - size; allocation through heap_manager::allocate.
+ * alloc_in_scope - root, size; allocation served by the scope region of the tls.
+ * root_add - root, kind; root was added to the root-set table.
+ * root_remove - root; root was removed from the root-set table.
+ * root_set - root, object; global or register variable was set.
+ * root_clear - root, slot; global or register variable was cleared, or tls variable at slot lost its reference.
+ * tls_init - root, slot, object; tls variable was initialized at slot of its stack.
+ * tls_assign - root, slot, object; tls variable at slot was reassigned.
+ * scope_push - root, region; tls entered a scope, region is 1 for a region scope.
+ * scope_pop - root; tls exited a scope, leaving its objects to the gc.
+ * region_release - root; tls exited a region scope, freeing its objects at once.
+ * reset - heap was reset, roots are gone and the epoch advances.
+ * Objects are encoded as 0 for nullptr, otherwise 1 + number of newer allocations of the same thread.
+*/
+enum class alloc_trace_op : uint8_t {
+    epoch,
+    alloc,
+    alloc_in_scope,
+    root_add,
+    root_remove,
+    root_set,
+    root_clear,
+    tls_init,
+    tls_assign,
+    scope_push,
+    scope_pop,
+    region_release,
+    reset
+};
+
+/// number of trace opcodes.
+constexpr size_t ALLOC_TRACE_OP_COUNT = static_cast<size_t>(alloc_trace_op::reset) + 1;
+
+/**
+ * @class alloc_trace_buffer
+ * @brief encoded events of a single thread.
+ * @details only the owning thread writes into the buffer.
+*/
+class alloc_trace_buffer {
+private:
+    /// encoded events that were not flushed yet.
+    uint8_t data[ALLOC_TRACE_BUFFER_SIZE];
+
+    /// number of used bytes of data.
+    size_t size;
+
+    /// time of the previous event on the steady clock, in nanoseconds.
+    uint64_t last_event_ns;
+
+    /// epoch of the previous event.
+    uint64_t epoch;
+
+    /// most recent allocations, indexed by allocation count modulo ALLOC_TRACE_RECENT_OBJECTS.
+    header* recent[ALLOC_TRACE_RECENT_OBJECTS];
+
+    /// number of allocations of the thread.
+    uint64_t allocations;
+
+    /// id of the thread in the trace.
+    uint32_t thread_id;
+
+    /// allowing recorder to encode the events.
+    friend class alloc_trace;
+
+public:
+    /**
+     * @brief creates an empty buffer.
+     * @param thread_id - id of the owning thread in the trace.
+     * @param start_ns - start of the recording on the steady clock.
+     * @details epoch starts at 0, so the first event of a thread created after a reset is prefixed with the epoch.
+    */
+    alloc_trace_buffer(uint32_t thread_id, uint64_t start_ns) noexcept;
+
+    /**
+     * @brief deletes the buffer.
+    */
+    ~alloc_trace_buffer() = default;
+
+    /// deleted copy constructor.
+    alloc_trace_buffer(const alloc_trace_buffer&) = delete;
+
+    /// deleted assignment operator.
+    alloc_trace_buffer& operator=(const alloc_trace_buffer&) = delete;
+
+};
+
+/**
+ * @class alloc_trace
+ * @brief records the allocations, root operations and scope changes of the mutators into a compact binary trace.
+ * @details every thread encodes its events into its own buffer, a full buffer is appended to the file as a chunk:
+ * varint thread id, varint length, events. The file starts with ALLOC_TRACE_MAGIC.
+ * Recording is off unless started, every hook is a single relaxed load then.
+*/
+class alloc_trace {
+private:
+    /// buffers of the recorded threads, indexed by registration order.
+    static std::unique_ptr<alloc_trace_buffer> buffers[MAX_ALLOC_TRACE_THREADS];
+
+    /// number of threads registered since the recording started.
+    static std::atomic<size_t> registered_threads;
+
+    /// id of the recording, buffers of earlier recordings are re-registered.
+    static std::atomic<uint64_t> session;
+
+    /// whether events are recorded.
+    static std::atomic<bool> recording;
+
+    /// number of heap resets since the recording started.
+    static std::atomic<uint64_t> epoch;
+
+    /// id of the next added root, 0 marks roots that aren't recorded.
+    static std::atomic<uint64_t> next_root_id;
+
+    /// start of the recording on the steady clock, in nanoseconds.
+    static uint64_t start_ns;
+
+    /// number of recorded events.
+    static std::atomic<uint64_t> event_count;
+
+    /// number of events dropped because MAX_ALLOC_TRACE_THREADS threads were already recorded.
+    static std::atomic<uint64_t> dropped_events;
+
+    /// number of references to objects older than ALLOC_TRACE_RECENT_OBJECTS allocations, recorded as nullptr.
+    static std::atomic<uint64_t> unresolved_refs;
+
+    /// number of bytes written to the file.
+    static uint64_t written_bytes;
+
+    /// trace file.
+    static std::ofstream output;
+
+    /// serializes writes into the file.
+    static std::mutex output_mutex;
+
+    /**
+     * @brief getter for the buffer of the calling thread.
+     * @returns pointer to the buffer, nullptr if MAX_ALLOC_TRACE_THREADS threads are already recorded.
+     * @details buffer is created on the first event of the thread in the current recording.
+    */
+    static alloc_trace_buffer* current_buffer() noexcept;
+
+    /**
+     * @brief appends the buffered events to the file as a chunk and empties the buffer.
+     * @param buffer - reference to the buffer.
+    */
+    static void flush(alloc_trace_buffer& buffer) noexcept;
+
+    /**
+     * @brief starts the event, flushing the buffer if it can't hold it and prefixing the epoch if it changed.
+     * @param op - opcode of the event.
+     * @returns pointer to the buffer the operands are encoded into, nullptr if event is dropped.
+    */
+    static alloc_trace_buffer* begin_event(alloc_trace_op op) noexcept;
+
+    /**
+     * @brief encodes the opcode and the time since the previous event of the thread.
+     * @param buffer - reference to the buffer.
+     * @param op - opcode of the event.
+     * @param now_ns - time of the event on the steady clock.
+    */
+    static void put_event_head(alloc_trace_buffer& buffer, alloc_trace_op op, uint64_t now_ns) noexcept;
+
+    /**
+     * @brief encodes the reference to an object as the distance to the newest allocation of the thread.
+     * @param buffer - reference to the buffer of the thread.
+     * @param obj - pointer to the referenced object.
+     * @returns 0 for nullptr or unresolved object, 1 + number of newer allocations otherwise.
+    */
+    static uint64_t object_ref(const alloc_trace_buffer& buffer, const header* obj) noexcept;
+
+    /**
+     * @brief records the allocation.
+     * @param op - alloc or alloc_in_scope.
+     * @param root_id - id of the tls for alloc_in_scope, ignored otherwise.
+     * @param obj - pointer to the allocated object, nullptr if allocation failed.
+     * @param bytes - size of the allocation, aligned to 16 bytes.
+    */
+    static void record_allocation_event(alloc_trace_op op, uint64_t root_id, header* obj, uint32_t bytes) noexcept;
+
+    /**
+     * @brief records the event whose operands are the root id and up to two integers.
+     * @param op - opcode of the event.
+     * @param root_id - id of the root.
+     * @param operand_count - number of used operands.
+     * @param first - first operand.
+     * @param second - second operand.
+    */
+    static void record_root_event(alloc_trace_op op, uint64_t root_id, size_t operand_count, uint64_t first = 0, uint64_t second = 0) noexcept;
+
+    /**
+     * @brief records the event whose operand is an object.
+     * @param op - opcode of the event.
+     * @param root_id - id of the root.
+     * @param slot - slot of the tls variable, ignored unless has_slot is set.
+     * @param has_slot - whether slot is encoded.
+     * @param obj - pointer to the referenced object.
+    */
+    static void record_object_event(alloc_trace_op op, uint64_t root_id, uint64_t slot, bool has_slot, const header* obj) noexcept;
+
+public:
+    /**
+     * @brief starts recording into the file, events of earlier recordings are discarded.
+     * @param path - path of the trace file.
+     * @returns true if the file was opened, false otherwise.
+    */
+    static bool start(const std::string& path);
+
+    /**
+     * @brief stops recording, flushes the buffers of all threads and closes the file.
+     * @returns true if the whole trace was written, false otherwise.
+     * @warning recorded threads must not record events during the stop.
+    */
+    static bool stop();
+
+    /**
+     * @brief checks if events are recorded.
+     * @returns true if recording, false otherwise.
+    */
+    static bool is_recording() noexcept {
+        return recording.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief getter for the number of recorded events.
+     * @returns number of events since the recording started.
+    */
+    static uint64_t get_event_count() noexcept;
+
+    /**
+     * @brief getter for the number of dropped events.
+     * @returns number of events of threads above MAX_ALLOC_TRACE_THREADS.
+    */
+    static uint64_t get_dropped_events() noexcept;
+
+    /**
+     * @brief getter for the number of unresolved object references.
+     * @returns number of references recorded as nullptr because their object was too old.
+    */
+    static uint64_t get_unresolved_refs() noexcept;
+
+    /**
+     * @brief getter for the size of the written trace.
+     * @returns number of bytes written to the file.
+    */
+    static uint64_t get_written_bytes() noexcept;
+
+    /**
+     * @brief records the allocation through heap_manager::allocate.
+     * @param obj - pointer to the allocated object, nullptr if allocation failed.
+     * @param bytes - size of the allocation, aligned to 16 bytes.
+    */
+    static void record_alloc(header* obj, uint32_t bytes) noexcept {
+        if(is_recording()) record_allocation_event(alloc_trace_op::alloc, 0, obj, bytes);
+    }
+
+    /**
+     * @brief records the allocation served by the scope region of the tls.
+     * @param root_id - id of the tls.
+     * @param obj - pointer to the allocated object.
+     * @param bytes - size of the allocation, aligned to 16 bytes.
+    */
+    static void record_alloc_in_scope(uint64_t root_id, header* obj, uint32_t bytes) noexcept {
+        if(is_recording() && root_id) record_allocation_event(alloc_trace_op::alloc_in_scope, root_id, obj, bytes);
+    }
+
+    /**
+     * @brief assigns the id to a root that is being added and records it.
+     * @param kind - kind of the root.
+     * @returns id of the root, 0 if not recording.
+    */
+    static uint64_t record_root_add(root_kind kind) noexcept;
+
+    /**
+     * @brief records the removal of the root.
+     * @param root_id - id of the root.
+    */
+    static void record_root_remove(uint64_t root_id) noexcept {
+        if(is_recording() && root_id) record_root_event(alloc_trace_op::root_remove, root_id, 0);
+    }
+
+    /**
+     * @brief records the new value of a global or register variable.
+     * @param root_id - id of the root.
+     * @param obj - pointer to the referenced object, nullptr clears the variable.
+    */
+    static void record_root_set(uint64_t root_id, const header* obj) noexcept {
+        if(!is_recording() || !root_id) return;
+        if(obj) record_object_event(alloc_trace_op::root_set, root_id, 0, false, obj);
+        else record_root_event(alloc_trace_op::root_clear, root_id, 1, 0);
+    }
+
+    /**
+     * @brief records the initialization of a tls variable.
+     * @param root_id - id of the tls.
+     * @param slot - index of the variable in the stack of the tls.
+     * @param obj - pointer to the referenced object.
+    */
+    static void record_tls_init(uint64_t root_id, uint64_t slot, const header* obj) noexcept {
+        if(is_recording() && root_id) record_object_event(alloc_trace_op::tls_init, root_id, slot, true, obj);
+    }
+
+    /**
+     * @brief records the reassignment of a tls variable.
+     * @param root_id - id of the tls.
+     * @param slot - index of the variable in the stack of the tls.
+     * @param obj - pointer to the newly referenced object, nullptr removes the reference.
+    */
+    static void record_tls_assign(uint64_t root_id, uint64_t slot, const header* obj) noexcept {
+        if(!is_recording() || !root_id) return;
+        if(obj) record_object_event(alloc_trace_op::tls_assign, root_id, slot, true, obj);
+        else record_root_event(alloc_trace_op::root_clear, root_id, 1, slot);
+    }
+
+    /**
+     * @brief records entering a scope of the tls.
+     * @param root_id - id of the tls.
+     * @param region - whether the scope allocates inside of a region.
+    */
+    static void record_scope_push(uint64_t root_id, bool region) noexcept {
+        if(is_recording() && root_id) record_root_event(alloc_trace_op::scope_push, root_id, 1, region ? 1 : 0);
+    }
+
+    /**
+     * @brief records exiting a scope of the tls.
+     * @param root_id - id of the tls.
+     * @param region_release - whether the objects of the scope's region were freed.
+    */
+    static void record_scope_pop(uint64_t root_id, bool region_release) noexcept {
+        if(is_recording() && root_id) record_root_event(region_release ? alloc_trace_op::region_release : alloc_trace_op::scope_pop, root_id, 0);
+    }
+
+    /**
+     * @brief records the reset of the heap and advances the epoch.
+     * @warning other threads must not record events during the reset.
+    */
+    static void record_reset() noexcept;
+
+    /**
+     * @brief encodes an unsigned integer as a LEB128 varint.
+     * @param out - pointer to the output, must have room for 10 bytes.
+     * @param value - encoded integer.
+     * @returns number of written bytes.
+    */
+    static size_t write_varint(uint8_t* out, uint64_t value) noexcept {
+        size_t length = 0;
+        while(value >= 0x80){
+            out[length++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[length++] = static_cast<uint8_t>(value);
+        return length;
+    }
+
+    /**
+     * @brief decodes a LEB128 varint.
+     * @param ptr - reference to the read position, advanced past the varint.
+     * @param end - end of the input.
+     * @param value - reference to the decoded integer.
+     * @returns true if a complete varint was decoded, false otherwise.
+    */
+    static bool read_varint(const uint8_t*& ptr, const uint8_t* end, uint64_t& value) noexcept {
+        value = 0;
+        for(uint32_t shift = 0; ptr < end && shift < 64; shift += 7){
+            const uint8_t byte = *ptr++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if(!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief getter for the number of operands of the opcode.
+     * @param op - opcode of the event.
+     * @returns number of varint operands after the time delta.
+    */
+    static constexpr size_t operand_count(alloc_trace_op op) noexcept {
+        switch(op){
+            case alloc_trace_op::epoch: return 1;
+            case alloc_trace_op::alloc: return 1;
+            case alloc_trace_op::alloc_in_scope: return 2;
+            case alloc_trace_op::root_add: return 2;
+            case alloc_trace_op::root_remove: return 1;
+            case alloc_trace_op::root_set: return 2;
+            case alloc_trace_op::root_clear: return 2;
+            case alloc_trace_op::tls_init: return 3;
+            case alloc_trace_op::tls_assign: return 3;
+            case alloc_trace_op::scope_push: return 2;
+            case alloc_trace_op::scope_pop: return 1;
+            case alloc_trace_op::region_release: return 1;
+            case alloc_trace_op::reset: return 0;
+        }
+        return 0;
+    }
+
+};
+
+#endif
\ No newline at end of file
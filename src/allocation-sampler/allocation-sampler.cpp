@@ -0,0 +1,122 @@
+#include "allocation-sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "../common/pprof/pprof-writer.hpp"
+
+allocation_sampler::allocation_sampler() : sites(SAMPLED_SITES_CAPACITY) {}
+
+void allocation_sampler::set_sampling_interval(uint64_t interval) noexcept {
+    sampling_interval.store(interval, std::memory_order_relaxed);
+}
+
+uint64_t allocation_sampler::get_sampling_interval() const noexcept {
+    return sampling_interval.load(std::memory_order_relaxed);
+}
+
+int64_t allocation_sampler::next_sample_distance() const {
+    thread_local std::mt19937_64 rng{std::random_device{}() + std::hash<std::thread::id>{}(std::this_thread::get_id())};
+
+    const uint64_t interval = get_sampling_interval();
+    if(interval == 0) return INT64_MAX;
+
+    std::exponential_distribution<double> distance(1.0 / static_cast<double>(interval));
+    return static_cast<int64_t>(distance(rng)) + 1;
+}
+
+void allocation_sampler::record(header* obj, uint32_t bytes, const allocation_site& site){
+    const uint64_t interval = get_sampling_interval();
+    if(!obj || interval == 0) return;
+
+    const double sample_probability = 1.0 - std::exp(-static_cast<double>(bytes) / static_cast<double>(interval));
+    const double weight = sample_probability > 0.0 ? 1.0 / sample_probability : 1.0;
+
+    std::lock_guard<profiled_mutex> lock(sampler_mutex);
+    allocation_site_stats* stats = sites.find(site.id);
+    if(!stats){
+        sites.insert(site.id, allocation_site_stats{
+            .site = site, .samples = 0, .estimated_allocations = 0, .estimated_bytes = 0, .survived_samples = 0, .estimated_survived_bytes = 0
+        });
+        stats = sites.find(site.id);
+    }
+
+    ++stats->samples;
+    stats->estimated_allocations += weight;
+    stats->estimated_bytes += weight * bytes;
+    if(obj->is_region()) return;
+    live_samples.push(allocation_sample{.obj = obj, .site_id = site.id, .size = bytes, .survived = false, .weight = weight});
+}
+
+void allocation_sampler::after_gc(){
+    std::lock_guard<profiled_mutex> lock(sampler_mutex);
+
+    size_t kept = 0;
+    for(size_t i = 0; i < live_samples.get_size(); ++i){
+        allocation_sample& sample = live_samples[i];
+        if(sample.obj->is_free()) continue;
+
+        if(!sample.survived){
+            sample.survived = true;
+            if(allocation_site_stats* stats = sites.find(sample.site_id)){
+                ++stats->survived_samples;
+                stats->estimated_survived_bytes += sample.weight * sample.size;
+            }
+        }
+        live_samples[kept++] = sample;
+    }
+
+    while(live_samples.get_size() > kept){
+        live_samples.pop();
+    }
+}
+
+void allocation_sampler::clear_live_samples(){
+    std::lock_guard<profiled_mutex> lock(sampler_mutex);
+    while(!live_samples.empty()){
+        live_samples.pop();
+    }
+}
+
+indexed_stack<allocation_site_stats> allocation_sampler::get_site_stats(){
+    indexed_stack<allocation_site_stats> stats;
+    {
+        std::lock_guard<profiled_mutex> lock(sampler_mutex);
+        auto** buckets = sites.get_buckets();
+        for(size_t i = 0; i < sites.get_capacity(); ++i){
+            for(auto* entry = buckets[i]; entry; entry = entry->next){
+                stats.push(entry->value);
+            }
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const allocation_site_stats& a, const allocation_site_stats& b) -> bool {
+        return a.estimated_bytes > b.estimated_bytes;
+    });
+    return stats;
+}
+
+bool allocation_sampler::write_pprof(const std::string& path){
+    pprof_writer profile;
+    profile.add_sample_type("alloc_objects", "count");
+    profile.add_sample_type("alloc_space", "bytes");
+    profile.add_sample_type("survived_objects", "count");
+    profile.add_sample_type("survived_space", "bytes");
+    profile.set_period("space", "bytes", static_cast<int64_t>(get_sampling_interval()));
+
+    for(const allocation_site_stats& stats : get_site_stats()){
+        const double survived_allocations = stats.estimated_allocations * stats.survival_rate();
+        const int64_t values[] = {
+            std::llround(stats.estimated_allocations),
+            std::llround(stats.estimated_bytes),
+            std::llround(survived_allocations),
+            std::llround(stats.estimated_survived_bytes)
+        };
+        profile.add_sample(stats.site.name, stats.site.file, stats.site.line, values);
+    }
+
+    return profile.write(path);
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef ALLOCATION_SAMPLER_HPP
+#define ALLOCATION_SAMPLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <string>
+
+#include "../common/header/header.hpp"
+#include "../common/allocation-site/allocation-site.hpp"
+#include "../common/hash-map/hash-map.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
+#include "../common/profiled-mutex/profiled-mutex.hpp"
+
+/// typical average number of allocated bytes between two samples, sampling stays disabled until an interval is set.
+constexpr uint64_t DEFAULT_SAMPLING_INTERVAL = 512 * 1024;
+
+/// file the pprof profile of the sampled allocation sites is written to.
+constexpr const char* ALLOCATION_PROFILE_PATH = "gcsim-alloc.pb";
+
+/// capacity of the table of the sampled allocation sites.
+constexpr size_t SAMPLED_SITES_CAPACITY = 64;
+
+/**
+ * @struct allocation_sample
+ * @brief sampled object that is still alive.
+*/
+struct allocation_sample {
+    /// header of the sampled object.
+    header* obj;
+
+    /// id of the allocation site.
+    uint64_t site_id;
+
+    /// size of the object in bytes.
+    uint32_t size;
+
+    /// whether the object survived at least one gc.
+    bool survived;
+
+    /// estimated number of allocations represented by the sample.
+    double weight;
+};
+
+/**
+ * @struct allocation_site_stats
+ * @brief sampled allocations of a single site.
+*/
+struct allocation_site_stats {
+    /// allocation site.
+    allocation_site site;
+
+    /// number of sampled allocations.
+    uint64_t samples;
+
+    /// estimated number of allocations.
+    double estimated_allocations;
+
+    /// estimated number of allocated bytes.
+    double estimated_bytes;
+
+    /// number of sampled objects that survived at least one gc.
+    uint64_t survived_samples;
+
+    /// estimated number of bytes that survived at least one gc.
+    double estimated_survived_bytes;
+
+    /**
+     * @brief calculates the fraction of sampled objects that survived a gc.
+     * @returns survival rate in range [0, 1].
+    */
+    double survival_rate() const noexcept {
+        return samples ? static_cast<double>(survived_samples) / static_cast<double>(samples) : 0.0;
+    }
+};
+
+/**
+ * @class allocation_sampler
+ * @brief poisson-sampled allocation site profiler.
+ * @details distances between samples, in allocated bytes, are exponentially distributed with the mean of the sampling interval,
+ * so each byte has the same chance of being sampled. Samples are weighted by the inverse of that chance.
+ * Sampled objects are tracked until they die, to count the objects that survived a gc.
+*/
+class allocation_sampler {
+private:
+    /// average number of allocated bytes between two samples, 0 if sampling is disabled.
+    std::atomic<uint64_t> sampling_interval{0};
+
+    /// guards the samples and the sites.
+    profiled_mutex sampler_mutex{"sampler_mutex"};
+
+    /// sampled objects that are still alive.
+    indexed_stack<allocation_sample> live_samples;
+
+    /// statistics of the sampled sites, mapped by site id.
+    hash_map<uint64_t, allocation_site_stats> sites;
+
+public:
+    /**
+     * @brief creates the sampler, sampling is disabled.
+    */
+    allocation_sampler();
+
+    /**
+     * @brief deletes the sampler.
+    */
+    ~allocation_sampler() = default;
+
+    /// deleted copy constructor.
+    allocation_sampler(const allocation_sampler&) = delete;
+
+    /// deleted assignment operator.
+    allocation_sampler& operator=(const allocation_sampler&) = delete;
+
+    /**
+     * @brief checks if sampling is enabled.
+     * @returns true if sampling interval is set, false otherwise.
+    */
+    bool is_enabled() const noexcept {
+        return sampling_interval.load(std::memory_order_relaxed) != 0;
+    }
+
+    /**
+     * @brief sets the average number of allocated bytes between two samples.
+     * @param interval - sampling interval in bytes, 0 disables sampling.
+    */
+    void set_sampling_interval(uint64_t interval) noexcept;
+
+    /**
+     * @brief getter for the sampling interval.
+     * @returns sampling interval in bytes, 0 if sampling is disabled.
+    */
+    uint64_t get_sampling_interval() const noexcept;
+
+    /**
+     * @brief draws the number of bytes until the next sample of the calling thread.
+     * @returns exponentially distributed distance in bytes.
+    */
+    int64_t next_sample_distance() const;
+
+    /**
+     * @brief records the sampled object.
+     * @param obj - pointer to the header of the object.
+     * @param bytes - size of the object.
+     * @param site - const reference to the allocation site.
+     * @details objects bump-allocated in a region are counted but not followed until the next gc,
+     * their headers don't outlive the chunk, which is freed as a single block when the region is released.
+    */
+    void record(header* obj, uint32_t bytes, const allocation_site& site);
+
+    /**
+     * @brief drops the samples of the objects freed by the sweep and counts the survivors.
+     * @warning must be called during the STW, after the sweep and before the coalescing.
+    */
+    void after_gc();
+
+    /**
+     * @brief drops all samples of the live objects.
+     * @details used when the whole heap is reset, site statistics are kept.
+    */
+    void clear_live_samples();
+
+    /**
+     * @brief takes a snapshot of the statistics of the sampled sites.
+     * @returns site statistics ranked by estimated allocated bytes.
+    */
+    indexed_stack<allocation_site_stats> get_site_stats();
+
+    /**
+     * @brief writes the site statistics as a pprof profile.
+     * @param path - path of the output file.
+     * @returns true if the profile was written, false otherwise.
+     * @details sample types are alloc_objects, alloc_space, survived_objects and survived_space.
+    */
+    bool write_pprof(const std::string& path);
+
+};
+
+#endif
\ No newline at end of file
@@ -1,55 +1,110 @@
 #include "allocators.hpp"
 
+#include <algorithm>
 #include <chrono>
+#include <cstring>
 
-allocators::allocators(heap_manager& heap_manager_ref, size_t thread_count) : heap_manager_ref(heap_manager_ref), alloc_thread_pool(thread_count) {}
+allocators::allocators(heap_manager& heap_manager_ref, size_t thread_count, const workload_config& config) 
+    : heap_manager_ref(heap_manager_ref), alloc_thread_pool(thread_count), config(config), mutator_cpu_ns(0), allocated_objects(0),
+      expired_objects(0), cache_evictions(0), cache_hits(0), touch_totals{}, report_progress(true) {}
 
 thread_local std::mt19937 allocators::rng{std::random_device{}() + std::hash<std::thread::id>{}(std::this_thread::get_id())};
 
-thread_local std::uniform_int_distribution<int> allocators::category_dist(0, 99);
+thread_local memory_touch_stats allocators::thread_touch_stats{};
 
-thread_local std::uniform_int_distribution<uint32_t> allocators::small_dist(1, SMALL_OBJECT_THRESHOLD);
+thread_local uint64_t allocators::thread_allocations = 0;
 
-thread_local std::uniform_int_distribution<uint32_t> allocators::medium_dist(SMALL_OBJECT_THRESHOLD + 1, MEDIUM_OBJECT_THRESHOLD);
-
-thread_local std::uniform_int_distribution<uint32_t> allocators::large_dist(MEDIUM_OBJECT_THRESHOLD + 1, LARGE_OBJECT_THRESHOLD);
-
-void allocators::simulate_alloc(size_t tls_count, size_t global_count, size_t register_count, simulation_mode mode){
-    std::cout << std::format("Initializing {} simulation\n", simulation_mode_name(mode));
+simulation_result allocators::simulate_alloc(bool report){
+    report_progress = report;
+    if(report){
+        std::cout << std::format("Initializing {} simulation\n", workload_config::simulation_mode_name(config.mode));
+    }
     const auto start_time = std::chrono::high_resolution_clock::now();
+    const uint64_t run_start_ns = gc_pause_report::clock_ns();
+    const uint64_t deadline_ns = config.duration_ms == 0 ? 0 : run_start_ns + config.duration_ms * 1'000'000;
 
-    std::latch completion_latch(tls_count + global_count + register_count);
-    
-    const size_t tls_scopes = tls_scope_count(mode);
-    const size_t tls_allocs = tls_allocs_per_scope(mode);
-    const size_t global_allocs = global_alloc_count(mode);
-    const size_t reg_allocs = register_alloc_count(mode);
+    // mutator contexts are shared by every thread of the heap and wrap after MAX_MUTATOR_THREADS registrations,
+    // so the run is counted by the tasks and per-thread counters are taken as the difference to the start
+    const indexed_stack<mutator_stats> mutator_stats_at_start = heap_manager_ref.get_mutator_stats();
+    const uint64_t allocations_at_start = allocated_objects.load(std::memory_order_acquire);
+    heap_manager_ref.reset_allocation_latency();
+    const perf_sample alloc_counters_at_start = alloc_counters.load();
+    const uint64_t mutator_cpu_at_start = mutator_cpu_ns.load(std::memory_order_acquire);
+    const uint64_t expired_at_start = expired_objects.load(std::memory_order_acquire);
+    const uint64_t evictions_at_start = cache_evictions.load(std::memory_order_acquire);
+    const uint64_t cache_hits_at_start = cache_hits.load(std::memory_order_acquire);
+    const memory_touch_stats touch_at_start = [this] -> memory_touch_stats {
+        std::lock_guard<std::mutex> lock(touch_mutex);
+        return touch_totals;
+    }();
+    const gc_perf_counters gc_counters_at_start = heap_manager_ref.get_gc_perf_counters();
+    uint64_t failures_at_start = 0;
+    for(const category_stats& category : heap_manager_ref.stats().categories){
+        failures_at_start += category.failures;
+    }
+    resident_memory::reset_peak();
+    const uint64_t rss_at_start = resident_memory::current_bytes();
+    std::latch completion_latch(config.tls_roots + config.global_roots + config.register_roots);
 
-    for(size_t i = 0; i < tls_count; ++i){
-        auto tls = create_root<thread_local_stack>("t" + std::to_string(i), tls_map_capacity(mode));
-        enqueue_simulation("TLS", i, [this, tls, tls_scopes, tls_allocs] -> void {
-            simulate_tls_alloc(tls, tls_scopes, tls_allocs);
-        }, completion_latch);
+    for(size_t i = 0; i < config.tls_roots; ++i){
+        auto tls = create_root<thread_local_stack>("t" + std::to_string(i), config.tls_map_capacity);
+        enqueue_simulation("TLS", i, [this, tls] -> void {
+            simulate_tls_alloc(tls);
+        }, completion_latch, deadline_ns);
     }
 
-    for(size_t i = 0; i < global_count; ++i){
+    for(size_t i = 0; i < config.global_roots; ++i){
         auto global = create_root<global_root>("g" + std::to_string(i), nullptr);
-        enqueue_simulation("Global", i, [this, global, global_allocs] -> void {
-            simulate_global_alloc(global, global_allocs);
-        }, completion_latch);
+        enqueue_simulation("Global", i, [this, global] -> void {
+            simulate_global_alloc(global);
+        }, completion_latch, deadline_ns);
     }
 
-    for(size_t i = 0; i < register_count; ++i){
+    for(size_t i = 0; i < config.register_roots; ++i){
         auto reg = create_root<register_root>("r" + std::to_string(i), nullptr);
-        enqueue_simulation("Register", i, [this, reg, reg_allocs] -> void {
-            simulate_register_alloc(reg, reg_allocs);
-        }, completion_latch);
+        enqueue_simulation("Register", i, [this, reg] -> void {
+            simulate_register_alloc(reg);
+        }, completion_latch, deadline_ns);
     }
 
     completion_latch.wait();
+    const uint64_t run_end_ns = gc_pause_report::clock_ns();
     const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start_time);
 
-    const size_t total_allocs = tls_scopes * tls_allocs * tls_count + global_allocs * global_count + reg_allocs * register_count;
+    const uint64_t total_allocs = allocated_objects.load(std::memory_order_acquire) - allocations_at_start;
+    indexed_stack<mutator_stats> run_mutator_stats;
+    for(const mutator_stats& stats : heap_manager_ref.get_mutator_stats()){
+        const mutator_stats run_stats = stats.slot < mutator_stats_at_start.get_size() ? stats.since(mutator_stats_at_start[stats.slot]) : stats;
+        if(run_stats.allocations != 0) run_mutator_stats.push(run_stats);
+    }
+
+    const uint64_t peak_rss = resident_memory::peak_bytes();
+    const latency_summary allocation_latency = LATENCY_HISTOGRAMS_ENABLED ? heap_manager_ref.get_allocation_latency().all : latency_summary{};
+    const heap_stats run_heap_stats = heap_manager_ref.stats();
+    const gc_pause_report pause_report(heap_manager_ref.get_gc_pauses(run_start_ns), run_start_ns, run_end_ns);
+    simulation_result result{
+        .allocations = total_allocs,
+        .failed_allocations = 0,
+        .duration_ns = run_end_ns - run_start_ns,
+        .start_ns = run_start_ns,
+        .allocation_p50_ns = allocation_latency.p50,
+        .allocation_p99_ns = allocation_latency.p99,
+        .allocation_p999_ns = allocation_latency.p999,
+        .gc_pause_p99_ns = pause_report.get_pause_count() == 0 ? 0 : pause_report.pause_summary().p99,
+        .gc_count = pause_report.get_pause_count(),
+        .peak_rss_bytes = peak_rss,
+        .rss_growth_bytes = peak_rss > rss_at_start ? peak_rss - rss_at_start : 0
+    };
+    for(const category_stats& category : run_heap_stats.categories){
+        result.failed_allocations += category.failures;
+    }
+    result.failed_allocations -= failures_at_start;
+
+    if(!report){
+        heap_manager_ref.reset();
+        return result;
+    }
+
     std::cout << std::format("Total allocation count: {} allocations\n", total_allocs);
     std::cout << std::format("Total execution time: {} ms ({} s)\n", duration.count(), duration.count() / 1000.0);
 
@@ -57,46 +112,509 @@ void allocators::simulate_alloc(size_t tls_count, size_t global_count, size_t re
         static_cast<double>(total_allocs) / duration.count(), 
         static_cast<double>(total_allocs) / duration.count() * 1000
     );
+    std::cout << std::format("Peak RSS: {:.2f} MB ({:+.2f} MB during the run)\n", result.peak_rss_bytes / (1024.0 * 1024.0), result.rss_growth_bytes / (1024.0 * 1024.0));
+
+    for(const mutator_stats& stats : run_mutator_stats){
+        const std::string home_hits = config.policy == allocation_policy::thread_affinity ? std::format(", home hit rate {:.2f}%", stats.home_hit_rate() * 100) : "";
+        std::cout << std::format("Mutator {}: {} allocations{}, lock contention rate {:.2f}%\n",
+            stats.slot, stats.allocations, home_hits, stats.contention_rate() * 100
+        );
+    }
+
+    if(config.lifetime != lifetime_model::scoped && config.lifetime != lifetime_model::region){
+        std::cout << std::format("Lifetime model {}: {} objects expired, {} cache evictions, {} cache hits\n",
+            workload_config::lifetime_model_name(config.lifetime), expired_objects.load(std::memory_order_acquire) - expired_at_start,
+            cache_evictions.load(std::memory_order_acquire) - evictions_at_start, cache_hits.load(std::memory_order_acquire) - cache_hits_at_start
+        );
+    }
+
+    memory_touch_stats touch{};
+    {
+        std::lock_guard<std::mutex> lock(touch_mutex);
+        touch = memory_touch_stats{
+            .initialized_objects = touch_totals.initialized_objects - touch_at_start.initialized_objects,
+            .initialized_bytes = touch_totals.initialized_bytes - touch_at_start.initialized_bytes,
+            .touched_objects = touch_totals.touched_objects - touch_at_start.touched_objects,
+            .touched_bytes = touch_totals.touched_bytes - touch_at_start.touched_bytes,
+            .touch_ns = touch_totals.touch_ns - touch_at_start.touch_ns
+        };
+    }
+    if(config.init_payload || config.touch_intensity != 0){
+        std::cout << std::format("Memory touch: {} objects initialized ({:.2f} MB), {} live objects read and updated ({:.2f} MB), {:.1f} ns per allocation\n",
+            touch.initialized_objects, touch.initialized_bytes / (1024.0 * 1024.0), touch.touched_objects, touch.touched_bytes / (1024.0 * 1024.0),
+            total_allocs == 0 ? 0.0 : static_cast<double>(touch.touch_ns) / static_cast<double>(total_allocs)
+        );
+    }
+
+    print_heap_stats(run_heap_stats);
+    print_gc_pauses(pause_report);
+    print_cpu_time(pause_report, mutator_cpu_ns.load(std::memory_order_acquire) - mutator_cpu_at_start, total_allocs + touch.touched_objects);
+    if(pause_report.get_pause_count() != 0){
+        print_live_census(heap_manager_ref.get_live_census());
+    }
+
+    const gc_perf_counters gc_counters_at_end = heap_manager_ref.get_gc_perf_counters();
+    print_perf_counters(alloc_counters.load().since(alloc_counters_at_start), total_allocs, gc_perf_counters{
+        .mark = gc_counters_at_end.mark.since(gc_counters_at_start.mark),
+        .sweep = gc_counters_at_end.sweep.since(gc_counters_at_start.sweep),
+        .marked_objects = gc_counters_at_end.marked_objects - gc_counters_at_start.marked_objects,
+        .swept_objects = gc_counters_at_end.swept_objects - gc_counters_at_start.swept_objects
+    });
+
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        print_allocation_latency(heap_manager_ref.get_allocation_latency());
+    }
 
     std::cout << "Cleaning up after simulation\n";
-    heap_manager_ref.clear_roots();
-    heap_manager_ref.collect_garbage();
+    heap_manager_ref.reset();
+    return result;
 }
 
-void allocators::simulate_tls_alloc(thread_local_stack* tls, size_t scope_count, size_t allocs_per_scope){
+void allocators::simulate_tls_alloc(thread_local_stack* tls){
     if(!tls) return;
-    for(size_t scope = 0; scope < scope_count; ++scope){
-        tls->push_scope();
-        for(size_t i = 0; i < allocs_per_scope; ++i){
-            header* obj = heap_manager_ref.allocate(generate_random_size());
-            tls->init(std::to_string(scope) + "_" + std::to_string(i), obj);
+    if(config.lifetime != lifetime_model::scoped && config.lifetime != lifetime_model::region){
+        simulate_lifetime_model(*tls);
+        return;
+    }
+
+    for(size_t scope = 0; scope < config.tls_scopes; ++scope){
+        simulate_scope(*tls, scope, 0);
+    }
+}
+
+void allocators::simulate_scope(thread_local_stack& tls, size_t scope, size_t level){
+    const bool use_scope_regions = config.lifetime == lifetime_model::region;
+    const size_t allocs_per_level = config.tls_allocs_per_scope / config.scope_depth;
+    const bool innermost = level + 1 == config.scope_depth;
+    const size_t allocs = innermost ? config.tls_allocs_per_scope - allocs_per_level * level : allocs_per_level;
+
+    if(use_scope_regions){
+        tls.push_region_scope();
+    }
+    else {
+        tls.push_scope();
+    }
+
+    for(size_t i = 0; i < allocs; ++i){
+        header* obj = use_scope_regions ? heap_manager_ref.allocate_in_scope(tls, generate_random_size()) : heap_manager_ref.allocate(generate_random_size());
+        count_allocation(obj);
+        tls.init(std::format("{}_{}_{}", scope, level, i), obj);
+        touch_memory(obj, &tls);
+    }
+    if(!innermost){
+        simulate_scope(tls, scope, level + 1);
+    }
+
+    if(use_scope_regions){
+        heap_manager_ref.pop_region_scope(tls);
+    }
+    else {
+        tls.pop_scope();
+    }
+}
+
+void allocators::simulate_lifetime_model(thread_local_stack& tls){
+    lifetime_sampler sampler(config);
+    const bool use_cache = config.lifetime == lifetime_model::lru_cache;
+    lru_cache_slots cache(use_cache ? config.cache_capacity : 0);
+    std::uniform_int_distribution<size_t> entry_dist;
+
+    // min-heap of (allocation clock at which the object dies, slot of its variable)
+    indexed_stack<std::pair<uint64_t, size_t>> deaths;
+    indexed_stack<size_t> free_slots;
+    size_t slot_count = 0;
+    bool has_scratch = false;
+    uint64_t expired = 0;
+    uint64_t evictions = 0;
+    uint64_t hits = 0;
+    auto later = [](const std::pair<uint64_t, size_t>& lhs, const std::pair<uint64_t, size_t>& rhs) -> bool {
+        return lhs.first > rhs.first;
+    };
+
+    tls.push_scope();
+    const uint64_t allocs = static_cast<uint64_t>(config.tls_scopes) * config.tls_allocs_per_scope;
+    for(uint64_t clock = 0; clock < allocs; ++clock){
+        while(!deaths.empty() && deaths[0].first <= clock){
+            const size_t slot = deaths[0].second;
+            std::pop_heap(deaths.begin(), deaths.end(), later);
+            deaths.pop();
+            tls.remove_ref(std::format("l{}", slot));
+            free_slots.push(slot);
+            ++expired;
+        }
+
+        header* obj = heap_manager_ref.allocate(generate_random_size());
+        count_allocation(obj);
+        const lifetime_sample sample = sampler.next(rng, clock);
+        if(sample.cached){
+            const bool evicting = cache.is_full();
+            const size_t entry = cache.insert();
+            if(evicting){
+                tls.reassign_ref(std::format("c{}", entry), obj);
+                ++evictions;
+            }
+            else {
+                tls.init(std::format("c{}", entry), obj);
+            }
+        }
+        else if(sample.lifetime > 0){
+            size_t slot = slot_count;
+            if(free_slots.empty()){
+                tls.init(std::format("l{}", slot_count++), obj);
+            }
+            else {
+                slot = free_slots.peek();
+                free_slots.pop();
+                tls.reassign_ref(std::format("l{}", slot), obj);
+            }
+            deaths.push(std::pair{clock + sample.lifetime, slot});
+            std::push_heap(deaths.begin(), deaths.end(), later);
+        }
+        else if(config.init_payload){
+            // short-lived object is held by a scratch variable while its payload is written
+            if(has_scratch) tls.reassign_ref("s", obj);
+            else tls.init("s", obj);
+            has_scratch = true;
+        }
+        touch_memory(obj, &tls);
+
+        if(use_cache && cache.get_size() != 0 && sampler.next_cache_hit(rng)){
+            cache.touch(entry_dist(rng, std::uniform_int_distribution<size_t>::param_type(0, cache.get_size() - 1)));
+            ++hits;
+        }
+    }
+    tls.pop_scope();
+
+    expired_objects.fetch_add(expired, std::memory_order_relaxed);
+    cache_evictions.fetch_add(evictions, std::memory_order_relaxed);
+    cache_hits.fetch_add(hits, std::memory_order_relaxed);
+}
+
+void allocators::touch_memory(header* obj, thread_local_stack* tls){
+    if(!config.init_payload && config.touch_intensity == 0) return;
+    const uint64_t start_ns = gc_pause_report::clock_ns();
+
+    if(config.init_payload && obj){
+        std::memset(obj->data_ptr(), INIT_PAYLOAD_BYTE, obj->size);
+        ++thread_touch_stats.initialized_objects;
+        thread_touch_stats.initialized_bytes += obj->size;
+    }
+
+    if(config.touch_intensity != 0 && tls){
+        const size_t variables = tls->get_variable_count();
+        for(size_t i = 0; i < config.touch_intensity && variables != 0; ++i){
+            touch_object(tls->get_ref(std::uniform_int_distribution<size_t>(0, variables - 1)(rng)));
         }
-        tls->pop_scope();
     }
+    else if(config.touch_intensity != 0){
+        // global and register roots reach only the object they hold
+        touch_object(obj);
+    }
+
+    thread_touch_stats.touch_ns += gc_pause_report::clock_ns() - start_ns;
+}
+
+void allocators::touch_object(header* obj) noexcept {
+    if(!obj) return;
+    uint8_t* data = static_cast<uint8_t*>(obj->data_ptr());
+    for(size_t offset = 0; offset + sizeof(uint64_t) <= obj->size; offset += MEMORY_TOUCH_STRIDE){
+        uint64_t word;
+        std::memcpy(&word, data + offset, sizeof(word));
+        ++word;
+        std::memcpy(data + offset, &word, sizeof(word));
+    }
+    ++thread_touch_stats.touched_objects;
+    thread_touch_stats.touched_bytes += obj->size;
+}
+
+void allocators::flush_touch_stats(){
+    std::lock_guard<std::mutex> lock(touch_mutex);
+    touch_totals.initialized_objects += thread_touch_stats.initialized_objects;
+    touch_totals.initialized_bytes += thread_touch_stats.initialized_bytes;
+    touch_totals.touched_objects += thread_touch_stats.touched_objects;
+    touch_totals.touched_bytes += thread_touch_stats.touched_bytes;
+    touch_totals.touch_ns += thread_touch_stats.touch_ns;
+    thread_touch_stats = memory_touch_stats{};
 }
 
-void allocators::simulate_global_alloc(global_root* global, size_t global_allocs){
+void allocators::simulate_global_alloc(global_root* global){
     if(!global) return;
-    for(size_t i = 0; i < global_allocs; ++i){
-        global->set_global_variable(i & 1 ? nullptr : heap_manager_ref.allocate(generate_random_size()));
+    for(size_t i = 0; i < config.global_allocs; ++i){
+        header* obj = i & 1 ? nullptr : heap_manager_ref.allocate(generate_random_size());
+        count_allocation(obj);
+        global->set_global_variable(obj);
+        if(obj) touch_memory(obj, nullptr);
     }
 }
 
-void allocators::simulate_register_alloc(register_root* reg, size_t register_allocs){
+void allocators::simulate_register_alloc(register_root* reg){
     if(!reg) return;
-    for(size_t i = 0; i < register_allocs; ++i){
-        reg->set_register_variable(i & 1 ? nullptr : heap_manager_ref.allocate(generate_random_size()));
+    for(size_t i = 0; i < config.register_allocs; ++i){
+        header* obj = i & 1 ? nullptr : heap_manager_ref.allocate(generate_random_size());
+        count_allocation(obj);
+        reg->set_register_variable(obj);
+        if(obj) touch_memory(obj, nullptr);
     }
 }
 
-uint32_t allocators::generate_random_size() {
-    int category = category_dist(rng);
+void allocators::print_heap_stats(const heap_stats& stats){
+    std::cout << "Heap statistics:\n";
+    for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+        const category_stats& category = stats.categories[c];
+        uint64_t free_block_bytes = 0;
+        uint32_t largest_free_block = 0;
+        for(const segment_stats& segment : stats.segments){
+            if(static_cast<size_t>(segment.category) != c) continue;
+            free_block_bytes += segment.fragmentation.free_block_bytes;
+            largest_free_block = std::max(largest_free_block, segment.fragmentation.largest_free_block);
+        }
+
+        std::cout << std::format("  {} objects: {} allocations, {} bytes, {} slow path entries, {} failures; after last GC {} bytes free, largest free block {} bytes\n",
+            segment_category_name(static_cast<segment_category>(c)), category.allocations, category.allocated_bytes, 
+            category.slow_path_entries, category.failures, free_block_bytes, largest_free_block
+        );
+    }
+
+    std::cout << std::format("  GC count: {}, live bytes after last GC: {}, external fragmentation after last GC: {:.2f}%\n", 
+        stats.gc_count, stats.live_bytes_after_gc, stats.external_fragmentation() * 100
+    );
+
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        const segment_stats& segment = stats.segments[i];
+        const fragmentation_stats& fragmentation = segment.fragmentation;
+        std::cout << std::format("  Segment {} ({}): {} free bytes\n", i, segment_category_name(segment.category), segment.free_bytes);
+
+        std::string histogram;
+        for(size_t size_class = 0; size_class < FREE_BLOCK_SIZE_CLASSES; ++size_class){
+            if(fragmentation.free_block_histogram[size_class] == 0) continue;
+            histogram += std::format(" {}B:{}", size_t{1} << (size_class + FREE_BLOCK_MIN_SIZE_SHIFT), fragmentation.free_block_histogram[size_class]);
+        }
+        std::cout << std::format("    after last GC: {} free blocks, largest {} bytes, external fragmentation {:.2f}%, sizes{}\n",
+            fragmentation.free_blocks, fragmentation.largest_free_block, fragmentation.external_fragmentation() * 100, histogram
+        );
+    }
+}
+
+void allocators::print_live_census(const live_census& census){
+    if(census.total.objects == 0) return;
+
+    std::cout << std::format("Live-object census after last GC: {} objects, {} bytes\n", census.total.objects, census.total.bytes);
+
+    size_t ranked[CENSUS_SIZE_CLASSES];
+    for(size_t i = 0; i < CENSUS_SIZE_CLASSES; ++i){
+        ranked[i] = i;
+    }
+    std::sort(ranked, ranked + CENSUS_SIZE_CLASSES, [&census](size_t lhs, size_t rhs) -> bool {
+        return census.size_classes[lhs].bytes > census.size_classes[rhs].bytes;
+    });
+
+    for(size_t i = 0; i < CENSUS_REPORT_ROWS && census.size_classes[ranked[i]].objects != 0; ++i){
+        const census_bucket& bucket = census.size_classes[ranked[i]];
+        std::cout << std::format("  <= {}B: {} objects, {} bytes ({:.2f}%)\n",
+            live_census::size_class_limit(ranked[i]), bucket.objects, bucket.bytes, 
+            static_cast<double>(bucket.bytes) / static_cast<double>(census.total.bytes) * 100
+        );
+    }
 
-    if (category < 80) {
-        return small_dist(rng);
-    } else if (category < 99) {
-        return medium_dist(rng);
-    } else {
-        return large_dist(rng);
+    for(size_t i = 0; i < ROOT_KIND_COUNT; ++i){
+        const census_bucket& bucket = census.root_kinds[i];
+        std::cout << std::format("  retained by {} roots: {} objects, {} bytes\n", 
+            root_kind_name(static_cast<root_kind>(i)), bucket.objects, bucket.bytes
+        );
     }
+}
+
+void allocators::print_allocation_sites(const indexed_stack<allocation_site_stats>& sites){
+    std::cout << std::format("Allocation sites ({} sampled, top {} by allocated bytes):\n", sites.get_size(), std::min(sites.get_size(), ALLOCATION_SITE_REPORT_ROWS));
+    for(size_t i = 0; i < sites.get_size() && i < ALLOCATION_SITE_REPORT_ROWS; ++i){
+        const allocation_site_stats& stats = sites[i];
+        std::cout << std::format("  {}:{} {}\n", stats.site.file, stats.site.line, stats.site.name);
+        std::cout << std::format("    {} samples, ~{:.0f} allocations, ~{:.2f} MB allocated, {:.2f}% survived a GC (~{:.2f} MB)\n",
+            stats.samples, stats.estimated_allocations, stats.estimated_bytes / (1024.0 * 1024.0), 
+            stats.survival_rate() * 100, stats.estimated_survived_bytes / (1024.0 * 1024.0)
+        );
+    }
+}
+
+void allocators::print_replay_stats(const trace_replayer& replayer, const replay_stats& stats){
+    std::cout << std::format("Replayed {} events of {} threads in {:.3f} ms\n", stats.events, stats.threads, stats.duration_ns / 1e6);
+    std::cout << std::format("  {} allocations ({} failed), {:.2f} allocs/s\n",
+        stats.allocations, stats.failed_allocations, stats.allocations_per_s()
+    );
+    std::cout << std::format("  {} root operations, {} scope operations, {} region releases, {} resets, {} errors, {} unresolved roots\n",
+        stats.root_operations, stats.scope_operations, replayer.get_op_count(alloc_trace_op::region_release), stats.resets, stats.errors, stats.unresolved_roots
+    );
+}
+
+void allocators::print_request_load(const request_load_stats& stats){
+    std::cout << std::format("Offered load {:.0f} req/s: {} requests served at {:.1f} req/s, {} allocations ({} failed)\n",
+        stats.offered_rate, stats.requests, stats.achieved_rate(), stats.allocations, stats.failed_allocations
+    );
+    auto print_summary = [](std::string_view name, const latency_summary& summary) -> void {
+        std::cout << std::format("  {} (us): p50 {:.1f}, p90 {:.1f}, p99 {:.1f}, p99.9 {:.1f}, max {:.1f}\n",
+            name, summary.p50 / 1e3, summary.p90 / 1e3, summary.p99 / 1e3, summary.p999 / 1e3, summary.max / 1e3
+        );
+    };
+    print_summary("latency", stats.latency);
+    print_summary("queueing", stats.queueing);
+}
+
+void allocators::print_request_loads(const indexed_stack<request_load_stats>& loads, size_t workers){
+    std::cout << std::format("Latency from intended arrival vs offered load ({} workers):\n", workers);
+    std::cout << std::format("  {:>12} {:>12} {:>10} {:>10} {:>10} {:>10} {:>10}\n",
+        "offered/s", "achieved/s", "p50 (us)", "p90 (us)", "p99 (us)", "p99.9 (us)", "max (us)"
+    );
+    for(const request_load_stats& stats : loads){
+        std::cout << std::format("  {:>12.0f} {:>12.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}\n",
+            stats.offered_rate, stats.achieved_rate(), stats.latency.p50 / 1e3, stats.latency.p90 / 1e3, 
+            stats.latency.p99 / 1e3, stats.latency.p999 / 1e3, stats.latency.max / 1e3
+        );
+    }
+}
+
+void allocators::print_baseline_result(const simulation_result& result, uint64_t frees){
+    std::cout << std::format("Total allocation count: {} allocations, {} frees, {} failed\n", result.allocations, frees, result.failed_allocations);
+    std::cout << std::format("Total execution time: {:.3f} ms\n", result.duration_ns / 1e6);
+    std::cout << std::format("Allocation throughput: {:.2f} allocs/s\n", result.allocations_per_s());
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        std::cout << std::format("Allocation latency: p50 {} ns, p99 {} ns, p99.9 {} ns\n", result.allocation_p50_ns, result.allocation_p99_ns, result.allocation_p999_ns);
+    }
+    std::cout << std::format("Peak RSS: {:.2f} MB ({:+.2f} MB during the run)\n", result.peak_rss_bytes / (1024.0 * 1024.0), result.rss_growth_bytes / (1024.0 * 1024.0));
+}
+
+void allocators::print_backend_comparison(const simulation_result& gc, const simulation_result& baseline, const std::string& baseline_name){
+    std::cout << std::format("GC heap vs {}:\n", baseline_name);
+    std::cout << std::format("  {:<10} {:>14} {:>10} {:>10} {:>12} {:>14} {:>16} {:>10}\n",
+        "backend", "allocs/s", "p50 (ns)", "p99 (ns)", "p99.9 (ns)", "peak RSS (MB)", "RSS growth (MB)", "failed"
+    );
+
+    auto print_row = [](const char* backend, const simulation_result& result) -> void {
+        auto latency = [](uint64_t value) -> std::string {
+            return LATENCY_HISTOGRAMS_ENABLED ? std::format("{}", value) : std::string("n/a");
+        };
+        std::cout << std::format("  {:<10} {:>14.0f} {:>10} {:>10} {:>12} {:>14.2f} {:>16.2f} {:>10}\n",
+            backend, result.allocations_per_s(), latency(result.allocation_p50_ns), latency(result.allocation_p99_ns),
+            latency(result.allocation_p999_ns), result.peak_rss_bytes / (1024.0 * 1024.0), result.rss_growth_bytes / (1024.0 * 1024.0),
+            result.failed_allocations
+        );
+    };
+    print_row("gc", gc);
+    print_row("malloc", baseline);
+
+    const double throughput_ratio = baseline.allocations_per_s() == 0 ? 0.0 : gc.allocations_per_s() / baseline.allocations_per_s();
+    std::cout << std::format("  gc heap throughput is {:.2f}x of malloc, the gc heap commits {} MB up front\n", throughput_ratio, HEAP_CAPACITY >> 20);
+}
+
+void allocators::print_lock_contention(){
+    if constexpr (!LOCK_PROFILING_ENABLED) return;
+
+    indexed_stack<lock_profile_stats> locks = profiled_mutex::snapshot();
+    std::cout << std::format("Lock contention ({} locks, top {} by wait time):\n", locks.get_size(), std::min(locks.get_size(), LOCK_REPORT_ROWS));
+    std::cout << std::format("  {:<24} {:>12} {:>10} {:>12} {:>14} {:>12} {:>14}\n",
+        "lock", "acquisitions", "contended", "wait (ms)", "max hold (us)", "try_lock", "try_lock fail"
+    );
+
+    for(size_t i = 0; i < locks.get_size() && i < LOCK_REPORT_ROWS; ++i){
+        const lock_profile_stats& lock = locks[i];
+        const std::string name = lock.index == NO_LOCK_INDEX ? std::format("{}#{}", lock.name, lock.id) : std::format("{}[{}]", lock.name, lock.index);
+        std::cout << std::format("  {:<24} {:>12} {:>9.2f}% {:>12.3f} {:>14.1f} {:>12} {:>13.2f}%\n",
+            name, lock.acquisitions, lock.contention_rate() * 100, lock.wait_ns / 1e6, lock.max_hold_ns / 1e3, 
+            lock.try_lock_attempts, lock.try_lock_failure_rate() * 100
+        );
+    }
+}
+
+void allocators::print_perf_counters(const perf_sample& allocation, uint64_t allocations, const gc_perf_counters& gc_counters){
+    if constexpr (!PERF_COUNTERS_ENABLED) return;
+
+    if(allocation.available_mask == 0 && gc_counters.mark.available_mask == 0 && gc_counters.sweep.available_mask == 0){
+        std::cout << "Hardware counters: unavailable (perf_event_open failed)\n";
+        return;
+    }
+
+    auto per_object = [](const perf_sample& sample, perf_counter counter, uint64_t objects) -> std::string {
+        if(!sample.has(counter) || objects == 0) return "n/a";
+        return std::format("{:.3f}", static_cast<double>(sample.get(counter)) / static_cast<double>(objects));
+    };
+
+    auto print_phase = [&](std::string_view phase, const perf_sample& sample, uint64_t objects) -> void {
+        std::cout << std::format("  {}: {} objects, IPC {:.2f}, per object: {} cycles, {} cache misses, {} dTLB misses, {} branch misses\n",
+            phase, objects, sample.ipc(), per_object(sample, perf_counter::cycles, objects), per_object(sample, perf_counter::cache_misses, objects),
+            per_object(sample, perf_counter::dtlb_misses, objects), per_object(sample, perf_counter::branch_misses, objects)
+        );
+    };
+
+    std::cout << "Hardware counters:\n";
+    print_phase("allocation", allocation, allocations);
+    print_phase("mark", gc_counters.mark, gc_counters.marked_objects);
+    print_phase("sweep", gc_counters.sweep, gc_counters.swept_objects);
+}
+
+void allocators::print_gc_pauses(const gc_pause_report& report){
+    const gc_pause& totals = report.get_phase_totals();
+    std::cout << std::format("GC pauses: {} cycles, {:.2f} ms paused, mutator utilization {:.2f}%\n",
+        report.get_pause_count(), totals.total_ns / 1e6, report.mutator_utilization() * 100
+    );
+
+    if(report.get_pause_count() == 0) return;
+
+    const latency_summary pauses = report.pause_summary();
+    std::cout << std::format("  pause (us): p50 {:.1f}, p90 {:.1f}, p99 {:.1f}, p99.9 {:.1f}, max {:.1f}\n",
+        pauses.p50 / 1e3, pauses.p90 / 1e3, pauses.p99 / 1e3, pauses.p999 / 1e3, pauses.max / 1e3
+    );
+    std::cout << std::format("  phases (ms): lock acquisition {:.2f}, mark {:.2f}, sweep {:.2f}, coalesce {:.2f}\n",
+        totals.lock_acquire_ns / 1e6, totals.mark_ns / 1e6, totals.sweep_ns / 1e6, totals.coalesce_ns / 1e6
+    );
+
+    std::cout << "  MMU:";
+    for(size_t i = 0; i < MMU_WINDOW_COUNT; ++i){
+        std::cout << std::format(" {}ms {:.2f}%", MMU_WINDOWS_NS[i] / 1'000'000, report.minimum_mutator_utilization(MMU_WINDOWS_NS[i]) * 100);
+    }
+    std::cout << "\n";
+}
+
+void allocators::print_cpu_time(const gc_pause_report& report, uint64_t mutator_cpu, uint64_t operations) const {
+    const gc_pause& totals = report.get_phase_totals();
+    const uint64_t gc_cpu = totals.total_cpu_ns();
+    const uint64_t charged_gc_cpu = std::min(mutator_cpu, report.get_non_periodic_collector_cpu());
+    const uint64_t mutator_only_cpu = mutator_cpu - charged_gc_cpu;
+    const size_t gc_threads = heap_manager_ref.get_gc_thread_count();
+    const size_t coalesce_threads = heap_manager_ref.get_coalesce_thread_count();
+
+    std::cout << std::format("CPU time: mutator {:.2f} ms, GC {:.2f} ms, mutator/GC ratio {}\n",
+        mutator_only_cpu / 1e6, gc_cpu / 1e6, gc_cpu == 0 ? std::string("n/a") : std::format("{:.2f}", static_cast<double>(mutator_only_cpu) / static_cast<double>(gc_cpu))
+    );
+
+    std::cout << std::format("  mutator time per operation: {} ({} allocations and object touches)\n",
+        operations == 0 ? std::string("n/a") : std::format("{:.1f} ns", static_cast<double>(mutator_only_cpu) / static_cast<double>(operations)), operations
+    );
+
+    if(report.get_pause_count() == 0) return;
+
+    std::cout << std::format("  GC CPU (ms): collector {:.2f}, mark {:.2f}, sweep {:.2f}, coalesce {:.2f}\n",
+        totals.collector_cpu_ns / 1e6, totals.mark_cpu_ns / 1e6, totals.sweep_cpu_ns / 1e6, totals.coalesce_cpu_ns / 1e6
+    );
+    std::cout << std::format("  parallel efficiency: mark {:.2f}% ({} threads), sweep {:.2f}% ({} threads), coalesce {:.2f}% ({} threads)\n",
+        gc_pause_report::parallel_efficiency(totals.mark_cpu_ns, totals.mark_ns, gc_threads) * 100, gc_threads,
+        gc_pause_report::parallel_efficiency(totals.sweep_cpu_ns, totals.sweep_ns, gc_threads) * 100, gc_threads,
+        gc_pause_report::parallel_efficiency(totals.coalesce_cpu_ns, totals.coalesce_ns, coalesce_threads) * 100, coalesce_threads
+    );
+}
+
+void allocators::print_allocation_latency(const allocation_latency_summary& latency){
+    std::cout << "Allocation latency (ns):\n";
+    auto print_path = [](std::string_view path, const latency_summary& summary) -> void {
+        std::cout << std::format("  {}: {} allocations, p50 {}, p90 {}, p99 {}, p99.9 {}, max {}\n",
+            path, summary.count, summary.p50, summary.p90, summary.p99, summary.p999, summary.max
+        );
+    };
+
+    print_path("fast path", latency.fast_path);
+    print_path("slow path", latency.slow_path);
+    print_path("gc wait", latency.gc_wait);
+    print_path("all", latency.all);
+}
+
+uint32_t allocators::generate_random_size() {
+    return config.generate_size(rng);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <memory>
 #include <string>
 #include <latch>
+#include <mutex>
 #include <random>
 #include <utility>
 #include <concepts>
@@ -15,48 +16,95 @@
 #include "../root-set-table/thread-local-stack.hpp"
 #include "../root-set-table/global-root.hpp"
 #include "../root-set-table/register-root.hpp"
+#include "../common/perf-counters/perf-counters.hpp"
+#include "../workload-config/workload-config.hpp"
+#include "../trace-replayer/trace-replayer.hpp"
+#include "../lifetime-sampler/lifetime-sampler.hpp"
+#include "../request-server/request-server.hpp"
+#include "../common/resident-memory/resident-memory.hpp"
 
-/// number of allocations per tls in stress mode.
-size_t constexpr TLS_ALLOC_STRESS_THRESHOLD = 65536;
+/// number of most contended locks printed in the lock contention report.
+size_t constexpr LOCK_REPORT_ROWS = 20;
 
-/// number of scopes per tls for stress mode.
-size_t constexpr TLS_SCOPE_COUNT_STRESS = 8;
+/// number of allocation sites printed in the allocation site report.
+size_t constexpr ALLOCATION_SITE_REPORT_ROWS = 10;
 
-/// number of allocations per scope for tls in stress mode.
-size_t constexpr TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE = TLS_ALLOC_STRESS_THRESHOLD / TLS_SCOPE_COUNT_STRESS;
+/// number of size classes printed in the live-object census report.
+size_t constexpr CENSUS_REPORT_ROWS = 10;
 
-/// capacity of the hash-map that maps tls variable to its index in stress mode.
-size_t constexpr TLS_MAP_CAPACITY_STRESS = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE << 1;
+/// distance between the words read and updated when an object is touched, one per cache line.
+size_t constexpr MEMORY_TOUCH_STRIDE = 64;
 
-/// number of allocations per tls in relaxed mode.
-size_t constexpr TLS_ALLOC_RELAXED_THRESHOLD = 1024;
+/// byte the payload of an object is initialized with.
+int constexpr INIT_PAYLOAD_BYTE = 0x5a;
 
-/// number of scopes per tls in relaxed mode.
-size_t constexpr TLS_SCOPE_COUNT_RELAXED = 8;
-
-/// number of allocations per scope for tls in relaxed mode.
-size_t constexpr TLS_ALLOC_RELAXED_THRESHOLD_PER_SCOPE = TLS_ALLOC_RELAXED_THRESHOLD / TLS_SCOPE_COUNT_RELAXED;
-
-/// capacity of the hash-map that maps tls variable to its index in relaxed mode.
-size_t constexpr TLS_MAP_CAPACITY_RELAXED = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE << 1;
+/**
+ * @struct memory_touch_stats
+ * @brief memory accesses of the mutators to the objects they allocated.
+*/
+struct memory_touch_stats {
+    /// number of objects whose payload was initialized.
+    uint64_t initialized_objects;
 
-/// number of allocations per global in stress mode.
-size_t constexpr GLOBAL_ALLOC_STRESS_THRESHOLD = 128;
+    /// number of initialized payload bytes.
+    uint64_t initialized_bytes;
 
-/// number of allocations per global in relaxed mode.
-size_t constexpr GLOBAL_ALLOC_RELAXED_THRESHOLD = 32;
+    /// number of live objects read and updated.
+    uint64_t touched_objects;
 
-/// number of allocations per register in stress mode.
-size_t constexpr REGISTER_ALLOC_STRESS_THRESHOLD = 128;
+    /// size of the read and updated objects in bytes.
+    uint64_t touched_bytes;
 
-/// number of allocations per register in relaxed mode.
-size_t constexpr REGISTER_ALLOC_RELAXED_THRESHOLD = 32;
+    /// time spent initializing and touching objects, in nanoseconds.
+    uint64_t touch_ns;
+};
 
 /**
- * @enum simulation_mode
- * @brief defines the type of the simulation.
+ * @struct simulation_result
+ * @brief headline metrics of a simulation run.
 */
-enum class simulation_mode { stress, relaxed };
+struct simulation_result {
+    /// number of successful allocations.
+    uint64_t allocations;
+
+    /// number of allocations that returned nullptr.
+    uint64_t failed_allocations;
+
+    /// wall time of the run in nanoseconds.
+    uint64_t duration_ns;
+
+    /// start of the run on the steady clock.
+    uint64_t start_ns;
+
+    /// median allocation latency in nanoseconds, 0 unless built with GCSIM_LATENCY_HISTOGRAMS.
+    uint64_t allocation_p50_ns;
+
+    /// 99th percentile of the allocation latency in nanoseconds, 0 unless built with GCSIM_LATENCY_HISTOGRAMS.
+    uint64_t allocation_p99_ns;
+
+    /// 99.9th percentile of the allocation latency in nanoseconds, 0 unless built with GCSIM_LATENCY_HISTOGRAMS.
+    uint64_t allocation_p999_ns;
+
+    /// 99th percentile of the gc pauses in nanoseconds, 0 if gc didn't run.
+    uint64_t gc_pause_p99_ns;
+
+    /// number of gc cycles during the run.
+    size_t gc_count;
+
+    /// peak resident set size of the process during the run.
+    uint64_t peak_rss_bytes;
+
+    /// growth of the resident set size from the start of the run to its peak.
+    uint64_t rss_growth_bytes;
+
+    /**
+     * @brief calculates the allocation throughput of the run.
+     * @returns allocations per second, 0 if run took no time.
+    */
+    double allocations_per_s() const noexcept {
+        return duration_ns == 0 ? 0.0 : static_cast<double>(allocations) * 1e9 / static_cast<double>(duration_ns);
+    }
+};
 
 /**
  * @class allocators
@@ -70,42 +118,104 @@ private:
     /// allocators thread pool.
     thread_pool alloc_thread_pool;
 
+    /// parameters of the simulated workload.
+    const workload_config& config;
+
+    /// hardware counters of the simulation tasks.
+    perf_phase_counters alloc_counters;
+
+    /// CPU time of the simulation tasks in nanoseconds, including gc cycles they ran.
+    std::atomic<uint64_t> mutator_cpu_ns;
+
+    /// number of successful allocations of the finished simulation tasks.
+    std::atomic<uint64_t> allocated_objects;
+
+    /// number of successful allocations of the simulation task running on the thread, not yet added to allocated_objects.
+    static thread_local uint64_t thread_allocations;
+
+    /// number of objects dropped by the lifetime models when their lifetime ended.
+    std::atomic<uint64_t> expired_objects;
+
+    /// number of cached objects evicted by the lru-cache model.
+    std::atomic<uint64_t> cache_evictions;
+
+    /// number of cache accesses of the lru-cache model.
+    std::atomic<uint64_t> cache_hits;
+
+    /// memory accesses of the finished simulation tasks.
+    memory_touch_stats touch_totals;
+
+    /// used for touch_totals synchronization.
+    std::mutex touch_mutex;
+
+    /// memory accesses of the simulation task running on the thread, not yet added to touch_totals.
+    static thread_local memory_touch_stats thread_touch_stats;
+
+    /// whether the simulation tasks print their progress.
+    bool report_progress;
+
     /// random number generator.
     static thread_local std::mt19937 rng;
 
-    /// distribution for object size category.
-    static thread_local std::uniform_int_distribution<int> category_dist;
+    /**
+     * @brief simulates allocation of a thread.
+     * @param tls - pointer to a thread local stack.
+    */
+    void simulate_tls_alloc(thread_local_stack* tls);
 
-    /// distribution for small object size.
-    static thread_local std::uniform_int_distribution<uint32_t> small_dist;
+    /**
+     * @brief pushes the scope, allocates its objects and its nested scopes, then pops it.
+     * @param tls - reference to a thread local stack.
+     * @param scope - index of the top-level scope.
+     * @param level - nesting level of the scope, 0 for the top-level scope.
+    */
+    void simulate_scope(thread_local_stack& tls, size_t scope, size_t level);
 
-    /// distribution for medium object size.
-    static thread_local std::uniform_int_distribution<uint32_t> medium_dist;
+    /**
+     * @brief allocates the objects of a tls in a single scope, keeping each reachable for the lifetime drawn by its model.
+     * @param tls - reference to a thread local stack.
+     * @details objects are referenced by tls variables l{slot} until they expire, slots of expired objects are reused;
+     * cached objects are referenced by c{entry} until evicted.
+    */
+    void simulate_lifetime_model(thread_local_stack& tls);
 
-    /// distribution for large object size.
-    static thread_local std::uniform_int_distribution<uint32_t> large_dist;
+    /**
+     * @brief counts the allocation in thread_allocations if it succeeded.
+     * @param obj - pointer to the newly allocated object, nullptr if allocation failed.
+    */
+    static void count_allocation(const header* obj) noexcept {
+        if(obj) ++thread_allocations;
+    }
 
     /**
-     * @brief simulates allocation of a thread, stress mode.
-     * @param tls - pointer to a thread local stack.
-     * @param scope_count - number of scopes.
-     * @param allocs_per_scope - number of allocations per scope.
+     * @brief initializes the payload of the new object and touches live objects of the root, as configured.
+     * @param obj - pointer to the newly allocated object, must already be referenced by the root.
+     * @param tls - pointer to the thread local stack whose variables are touched, nullptr touches only obj.
+    */
+    void touch_memory(header* obj, thread_local_stack* tls);
+
+    /**
+     * @brief reads and updates a word of every cache line of the object's payload, counting it in thread_touch_stats.
+     * @param obj - pointer to a live object, nullptr is skipped.
+    */
+    static void touch_object(header* obj) noexcept;
+
+    /**
+     * @brief adds the memory accesses of the calling thread to touch_totals and clears them.
     */
-    void simulate_tls_alloc(thread_local_stack* tls, size_t scope_count, size_t allocs_per_scope);
+    void flush_touch_stats();
 
     /**
-     * @brief simulates allocation of a global variable, stress mode.
+     * @brief simulates allocation of a global variable.
      * @param global - pointer to a global root.
-     * @param global_allocs - number of allocations for global variable.
     */
-    void simulate_global_alloc(global_root* global, size_t global_allocs);
+    void simulate_global_alloc(global_root* global);
 
     /**
-     * @brief simulates allocation of a register variable, stress mode.
+     * @brief simulates allocation of a register variable.
      * @param register - pointer to a register root.
-     * @param register_allocs - number of allocations for register.
     */
-    void simulate_register_alloc(register_root* reg, size_t register_allocs);
+    void simulate_register_alloc(register_root* reg);
 
     /**
      * @brief creates the root for root-set-table.
@@ -130,95 +240,58 @@ private:
      * @param index - index of the caller.
      * @param simulate - simulation function.
      * @param completion_latch - synchronization for simulation.
+     * @param deadline_ns - steady clock time until which the simulation is repeated, 0 runs it once.
     */
     template <typename fn>
-    void enqueue_simulation(const std::string& label, size_t index, fn&& simulate, std::latch& completion_latch){
-        alloc_thread_pool.enqueue([label, index, simulate = std::forward<fn>(simulate), &completion_latch]{
-            std::cout << std::format("{} {} is allocating...\n", label, index);
-            simulate();
-            std::cout << std::format("{} {} finished\n", label, index);
+    void enqueue_simulation(const std::string& label, size_t index, fn&& simulate, std::latch& completion_latch, uint64_t deadline_ns){
+        alloc_thread_pool.enqueue([this, label, index, simulate = std::forward<fn>(simulate), &completion_latch, deadline_ns]{
+            if(report_progress) std::cout << std::format("{} {} is allocating...\n", label, index);
+            const uint64_t task_cpu_start_ns = gc_pause_report::thread_cpu_ns();
+            {
+                perf_scope task_counters(alloc_counters);
+                do {
+                    simulate();
+                } while(gc_pause_report::clock_ns() < deadline_ns);
+            }
+            flush_touch_stats();
+            allocated_objects.fetch_add(thread_allocations, std::memory_order_relaxed);
+            thread_allocations = 0;
+            mutator_cpu_ns.fetch_add(gc_pause_report::thread_cpu_ns() - task_cpu_start_ns, std::memory_order_relaxed);
+            if(report_progress) std::cout << std::format("{} {} finished\n", label, index);
             
             completion_latch.count_down();
         });
     }
 
     /**
-     * @brief getter for the name of the mode of simulation.
-     * @param mode - simulation mode.
-     * @returns name of the mode.
-    */
-    static constexpr const char* simulation_mode_name(simulation_mode mode) {
-        switch (mode) {
-            case simulation_mode::stress: return "stress";
-            case simulation_mode::relaxed: return "relaxed";
-        }
-        std::unreachable();
-    }
-
-    /**
-     * @brief getter for tls scope count.
-     * @param mode - mode of the simulation.
-     * @returns number of scopes for tls.
-    */
-    static constexpr size_t tls_scope_count(simulation_mode mode){
-        switch(mode){
-            case simulation_mode::stress: return TLS_SCOPE_COUNT_STRESS;
-            case simulation_mode::relaxed: return TLS_SCOPE_COUNT_RELAXED;
-        }
-        std::unreachable();
-    }
-
-    /**
-     * @brief getter for tls allocation count per scope.
-     * @param mode - mode of the simulation.
-     * @returns number of allocation for tls per scope.
+     * @brief prints the CPU time of the gc phases, their parallel efficiency and the mutator/gc CPU ratio.
+     * @param report - const reference to the pause report of the run.
+     * @param mutator_cpu - CPU time of the simulation tasks during the run, including gc cycles they ran.
+     * @param operations - number of allocations and object touches of the run, mutator time is reported per operation.
     */
-    static constexpr size_t tls_allocs_per_scope(simulation_mode mode){
-        switch(mode){
-            case simulation_mode::stress: return TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE;
-            case simulation_mode::relaxed: return TLS_ALLOC_RELAXED_THRESHOLD_PER_SCOPE;
-        }
-        std::unreachable();
-    }
+    void print_cpu_time(const gc_pause_report& report, uint64_t mutator_cpu, uint64_t operations) const;
 
     /**
-     * @brief getter for the initial capacity of the hash-map that maps tls variable to its index.
-     * @param mode - mode of the simulation.
-     * @returns initial capacity of the hash-map.
+     * @brief prints the hardware counters of the allocation batch and the gc phases.
+     * @param allocation - counters of the simulation tasks.
+     * @param allocations - number of allocations of the simulation.
+     * @param gc_counters - counters of the gc phases during the simulation.
+     * @details derived IPC and misses per object are printed, unavailable counters are reported as n/a. Prints nothing unless built with GCSIM_PERF_COUNTERS.
     */
-    static constexpr size_t tls_map_capacity(simulation_mode mode){
-        switch(mode){
-            case simulation_mode::stress: return TLS_MAP_CAPACITY_STRESS;
-            case simulation_mode::relaxed: return TLS_MAP_CAPACITY_RELAXED;
-        }
-        std::unreachable();
-    }
+    static void print_perf_counters(const perf_sample& allocation, uint64_t allocations, const gc_perf_counters& gc_counters);
 
     /**
-     * @brief getter for global allocation count.
-     * @param mode - mode of the simulation.
-     * @returns number of allocation for global variable.
+     * @brief prints the allocation latency percentiles per allocation path.
+     * @param latency - merged latency histograms of the mutator threads.
     */
-    static constexpr size_t global_alloc_count(simulation_mode mode){
-        switch(mode){
-            case simulation_mode::stress: return GLOBAL_ALLOC_STRESS_THRESHOLD;
-            case simulation_mode::relaxed: return GLOBAL_ALLOC_RELAXED_THRESHOLD;
-        }
-        std::unreachable();
-    }
+    static void print_allocation_latency(const allocation_latency_summary& latency);
 
     /**
-     * @brief getter for register allocation count.
-     * @param mode - mode of the simulation.
-     * @returns number of allocation for register.
+     * @brief prints the live-object census of the last gc.
+     * @param census - census of the live objects.
+     * @details size classes are ranked by live bytes, followed by the bytes retained by each root kind.
     */
-    static constexpr size_t register_alloc_count(simulation_mode mode){
-        switch(mode){
-            case simulation_mode::stress: return REGISTER_ALLOC_STRESS_THRESHOLD;
-            case simulation_mode::relaxed: return REGISTER_ALLOC_RELAXED_THRESHOLD;
-        }
-        std::unreachable();
-    }
+    static void print_live_census(const live_census& census);
 
     /** 
      * @brief generates the size of the object.
@@ -231,8 +304,9 @@ public:
      * @brief creates the instance of the allocators.
      * @param heap_manager_ref - reference to a heap manager.
      * @param thread_count - number of thread in allocators thread pool.
+     * @param config - const reference to the parameters of the workload, must outlive the allocators.
     */
-    allocators(heap_manager& heap_manager_ref, size_t thread_count);
+    allocators(heap_manager& heap_manager_ref, size_t thread_count, const workload_config& config);
 
     /**
      * @brief deletes the instance of the allocators.
@@ -240,13 +314,71 @@ public:
     ~allocators() = default;
 
     /**
-     * @brief starts the allocation simulation, stress mode.
-     * @param tls_count - number of threads that are allocating objects.
-     * @param global_count - number of global variables that are referencing objects.
-     * @param register_count - number of register variables that are referencing objects.
-     * @param mode - mode of the simulation.
+     * @brief starts the allocation simulation of the configured roots.
+     * @param report - whether progress and the full report are printed, the heap is reset either way.
+     * @returns headline metrics of the run.
+    */
+    simulation_result simulate_alloc(bool report = true);
+
+    /**
+     * @brief prints the locks ranked by wait time, with contention, hold time and try_lock failure rates.
+     * @details counters cover every lock created since the start of the program, prints nothing unless built with GCSIM_LOCK_PROFILING.
+    */
+    static void print_lock_contention();
+
+    /**
+     * @brief prints the sampled allocation sites with the most allocated bytes.
+     * @param sites - site statistics ranked by estimated allocated bytes.
+    */
+    static void print_allocation_sites(const indexed_stack<allocation_site_stats>& sites);
+
+    /**
+     * @brief prints the heap statistics.
+     * @param stats - snapshot of the heap statistics.
+    */
+    static void print_heap_stats(const heap_stats& stats);
+
+    /**
+     * @brief prints the gc pause distribution, phase durations and minimum mutator utilization.
+     * @param report - const reference to the pause report of the run.
+    */
+    static void print_gc_pauses(const gc_pause_report& report);
+
+    /**
+     * @brief prints the operations and throughput of a trace replay.
+     * @param replayer - const reference to the replayer.
+     * @param stats - const reference to the stats of the replay.
+    */
+    static void print_replay_stats(const trace_replayer& replayer, const replay_stats& stats);
+
+    /**
+     * @brief prints the throughput, latency and queueing delay percentiles of an offered load.
+     * @param stats - const reference to the results of the load.
+    */
+    static void print_request_load(const request_load_stats& stats);
+
+    /**
+     * @brief prints the latency percentiles against the offered load, one row per load.
+     * @param loads - results of the loads, in the order they ran.
+     * @param workers - number of worker threads that served the loads.
+    */
+    static void print_request_loads(const indexed_stack<request_load_stats>& loads, size_t workers);
+
+    /**
+     * @brief prints the throughput, allocation latency and resident memory of a malloc baseline run.
+     * @param result - const reference to the result of the run.
+     * @param frees - number of objects freed by the run.
+    */
+    static void print_baseline_result(const simulation_result& result, uint64_t frees);
+
+    /**
+     * @brief prints the gc heap and the malloc baseline side by side.
+     * @param gc - const reference to the result of the gc heap run.
+     * @param baseline - const reference to the result of the baseline run.
+     * @param baseline_name - name of the allocator of the baseline.
+     * @details latency columns are n/a unless built with GCSIM_LATENCY_HISTOGRAMS.
     */
-    void simulate_alloc(size_t tls_count, size_t global_count, size_t register_count, simulation_mode mode);
+    static void print_backend_comparison(const simulation_result& gc, const simulation_result& baseline, const std::string& baseline_name);
 
 };
 
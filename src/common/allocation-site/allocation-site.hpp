@@ -0,0 +1,43 @@
+#ifndef ALLOCATION_SITE_HPP
+#define ALLOCATION_SITE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <source_location>
+
+/**
+ * @struct allocation_site
+ * @brief identifies the code that allocated an object.
+ * @details created implicitly from std::source_location of the caller, or explicitly from an id and a label.
+*/
+struct allocation_site {
+    /// id of the site, ids derived from source location have the highest bit set.
+    uint64_t id;
+
+    /// label of the site, name of the function for sites derived from source location.
+    const char* name;
+
+    /// source file of the site, empty for explicit sites.
+    const char* file;
+
+    /// line of the site, 0 for explicit sites.
+    uint32_t line;
+
+    /**
+     * @brief creates the site from the source location.
+     * @param location - source location of the allocation, defaults to the location of the caller.
+    */
+    allocation_site(std::source_location location = std::source_location::current()) noexcept
+        : id(((std::hash<const void*>{}(location.file_name()) * 31 + location.line()) * 31 + location.column()) | (uint64_t{1} << 63)),
+          name(location.function_name()), file(location.file_name()), line(location.line()) {}
+
+    /**
+     * @brief creates the explicit site.
+     * @param id - id of the site, highest bit is reserved for sites derived from source location.
+     * @param name - label of the site, must be a string literal.
+    */
+    allocation_site(uint64_t id, const char* name) noexcept : id(id & ~(uint64_t{1} << 63)), name(name), file(""), line(0) {}
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "gc-pause.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <time.h>
+
+gc_pause_report::gc_pause_report(indexed_stack<gc_pause>&& run_pauses, uint64_t run_start_ns, uint64_t run_end_ns) 
+    : pauses(std::move(run_pauses)), run_start_ns(run_start_ns), run_end_ns(std::max(run_start_ns, run_end_ns)), phase_totals{}, non_periodic_collector_cpu_ns(0) {
+
+    std::sort(pauses.begin(), pauses.end(), [](const gc_pause& a, const gc_pause& b) -> bool {
+        return a.start_ns < b.start_ns;
+    });
+
+    for(const gc_pause& pause : pauses){
+        pause_histogram.record(pause.total_ns);
+        phase_totals.lock_acquire_ns += pause.lock_acquire_ns;
+        phase_totals.mark_ns += pause.mark_ns;
+        phase_totals.sweep_ns += pause.sweep_ns;
+        phase_totals.coalesce_ns += pause.coalesce_ns;
+        phase_totals.total_ns += pause.total_ns;
+        phase_totals.collector_cpu_ns += pause.collector_cpu_ns;
+        phase_totals.mark_cpu_ns += pause.mark_cpu_ns;
+        phase_totals.sweep_cpu_ns += pause.sweep_cpu_ns;
+        phase_totals.coalesce_cpu_ns += pause.coalesce_cpu_ns;
+        if(!pause.periodic){
+            non_periodic_collector_cpu_ns += pause.collector_cpu_ns;
+        }
+    }
+}
+
+uint64_t gc_pause_report::paused_time(uint64_t window_start_ns, uint64_t window_end_ns) const noexcept {
+    uint64_t paused = 0;
+    uint64_t covered_until = window_start_ns;
+
+    for(const gc_pause& pause : pauses){
+        if(pause.start_ns >= window_end_ns) break;
+
+        const uint64_t begin = std::max(pause.start_ns, covered_until);
+        const uint64_t end = std::min(pause.start_ns + pause.total_ns, window_end_ns);
+        if(begin < end){
+            paused += end - begin;
+            covered_until = end;
+        }
+    }
+
+    return paused;
+}
+
+size_t gc_pause_report::get_pause_count() const noexcept {
+    return pauses.get_size();
+}
+
+latency_summary gc_pause_report::pause_summary() const noexcept {
+    return pause_histogram.summarize();
+}
+
+const gc_pause& gc_pause_report::get_phase_totals() const noexcept {
+    return phase_totals;
+}
+
+uint64_t gc_pause_report::get_non_periodic_collector_cpu() const noexcept {
+    return non_periodic_collector_cpu_ns;
+}
+
+double gc_pause_report::mutator_utilization() const noexcept {
+    const uint64_t run_ns = run_end_ns - run_start_ns;
+    if(run_ns == 0) return 1.0;
+    return 1.0 - static_cast<double>(paused_time(run_start_ns, run_end_ns)) / static_cast<double>(run_ns);
+}
+
+double gc_pause_report::minimum_mutator_utilization(uint64_t window_ns) const noexcept {
+    if(window_ns == 0) return 0.0;
+    if(run_end_ns - run_start_ns <= window_ns) return mutator_utilization();
+
+    const uint64_t last_window_start = run_end_ns - window_ns;
+    auto window_utilization = [&](uint64_t window_start) -> double {
+        window_start = std::clamp(window_start, run_start_ns, last_window_start);
+        return 1.0 - static_cast<double>(paused_time(window_start, window_start + window_ns)) / static_cast<double>(window_ns);
+    };
+
+    double mmu = 1.0;
+    for(const gc_pause& pause : pauses){
+        const uint64_t pause_end = pause.start_ns + pause.total_ns;
+        mmu = std::min(mmu, window_utilization(pause.start_ns));
+        mmu = std::min(mmu, window_utilization(pause_end > window_ns ? pause_end - window_ns : 0));
+    }
+
+    return std::max(mmu, 0.0);
+}
+
+uint64_t gc_pause_report::clock_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+uint64_t gc_pause_report::thread_cpu_ns() noexcept {
+    timespec ts{};
+    if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+double gc_pause_report::parallel_efficiency(uint64_t cpu_ns, uint64_t wall_ns, size_t thread_count) noexcept {
+    if(wall_ns == 0 || thread_count == 0) return 0.0;
+    return static_cast<double>(cpu_ns) / (static_cast<double>(wall_ns) * static_cast<double>(thread_count));
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef GC_PAUSE_HPP
+#define GC_PAUSE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../indexed-stack/indexed-stack.hpp"
+#include "../latency-histogram/latency-histogram.hpp"
+
+/// window sizes of the minimum mutator utilization in nanoseconds (1ms, 10ms, 100ms).
+constexpr uint64_t MMU_WINDOWS_NS[] = {1'000'000, 10'000'000, 100'000'000};
+
+/// number of windows of the minimum mutator utilization.
+constexpr size_t MMU_WINDOW_COUNT = sizeof(MMU_WINDOWS_NS) / sizeof(MMU_WINDOWS_NS[0]);
+
+/**
+ * @struct gc_pause
+ * @brief durations of the phases of a single gc cycle, in nanoseconds.
+ * @details wall times are measured on the steady clock, CPU times on the thread CPU clocks of the threads doing the work.
+*/
+struct gc_pause {
+    /// time when the gc started acquiring the locks, on the steady clock.
+    uint64_t start_ns;
+
+    /// time spent acquiring root_set_mutex and all segment locks.
+    uint64_t lock_acquire_ns;
+
+    /// time spent marking the objects reachable from the roots.
+    uint64_t mark_ns;
+
+    /// time spent sweeping the segments.
+    uint64_t sweep_ns;
+
+    /// time spent coalescing the free blocks.
+    uint64_t coalesce_ns;
+
+    /// duration of the whole pause, from lock acquisition until the locks are released.
+    uint64_t total_ns;
+
+    /// CPU time of the thread that ran the collection, spent during the whole pause.
+    uint64_t collector_cpu_ns;
+
+    /// CPU time of the mark tasks, summed over the gc threads.
+    uint64_t mark_cpu_ns;
+
+    /// CPU time of the sweep tasks, summed over the gc threads.
+    uint64_t sweep_cpu_ns;
+
+    /// CPU time of the coalesce tasks, summed over the heap manager threads.
+    uint64_t coalesce_cpu_ns;
+
+    /// true if the cycle ran on the periodic gc thread, false if a mutator or client thread ran it.
+    bool periodic;
+
+    /**
+     * @brief calculates the CPU time spent on the cycle by all threads.
+     * @returns CPU time of the collecting thread and of the tasks of all phases.
+    */
+    uint64_t total_cpu_ns() const noexcept {
+        return collector_cpu_ns + mark_cpu_ns + sweep_cpu_ns + coalesce_cpu_ns;
+    }
+};
+
+/**
+ * @class gc_pause_report
+ * @brief pause distribution and minimum mutator utilization of a simulation run.
+ * @details minimum mutator utilization (MMU) of a window size is the smallest fraction of any window of that size,
+ * inside of the run, that wasn't spent in gc pauses.
+*/
+class gc_pause_report {
+private:
+    /// pauses of the run, sorted by start time.
+    indexed_stack<gc_pause> pauses;
+
+    /// start of the run on the steady clock.
+    uint64_t run_start_ns;
+
+    /// end of the run on the steady clock.
+    uint64_t run_end_ns;
+
+    /// distribution of the total pause durations.
+    latency_histogram pause_histogram;
+
+    /// phase durations summed over all pauses, start_ns and periodic are unused.
+    gc_pause phase_totals;
+
+    /// CPU time of the collecting thread summed over the pauses that didn't run on the periodic gc thread.
+    uint64_t non_periodic_collector_cpu_ns;
+
+    /**
+     * @brief calculates the time spent in gc pauses inside of the window.
+     * @param window_start_ns - start of the window.
+     * @param window_end_ns - end of the window.
+     * @returns paused time in nanoseconds, overlapping pauses are counted once.
+    */
+    uint64_t paused_time(uint64_t window_start_ns, uint64_t window_end_ns) const noexcept;
+
+public:
+    /**
+     * @brief creates the report from the pauses of a run.
+     * @param run_pauses - rvalue of the pauses that started during the run.
+     * @param run_start_ns - start of the run on the steady clock.
+     * @param run_end_ns - end of the run on the steady clock.
+    */
+    gc_pause_report(indexed_stack<gc_pause>&& run_pauses, uint64_t run_start_ns, uint64_t run_end_ns);
+
+    /**
+     * @brief deletes the report.
+    */
+    ~gc_pause_report() = default;
+
+    /// deleted copy constructor.
+    gc_pause_report(const gc_pause_report&) = delete;
+
+    /// deleted assignment operator.
+    gc_pause_report& operator=(const gc_pause_report&) = delete;
+
+    /**
+     * @brief getter for the number of pauses.
+     * @returns number of gc cycles during the run.
+    */
+    size_t get_pause_count() const noexcept;
+
+    /**
+     * @brief getter for the pause percentiles.
+     * @returns percentiles of the total pause durations in nanoseconds.
+    */
+    latency_summary pause_summary() const noexcept;
+
+    /**
+     * @brief getter for the summed phase durations.
+     * @returns const reference to the phase durations summed over all pauses.
+    */
+    const gc_pause& get_phase_totals() const noexcept;
+
+    /**
+     * @brief getter for the CPU time that gc cycles charged to the threads that triggered them.
+     * @returns collector CPU time of the pauses that didn't run on the periodic gc thread.
+    */
+    uint64_t get_non_periodic_collector_cpu() const noexcept;
+
+    /**
+     * @brief calculates the fraction of the run that wasn't spent in gc pauses.
+     * @returns mutator utilization in range [0, 1].
+    */
+    double mutator_utilization() const noexcept;
+
+    /**
+     * @brief calculates the minimum mutator utilization of the window size.
+     * @param window_ns - size of the window in nanoseconds.
+     * @returns minimum mutator utilization in range [0, 1], utilization of the whole run if window is longer than the run.
+     * @details the worst window starts at the start of a pause or ends at the end of a pause, only those windows are checked.
+    */
+    double minimum_mutator_utilization(uint64_t window_ns) const noexcept;
+
+    /**
+     * @brief getter for the current time of the steady clock.
+     * @returns nanoseconds since the epoch of the steady clock.
+    */
+    static uint64_t clock_ns() noexcept;
+
+    /**
+     * @brief getter for the CPU time consumed by the calling thread.
+     * @returns nanoseconds on the CLOCK_THREAD_CPUTIME_ID clock, 0 if the clock is unavailable.
+    */
+    static uint64_t thread_cpu_ns() noexcept;
+
+    /**
+     * @brief calculates the parallel efficiency of a phase.
+     * @param cpu_ns - CPU time of the phase summed over the threads.
+     * @param wall_ns - wall time of the phase.
+     * @param thread_count - number of threads that ran the phase.
+     * @returns cpu_ns / (wall_ns * thread_count), 0 if the phase didn't run.
+    */
+    static double parallel_efficiency(uint64_t cpu_ns, uint64_t wall_ns, size_t thread_count) noexcept;
+
+};
+
+#endif
\ No newline at end of file
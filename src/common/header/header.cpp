@@ -28,6 +28,44 @@ void header::set_marked(bool marked) noexcept {
     }
 }
 
+void header::mark_from(uint32_t root_kinds) noexcept {
+    flags.fetch_or(IS_MARKED | ((root_kinds << ROOT_KINDS_SHIFT) & ROOT_KINDS_MASK), std::memory_order_release);
+}
+
+uint32_t header::root_kinds() const noexcept {
+    return (flags.load(std::memory_order_acquire) & ROOT_KINDS_MASK) >> ROOT_KINDS_SHIFT;
+}
+
+void header::clear_mark() noexcept {
+    flags.fetch_and(~(static_cast<uint32_t>(IS_MARKED) | ROOT_KINDS_MASK), std::memory_order_release);
+}
+
+void header::reset_flags(bool free) noexcept {
+    flags.store(free ? IS_FREE : 0, std::memory_order_release);
+}
+
+bool header::is_region() const noexcept {
+    return region_id() != 0;
+}
+
+uint32_t header::region_id() const noexcept {
+    return flags.load(std::memory_order_acquire) >> REGION_ID_SHIFT;
+}
+
+void header::set_region_id(uint32_t id) noexcept {
+    uint32_t current = flags.load(std::memory_order_relaxed);
+    while(!flags.compare_exchange_weak(current, (current & ((1u << REGION_ID_SHIFT) - 1)) | (id << REGION_ID_SHIFT), 
+        std::memory_order_acq_rel, std::memory_order_relaxed));
+}
+
+bool header::is_escaped() const noexcept {
+    return flags.load(std::memory_order_acquire) & IS_ESCAPED;
+}
+
+bool header::set_escaped() noexcept {
+    return !(flags.fetch_or(IS_ESCAPED, std::memory_order_acq_rel) & IS_ESCAPED);
+}
+
 void* header::data_ptr() noexcept {
     return reinterpret_cast<void*>(this + 1);
 }
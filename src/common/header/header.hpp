@@ -10,6 +10,18 @@ constexpr uint8_t IS_FREE = 0x01;
 /// is marked flag is on the second lowest bit.
 constexpr uint8_t IS_MARKED = 0x02;
 
+/// is escaped flag is on the third lowest bit.
+constexpr uint8_t IS_ESCAPED = 0x04;
+
+/// root kinds that reached the block during a census marking are stored above the escaped flag.
+constexpr uint32_t ROOT_KINDS_SHIFT = 3;
+
+/// bits of the root kinds inside of the flags.
+constexpr uint32_t ROOT_KINDS_MASK = 0x07u << ROOT_KINDS_SHIFT;
+
+/// id of the scope region that owns the block is stored above the flag bits.
+constexpr uint32_t REGION_ID_SHIFT = 8;
+
 /**
  * @struct header
  * @brief header of the block inside of the heap segment.
@@ -20,7 +32,7 @@ struct header {
     header* next;
     /// size - the amount of memory the current block occupies.
     uint32_t size;
-    /// flags - 0x000000mf; m - marked (0/1), f - free (0/1).
+    /// flags - 0xrrrrrrkkemf; r - id of the owning scope region (0 if none), k - root kinds of the census (3 bits), e - escaped (0/1), m - marked (0/1), f - free (0/1).
     std::atomic<uint32_t> flags; //< 32b only because of the alignment.
 
     /**
@@ -57,6 +69,60 @@ struct header {
     */
     void set_marked(bool marked) noexcept;
 
+    /**
+     * @brief marks the block and records the kinds of the roots that reached it.
+     * @param root_kinds - bits of the root kinds, 0 only marks the block.
+    */
+    void mark_from(uint32_t root_kinds) noexcept;
+
+    /**
+     * @brief getter for the root kinds that reached the block during the census marking.
+     * @returns bits of the root kinds.
+    */
+    uint32_t root_kinds() const noexcept;
+
+    /**
+     * @brief clears the marked flag and the root kinds of the block.
+    */
+    void clear_mark() noexcept;
+
+    /**
+     * @brief resets all flags of the block.
+     * @param free - value for the is_free flag.
+     * @details clears marked and escaped flags and the id of the owning scope region.
+    */
+    void reset_flags(bool free) noexcept;
+
+    /**
+     * @brief checks if the block was allocated inside of a scope region.
+     * @returns true if block belongs to a scope region, false otherwise.
+    */
+    bool is_region() const noexcept;
+
+    /**
+     * @brief getter for the id of the scope region that owns the block.
+     * @returns id of the scope region, 0 if block doesn't belong to a region.
+    */
+    uint32_t region_id() const noexcept;
+
+    /**
+     * @brief sets the id of the scope region that owns the block.
+     * @param id - id of the scope region, 0 detaches the block from its region.
+    */
+    void set_region_id(uint32_t id) noexcept;
+
+    /**
+     * @brief checks if the block escaped its scope region.
+     * @returns true if header has escaped flag 1, false otherwise.
+    */
+    bool is_escaped() const noexcept;
+
+    /**
+     * @brief sets the escaped flag.
+     * @returns true if the flag was previously cleared, false otherwise.
+    */
+    bool set_escaped() noexcept;
+
     /**
      * @brief getter for the address where data begins.
      * @returns pointer to data.
@@ -0,0 +1,82 @@
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <bit>
+
+void latency_histogram::record(uint64_t value) noexcept {
+    counts[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    total_count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current_max = max_value.load(std::memory_order_relaxed);
+    while(value > current_max && !max_value.compare_exchange_weak(current_max, value, std::memory_order_relaxed));
+}
+
+void latency_histogram::merge(const latency_histogram& other) noexcept {
+    for(size_t i = 0; i < LATENCY_BUCKETS; ++i){
+        counts[i].fetch_add(other.counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    total_count.fetch_add(other.total_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    const uint64_t other_max = other.max_value.load(std::memory_order_relaxed);
+    uint64_t current_max = max_value.load(std::memory_order_relaxed);
+    while(other_max > current_max && !max_value.compare_exchange_weak(current_max, other_max, std::memory_order_relaxed));
+}
+
+void latency_histogram::clear() noexcept {
+    for(std::atomic<uint64_t>& count : counts){
+        count.store(0, std::memory_order_relaxed);
+    }
+    total_count.store(0, std::memory_order_relaxed);
+    max_value.store(0, std::memory_order_relaxed);
+}
+
+uint64_t latency_histogram::value_at_percentile(double percentile) const noexcept {
+    const uint64_t count = total_count.load(std::memory_order_relaxed);
+    if(count == 0) return 0;
+
+    const uint64_t max = max_value.load(std::memory_order_relaxed);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5));
+
+    uint64_t seen = 0;
+    for(size_t i = 0; i < LATENCY_BUCKETS; ++i){
+        seen += counts[i].load(std::memory_order_relaxed);
+        if(seen >= target){
+            return std::min(bucket_upper_bound(i), max);
+        }
+    }
+    return max;
+}
+
+latency_summary latency_histogram::summarize() const noexcept {
+    return latency_summary{
+        .count = get_count(),
+        .p50 = value_at_percentile(50.0),
+        .p90 = value_at_percentile(90.0),
+        .p99 = value_at_percentile(99.0),
+        .p999 = value_at_percentile(99.9),
+        .max = max_value.load(std::memory_order_relaxed)
+    };
+}
+
+uint64_t latency_histogram::get_count() const noexcept {
+    return total_count.load(std::memory_order_relaxed);
+}
+
+size_t latency_histogram::bucket_index(uint64_t value) noexcept {
+    if(value < LATENCY_SUB_BUCKETS) return static_cast<size_t>(value);
+
+    const size_t exponent = static_cast<size_t>(std::bit_width(value)) - 1;
+    if(exponent > LATENCY_MAX_EXPONENT) return LATENCY_BUCKETS - 1;
+
+    const size_t shift = exponent - LATENCY_SUB_BUCKET_BITS;
+    const size_t sub_bucket = static_cast<size_t>(value >> shift) - LATENCY_SUB_BUCKETS;
+    return LATENCY_SUB_BUCKETS + shift * LATENCY_SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t latency_histogram::bucket_upper_bound(size_t index) noexcept {
+    if(index < LATENCY_SUB_BUCKETS) return index;
+
+    const size_t shift = (index - LATENCY_SUB_BUCKETS) / LATENCY_SUB_BUCKETS;
+    const uint64_t sub_bucket = LATENCY_SUB_BUCKETS + (index - LATENCY_SUB_BUCKETS) % LATENCY_SUB_BUCKETS;
+    return ((sub_bucket + 1) << shift) - 1;
+}
\ No newline at end of file
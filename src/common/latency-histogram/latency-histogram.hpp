@@ -0,0 +1,172 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#ifdef GCSIM_LATENCY_HISTOGRAMS
+/// latency recording is enabled with -DGCSIM_LATENCY_HISTOGRAMS.
+constexpr bool LATENCY_HISTOGRAMS_ENABLED = true;
+#else
+/// latency recording is enabled with -DGCSIM_LATENCY_HISTOGRAMS.
+constexpr bool LATENCY_HISTOGRAMS_ENABLED = false;
+#endif
+
+/// number of bits of the value kept exact within a power of two (16 sub-buckets, ~6% precision).
+constexpr size_t LATENCY_SUB_BUCKET_BITS = 4;
+
+/// number of sub-buckets per power of two.
+constexpr size_t LATENCY_SUB_BUCKETS = size_t{1} << LATENCY_SUB_BUCKET_BITS;
+
+/// highest power of two tracked, values above 2^40ns (~18 min) share the last bucket.
+constexpr size_t LATENCY_MAX_EXPONENT = 40;
+
+/// number of buckets in a histogram.
+constexpr size_t LATENCY_BUCKETS = LATENCY_SUB_BUCKETS + (LATENCY_MAX_EXPONENT - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS;
+
+/**
+ * @struct latency_summary
+ * @brief percentiles of the recorded values.
+*/
+struct latency_summary {
+    /// number of recorded values.
+    uint64_t count;
+
+    /// median.
+    uint64_t p50;
+
+    /// 90th percentile.
+    uint64_t p90;
+
+    /// 99th percentile.
+    uint64_t p99;
+
+    /// 99.9th percentile.
+    uint64_t p999;
+
+    /// maximum recorded value.
+    uint64_t max;
+};
+
+/**
+ * @class latency_histogram
+ * @brief log-linear histogram in HDR-histogram style.
+ * @details values below LATENCY_SUB_BUCKETS are exact, every further power of two is split into LATENCY_SUB_BUCKETS buckets.
+ * Recording is lock-free, histograms are merged on demand.
+*/
+class latency_histogram {
+private:
+    /// number of values in each bucket.
+    std::atomic<uint64_t> counts[LATENCY_BUCKETS]{};
+
+    /// number of recorded values.
+    std::atomic<uint64_t> total_count{0};
+
+    /// maximum recorded value.
+    std::atomic<uint64_t> max_value{0};
+
+public:
+    /**
+     * @brief creates an empty histogram.
+    */
+    latency_histogram() = default;
+
+    /**
+     * @brief deletes the histogram.
+    */
+    ~latency_histogram() = default;
+
+    /// deleted copy constructor.
+    latency_histogram(const latency_histogram&) = delete;
+
+    /// deleted assignment operator.
+    latency_histogram& operator=(const latency_histogram&) = delete;
+
+    /**
+     * @brief records a value.
+     * @param value - recorded value, in nanoseconds for latencies.
+    */
+    void record(uint64_t value) noexcept;
+
+    /**
+     * @brief adds the values of another histogram to this one.
+     * @param other - const reference to a histogram.
+    */
+    void merge(const latency_histogram& other) noexcept;
+
+    /**
+     * @brief removes every recorded value.
+     * @warning values recorded concurrently may be lost or kept partially.
+    */
+    void clear() noexcept;
+
+    /**
+     * @brief calculates the value at the percentile.
+     * @param percentile - percentile in range [0, 100].
+     * @returns upper bound of the bucket containing the percentile, capped by the maximum.
+    */
+    uint64_t value_at_percentile(double percentile) const noexcept;
+
+    /**
+     * @brief calculates the summary of the histogram.
+     * @returns count, p50, p90, p99, p99.9 and max.
+    */
+    latency_summary summarize() const noexcept;
+
+    /**
+     * @brief getter for the number of recorded values.
+     * @returns number of recorded values.
+    */
+    uint64_t get_count() const noexcept;
+
+    /**
+     * @brief getter for the bucket of the value.
+     * @param value - recorded value.
+     * @returns index of the bucket.
+    */
+    static size_t bucket_index(uint64_t value) noexcept;
+
+    /**
+     * @brief getter for the largest value of the bucket.
+     * @param index - index of the bucket.
+     * @returns upper bound of the bucket.
+    */
+    static uint64_t bucket_upper_bound(size_t index) noexcept;
+
+};
+
+/**
+ * @struct allocation_latency_histograms
+ * @brief latency histograms of a mutator thread, split by allocation path.
+*/
+struct allocation_latency_histograms {
+    /// allocations served by the first attempt.
+    latency_histogram fast_path;
+
+    /// allocations that entered the slow path without waiting for gc.
+    latency_histogram slow_path;
+
+    /// allocations that ran or waited for gc.
+    latency_histogram gc_wait;
+};
+
+/**
+ * @struct allocation_latency_summary
+ * @brief latency percentiles of allocations, split by allocation path.
+*/
+struct allocation_latency_summary {
+    /// allocations served by the first attempt.
+    latency_summary fast_path;
+
+    /// allocations that entered the slow path without waiting for gc.
+    latency_summary slow_path;
+
+    /// allocations that ran or waited for gc.
+    latency_summary gc_wait;
+
+    /// allocations of every path.
+    latency_summary all;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,105 @@
+#ifndef MUTATOR_CONTEXT_HPP
+#define MUTATOR_CONTEXT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include "../../heap/heap.hpp"
+
+/// size of the cache line in bytes, per-thread data is padded to it.
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+/// maximum number of mutator threads with separate contexts, later threads share contexts in registration order modulo the limit.
+constexpr size_t MAX_MUTATOR_THREADS = 64;
+
+/**
+ * @struct mutator_context
+ * @brief per-thread allocation state of a mutator thread.
+ * @details padded to the cache line, so threads don't share cache lines when updating counters.
+*/
+struct alignas(CACHE_LINE_SIZE) mutator_context {
+    /// registration order of the thread, used to assign its home segments.
+    size_t slot{0};
+
+    /// number of successful allocations.
+    std::atomic<uint64_t> allocations{0};
+
+    /// number of allocations served by the home segment of the thread, counted only under thread_affinity.
+    std::atomic<uint64_t> home_hits{0};
+
+    /// number of segment locks taken to allocate.
+    std::atomic<uint64_t> lock_attempts{0};
+
+    /// number of segment locks taken to allocate that found the segment already locked.
+    std::atomic<uint64_t> contended_locks{0};
+
+    /// number of bytes the thread allocates before its next allocation is sampled, drawn at registration.
+    std::atomic<int64_t> bytes_until_sample{0};
+
+    /// number of successful allocations of each object size category.
+    std::atomic<uint64_t> category_allocations[SEGMENT_CATEGORY_COUNT]{};
+
+    /// number of allocated bytes of each object size category.
+    std::atomic<uint64_t> category_bytes[SEGMENT_CATEGORY_COUNT]{};
+
+    /// number of allocations of each object size category that entered the slow path.
+    std::atomic<uint64_t> category_slow_path_entries[SEGMENT_CATEGORY_COUNT]{};
+
+    /// number of failed allocations of each object size category.
+    std::atomic<uint64_t> category_failures[SEGMENT_CATEGORY_COUNT]{};
+};
+
+/**
+ * @struct mutator_stats
+ * @brief snapshot of the counters of a mutator thread.
+*/
+struct mutator_stats {
+    /// registration order of the thread.
+    size_t slot;
+
+    /// number of successful allocations.
+    uint64_t allocations;
+
+    /// number of allocations served by the home segment of the thread.
+    uint64_t home_hits;
+
+    /// number of segment locks taken to allocate.
+    uint64_t lock_attempts;
+
+    /// number of segment locks taken to allocate that found the segment already locked.
+    uint64_t contended_locks;
+
+    /**
+     * @brief calculates the difference to an earlier snapshot of the same context.
+     * @param start - snapshot at the start of the interval.
+     * @returns counters of the interval.
+    */
+    mutator_stats since(const mutator_stats& start) const noexcept {
+        return mutator_stats{
+            .slot = slot,
+            .allocations = allocations - start.allocations,
+            .home_hits = home_hits - start.home_hits,
+            .lock_attempts = lock_attempts - start.lock_attempts,
+            .contended_locks = contended_locks - start.contended_locks
+        };
+    }
+
+    /**
+     * @brief calculates the share of allocations served by the home segment.
+     * @returns home hit rate in range [0, 1].
+    */
+    double home_hit_rate() const noexcept {
+        return allocations == 0 ? 0.0 : static_cast<double>(home_hits) / static_cast<double>(allocations);
+    }
+
+    /**
+     * @brief calculates the share of lock attempts that found the segment locked.
+     * @returns lock contention rate in range [0, 1].
+    */
+    double contention_rate() const noexcept {
+        return lock_attempts == 0 ? 0.0 : static_cast<double>(contended_locks) / static_cast<double>(lock_attempts);
+    }
+};
+
+#endif
\ No newline at end of file
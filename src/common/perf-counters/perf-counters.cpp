@@ -0,0 +1,144 @@
+#include "perf-counters.hpp"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+perf_counter_group::perf_counter_group() noexcept : opened(0) {
+    for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+        fds[i] = -1;
+        read_positions[i] = 0;
+    }
+
+#ifdef __linux__
+    struct counter_config {
+        uint32_t type;
+        uint64_t config;
+    };
+
+    const counter_config configs[PERF_COUNTER_COUNT] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+
+    int leader_fd = -1;
+    for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = configs[i].type;
+        attr.config = configs[i].config;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.disabled = leader_fd == -1 ? 1 : 0;
+
+        const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_fd, 0));
+        if(fd == -1){
+            if(leader_fd == -1) return;
+            continue;
+        }
+
+        if(leader_fd == -1) leader_fd = fd;
+        fds[i] = fd;
+        read_positions[i] = opened++;
+    }
+
+    ioctl(leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+perf_counter_group::~perf_counter_group() {
+#ifdef __linux__
+    for(size_t i = PERF_COUNTER_COUNT; i > 0; --i){
+        if(fds[i - 1] != -1){
+            close(fds[i - 1]);
+        }
+    }
+#endif
+}
+
+bool perf_counter_group::is_available() const noexcept {
+    return opened != 0;
+}
+
+perf_sample perf_counter_group::read() const noexcept {
+    perf_sample sample{};
+    if(!is_available()) return sample;
+
+#ifdef __linux__
+    uint64_t buffer[3 + PERF_COUNTER_COUNT]{};
+    const ssize_t bytes = ::read(fds[static_cast<size_t>(perf_counter::cycles)], buffer, sizeof(buffer));
+    if(bytes < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != opened) return sample;
+
+    const uint64_t time_enabled = buffer[1];
+    const uint64_t time_running = buffer[2];
+    const double scale = time_running != 0 && time_running < time_enabled 
+        ? static_cast<double>(time_enabled) / static_cast<double>(time_running) : 1.0;
+
+    for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+        if(fds[i] == -1) continue;
+        sample.values[i] = static_cast<uint64_t>(static_cast<double>(buffer[3 + read_positions[i]]) * scale);
+        sample.available_mask |= 1u << i;
+    }
+#endif
+
+    return sample;
+}
+
+perf_counter_group& perf_counter_group::current() noexcept {
+    thread_local perf_counter_group group;
+    return group;
+}
+
+void perf_phase_counters::add(const perf_sample& delta, uint64_t processed_objects) noexcept {
+    for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+        values[i].fetch_add(delta.values[i], std::memory_order_relaxed);
+    }
+    available_mask.fetch_or(delta.available_mask, std::memory_order_relaxed);
+    objects.fetch_add(processed_objects, std::memory_order_relaxed);
+}
+
+void perf_phase_counters::add_objects(uint64_t processed_objects) noexcept {
+    objects.fetch_add(processed_objects, std::memory_order_relaxed);
+}
+
+perf_sample perf_phase_counters::load() const noexcept {
+    perf_sample sample{};
+    for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+        sample.values[i] = values[i].load(std::memory_order_relaxed);
+    }
+    sample.available_mask = available_mask.load(std::memory_order_relaxed);
+    return sample;
+}
+
+uint64_t perf_phase_counters::get_objects() const noexcept {
+    return objects.load(std::memory_order_relaxed);
+}
+
+perf_scope::perf_scope(perf_phase_counters& phase) noexcept : phase(phase), start{}, processed_objects(0) {
+    if constexpr (PERF_COUNTERS_ENABLED){
+        start = perf_counter_group::current().read();
+    }
+}
+
+perf_scope::~perf_scope() {
+    if constexpr (PERF_COUNTERS_ENABLED){
+        phase.add(perf_counter_group::current().read().since(start), processed_objects);
+    }
+    else {
+        phase.add_objects(processed_objects);
+    }
+}
+
+void perf_scope::add_objects(uint64_t count) noexcept {
+    processed_objects += count;
+}
\ No newline at end of file
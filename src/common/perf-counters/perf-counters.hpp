@@ -0,0 +1,236 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#ifdef GCSIM_PERF_COUNTERS
+/// hardware counters are read with -DGCSIM_PERF_COUNTERS.
+constexpr bool PERF_COUNTERS_ENABLED = true;
+#else
+/// hardware counters are read with -DGCSIM_PERF_COUNTERS.
+constexpr bool PERF_COUNTERS_ENABLED = false;
+#endif
+
+/// number of hardware counters in a group.
+constexpr size_t PERF_COUNTER_COUNT = 5;
+
+/**
+ * @enum perf_counter
+ * @brief hardware events counted by a counter group, values index the counters of a sample.
+*/
+enum class perf_counter : uint8_t { cycles, instructions, cache_misses, dtlb_misses, branch_misses };
+
+/**
+ * @brief getter for the name of the hardware event.
+ * @param counter - hardware event.
+ * @returns name of the event.
+*/
+constexpr const char* perf_counter_name(perf_counter counter) noexcept {
+    switch(counter){
+        case perf_counter::cycles: return "cycles";
+        case perf_counter::instructions: return "instructions";
+        case perf_counter::cache_misses: return "cache misses";
+        case perf_counter::dtlb_misses: return "dTLB misses";
+        case perf_counter::branch_misses: return "branch misses";
+    }
+    return "unknown";
+}
+
+/**
+ * @struct perf_sample
+ * @brief values of the hardware counters.
+*/
+struct perf_sample {
+    /// counter values, indexed by perf_counter.
+    uint64_t values[PERF_COUNTER_COUNT];
+
+    /// bit mask of the counters that were read, indexed by perf_counter.
+    uint32_t available_mask;
+
+    /**
+     * @brief checks if the counter was read.
+     * @param counter - hardware event.
+     * @returns true if counter is available, false otherwise.
+    */
+    bool has(perf_counter counter) const noexcept {
+        return available_mask & (1u << static_cast<uint32_t>(counter));
+    }
+
+    /**
+     * @brief getter for the counter value.
+     * @param counter - hardware event.
+     * @returns value of the counter, 0 if counter is unavailable.
+    */
+    uint64_t get(perf_counter counter) const noexcept {
+        return values[static_cast<size_t>(counter)];
+    }
+
+    /**
+     * @brief calculates the instructions per cycle.
+     * @returns instructions per cycle, 0 if cycles or instructions are unavailable.
+    */
+    double ipc() const noexcept {
+        if(!has(perf_counter::cycles) || !has(perf_counter::instructions) || get(perf_counter::cycles) == 0) return 0.0;
+        return static_cast<double>(get(perf_counter::instructions)) / static_cast<double>(get(perf_counter::cycles));
+    }
+
+    /**
+     * @brief calculates the difference to an earlier sample.
+     * @param start - counters at the start of the interval.
+     * @returns counters of the interval, counters missing from start are counted from 0.
+    */
+    perf_sample since(const perf_sample& start) const noexcept {
+        perf_sample delta{};
+        delta.available_mask = available_mask;
+        for(size_t i = 0; i < PERF_COUNTER_COUNT; ++i){
+            const uint64_t start_value = start.available_mask & (1u << i) ? start.values[i] : 0;
+            if(delta.available_mask & (1u << i)){
+                delta.values[i] = values[i] >= start_value ? values[i] - start_value : 0;
+            }
+        }
+        return delta;
+    }
+};
+
+/**
+ * @class perf_counter_group
+ * @brief group of hardware counters of the calling thread, opened with perf_event_open.
+ * @details counters that can't be opened (no permission, virtualized pmu, non-linux build) are left out of the samples,
+ * if cycles can't be opened the group is unavailable and every sample is empty.
+*/
+class perf_counter_group {
+private:
+    /// file descriptors of the counters, -1 if counter isn't opened.
+    int fds[PERF_COUNTER_COUNT];
+
+    /// position of each opened counter inside of the group read.
+    size_t read_positions[PERF_COUNTER_COUNT];
+
+    /// number of opened counters.
+    size_t opened;
+
+    /**
+     * @brief creates the counter group of the calling thread.
+    */
+    perf_counter_group() noexcept;
+
+public:
+    /**
+     * @brief closes the counters.
+    */
+    ~perf_counter_group();
+
+    /// deleted copy constructor.
+    perf_counter_group(const perf_counter_group&) = delete;
+
+    /// deleted assignment operator.
+    perf_counter_group& operator=(const perf_counter_group&) = delete;
+
+    /**
+     * @brief checks if any counter is opened.
+     * @returns true if group counts cycles, false otherwise.
+    */
+    bool is_available() const noexcept;
+
+    /**
+     * @brief reads all counters of the group at once.
+     * @returns values of the counters, scaled if the counters were multiplexed; empty sample if group is unavailable.
+    */
+    perf_sample read() const noexcept;
+
+    /**
+     * @brief getter for the group of the calling thread.
+     * @returns reference to the group, opened on the first call of the thread.
+    */
+    static perf_counter_group& current() noexcept;
+
+};
+
+/**
+ * @class perf_phase_counters
+ * @brief counters accumulated over all executions of a phase, by any thread.
+*/
+class perf_phase_counters {
+private:
+    /// accumulated counter values, indexed by perf_counter.
+    std::atomic<uint64_t> values[PERF_COUNTER_COUNT]{};
+
+    /// bit mask of the counters that were read at least once.
+    std::atomic<uint32_t> available_mask{0};
+
+    /// number of objects processed by the phase.
+    std::atomic<uint64_t> objects{0};
+
+public:
+    /**
+     * @brief adds the counters of a single execution of the phase.
+     * @param delta - difference of the counters at the end and the start of the execution.
+     * @param processed_objects - number of objects processed by the execution.
+    */
+    void add(const perf_sample& delta, uint64_t processed_objects) noexcept;
+
+    /**
+     * @brief adds objects processed by the phase without counters.
+     * @param processed_objects - number of processed objects.
+    */
+    void add_objects(uint64_t processed_objects) noexcept;
+
+    /**
+     * @brief takes a snapshot of the accumulated counters.
+     * @returns accumulated counter values.
+    */
+    perf_sample load() const noexcept;
+
+    /**
+     * @brief getter for the number of processed objects.
+     * @returns number of objects processed by the phase.
+    */
+    uint64_t get_objects() const noexcept;
+
+};
+
+/**
+ * @class perf_scope
+ * @brief reads the counters of the calling thread on creation and adds the difference to the phase on destruction.
+ * @details unless built with GCSIM_PERF_COUNTERS the counters aren't read, only the processed objects are added to the phase.
+*/
+class perf_scope {
+private:
+    /// phase the counters are added to.
+    perf_phase_counters& phase;
+
+    /// counters at the start of the scope.
+    perf_sample start;
+
+    /// number of objects processed inside of the scope.
+    uint64_t processed_objects;
+
+public:
+    /**
+     * @brief reads the counters at the start of the scope.
+     * @param phase - reference to the counters of the phase.
+    */
+    explicit perf_scope(perf_phase_counters& phase) noexcept;
+
+    /**
+     * @brief adds the counters of the scope to the phase.
+    */
+    ~perf_scope();
+
+    /// deleted copy constructor.
+    perf_scope(const perf_scope&) = delete;
+
+    /// deleted assignment operator.
+    perf_scope& operator=(const perf_scope&) = delete;
+
+    /**
+     * @brief records objects processed inside of the scope.
+     * @param count - number of processed objects.
+    */
+    void add_objects(uint64_t count) noexcept;
+
+};
+
+#endif
\ No newline at end of file
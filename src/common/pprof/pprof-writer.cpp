@@ -0,0 +1,103 @@
+#include "pprof-writer.hpp"
+
+#include <fstream>
+
+pprof_writer::pprof_writer() : value_count(0), next_location_id(1) {
+    intern("");
+}
+
+uint64_t pprof_writer::intern(std::string_view value){
+    std::string key(value);
+    if(const uint64_t* id = string_ids.find(key)){
+        return *id;
+    }
+
+    const uint64_t id = strings.get_size();
+    strings.push(key);
+    string_ids.insert(std::move(key), id);
+    return id;
+}
+
+void pprof_writer::write_varint(std::string& out, uint64_t value){
+    while(value >= 0x80){
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void pprof_writer::write_varint_field(std::string& out, uint32_t field, uint64_t value){
+    write_varint(out, static_cast<uint64_t>(field) << 3);
+    write_varint(out, value);
+}
+
+void pprof_writer::write_bytes_field(std::string& out, uint32_t field, std::string_view bytes){
+    write_varint(out, (static_cast<uint64_t>(field) << 3) | 2);
+    write_varint(out, bytes.size());
+    out.append(bytes);
+}
+
+std::string pprof_writer::encode_value_type(std::string_view type, std::string_view unit){
+    std::string value_type;
+    write_varint_field(value_type, 1, intern(type));
+    write_varint_field(value_type, 2, intern(unit));
+    return value_type;
+}
+
+void pprof_writer::add_sample_type(std::string_view type, std::string_view unit){
+    write_bytes_field(encoded_sample_types, 1, encode_value_type(type, unit));
+    ++value_count;
+}
+
+void pprof_writer::set_period(std::string_view type, std::string_view unit, int64_t period){
+    encoded_period.clear();
+    write_bytes_field(encoded_period, 11, encode_value_type(type, unit));
+    write_varint_field(encoded_period, 12, static_cast<uint64_t>(period));
+}
+
+void pprof_writer::add_sample(std::string_view function, std::string_view file, uint32_t line, const int64_t* values){
+    const uint64_t id = next_location_id++;
+
+    std::string encoded_function;
+    write_varint_field(encoded_function, 1, id);
+    write_varint_field(encoded_function, 2, intern(function));
+    write_varint_field(encoded_function, 3, intern(function));
+    write_varint_field(encoded_function, 4, intern(file));
+    write_varint_field(encoded_function, 5, line);
+    write_bytes_field(encoded_locations, 5, encoded_function);
+
+    std::string encoded_line;
+    write_varint_field(encoded_line, 1, id);
+    write_varint_field(encoded_line, 2, line);
+
+    std::string encoded_location;
+    write_varint_field(encoded_location, 1, id);
+    write_bytes_field(encoded_location, 4, encoded_line);
+    write_bytes_field(encoded_locations, 4, encoded_location);
+
+    std::string packed_location;
+    write_varint(packed_location, id);
+
+    std::string packed_values;
+    for(size_t i = 0; i < value_count; ++i){
+        write_varint(packed_values, static_cast<uint64_t>(values[i]));
+    }
+
+    std::string encoded_sample;
+    write_bytes_field(encoded_sample, 1, packed_location);
+    write_bytes_field(encoded_sample, 2, packed_values);
+    write_bytes_field(encoded_samples, 2, encoded_sample);
+}
+
+bool pprof_writer::write(const std::string& path){
+    std::string profile = encoded_sample_types + encoded_samples + encoded_locations;
+    for(const std::string& value : strings){
+        write_bytes_field(profile, 6, value);
+    }
+    profile += encoded_period;
+
+    std::ofstream out(path, std::ios::binary);
+    if(!out) return false;
+    out.write(profile.data(), static_cast<std::streamsize>(profile.size()));
+    return static_cast<bool>(out);
+}
\ No newline at end of file
@@ -0,0 +1,132 @@
+#ifndef PPROF_WRITER_HPP
+#define PPROF_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "../hash-map/hash-map.hpp"
+#include "../indexed-stack/indexed-stack.hpp"
+
+/**
+ * @class pprof_writer
+ * @brief builds a profile in the pprof protobuf format (profile.proto), readable by go tool pprof.
+ * @details every sample gets its own single-frame location, the output is written uncompressed.
+*/
+class pprof_writer {
+private:
+    /// string table of the profile, first string is always empty.
+    indexed_stack<std::string> strings;
+
+    /// indices of the strings in the string table.
+    hash_map<std::string, uint64_t> string_ids;
+
+    /// encoded sample_type fields.
+    std::string encoded_sample_types;
+
+    /// encoded sample fields.
+    std::string encoded_samples;
+
+    /// encoded location and function fields.
+    std::string encoded_locations;
+
+    /// encoded period_type and period fields.
+    std::string encoded_period;
+
+    /// number of value types of each sample.
+    size_t value_count;
+
+    /// id of the next location and function.
+    uint64_t next_location_id;
+
+    /**
+     * @brief adds the string to the string table.
+     * @param value - string.
+     * @returns index of the string in the string table.
+    */
+    uint64_t intern(std::string_view value);
+
+    /**
+     * @brief encodes an unsigned integer as a protobuf varint.
+     * @param out - reference to the output buffer.
+     * @param value - encoded integer.
+    */
+    static void write_varint(std::string& out, uint64_t value);
+
+    /**
+     * @brief encodes a varint field.
+     * @param out - reference to the output buffer.
+     * @param field - number of the field.
+     * @param value - value of the field.
+    */
+    static void write_varint_field(std::string& out, uint32_t field, uint64_t value);
+
+    /**
+     * @brief encodes a length-delimited field.
+     * @param out - reference to the output buffer.
+     * @param field - number of the field.
+     * @param bytes - content of the field.
+    */
+    static void write_bytes_field(std::string& out, uint32_t field, std::string_view bytes);
+
+    /**
+     * @brief encodes a ValueType message.
+     * @param type - name of the value type.
+     * @param unit - unit of the value type.
+     * @returns encoded message.
+    */
+    std::string encode_value_type(std::string_view type, std::string_view unit);
+
+public:
+    /**
+     * @brief creates an empty profile.
+    */
+    pprof_writer();
+
+    /**
+     * @brief deletes the profile.
+    */
+    ~pprof_writer() = default;
+
+    /// deleted copy constructor.
+    pprof_writer(const pprof_writer&) = delete;
+
+    /// deleted assignment operator.
+    pprof_writer& operator=(const pprof_writer&) = delete;
+
+    /**
+     * @brief adds the value type, samples hold one value per added type.
+     * @param type - name of the value type, e.g. "alloc_space".
+     * @param unit - unit of the value type, e.g. "bytes".
+     * @warning must be called before any sample is added.
+    */
+    void add_sample_type(std::string_view type, std::string_view unit);
+
+    /**
+     * @brief sets the sampling period of the profile.
+     * @param type - name of the period type.
+     * @param unit - unit of the period.
+     * @param period - sampling period.
+    */
+    void set_period(std::string_view type, std::string_view unit, int64_t period);
+
+    /**
+     * @brief adds the sample with a single frame.
+     * @param function - name of the function of the frame.
+     * @param file - source file of the frame.
+     * @param line - line of the frame.
+     * @param values - pointer to the values, one per sample type.
+    */
+    void add_sample(std::string_view function, std::string_view file, uint32_t line, const int64_t* values);
+
+    /**
+     * @brief writes the profile.
+     * @param path - path of the output file.
+     * @returns true if the profile was written, false otherwise.
+    */
+    bool write(const std::string& path);
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "profiled-mutex.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+lock_profile profiled_mutex::profiles[MAX_PROFILED_LOCKS];
+
+std::atomic<size_t> profiled_mutex::profile_count{0};
+
+uint64_t profiled_mutex::clock_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+profiled_mutex::profiled_mutex(const char* name, size_t index) noexcept : profile(nullptr), hold_start_ns(0) {
+    if constexpr (LOCK_PROFILING_ENABLED){
+        profile = register_profile(name, index);
+    }
+}
+
+lock_profile* profiled_mutex::register_profile(const char* name, size_t index) noexcept {
+    const size_t id = profile_count.fetch_add(1, std::memory_order_relaxed);
+    if(id >= MAX_PROFILED_LOCKS) return nullptr;
+
+    lock_profile* new_profile = &profiles[id];
+    new_profile->name.store(name, std::memory_order_relaxed);
+    new_profile->index.store(index, std::memory_order_relaxed);
+    return new_profile;
+}
+
+void profiled_mutex::set_name(const char* name, size_t index) noexcept {
+    if(!profile) return;
+    profile->name.store(name, std::memory_order_relaxed);
+    profile->index.store(index, std::memory_order_relaxed);
+}
+
+void profiled_mutex::lock_profiled() {
+    if(!profile){
+        mtx.lock();
+        return;
+    }
+
+    if(!mtx.try_lock()){
+        const uint64_t wait_start_ns = clock_ns();
+        mtx.lock();
+        profile->contended_acquisitions.fetch_add(1, std::memory_order_relaxed);
+        profile->wait_ns.fetch_add(clock_ns() - wait_start_ns, std::memory_order_relaxed);
+    }
+    profile->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    hold_start_ns = clock_ns();
+}
+
+bool profiled_mutex::try_lock_profiled() noexcept {
+    if(!profile) return mtx.try_lock();
+
+    profile->try_lock_attempts.fetch_add(1, std::memory_order_relaxed);
+    if(!mtx.try_lock()){
+        profile->try_lock_failures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    profile->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    hold_start_ns = clock_ns();
+    return true;
+}
+
+void profiled_mutex::unlock_profiled() noexcept {
+    if(profile){
+        const uint64_t hold_ns = clock_ns() - hold_start_ns;
+        uint64_t current_max = profile->max_hold_ns.load(std::memory_order_relaxed);
+        while(hold_ns > current_max && !profile->max_hold_ns.compare_exchange_weak(current_max, hold_ns, std::memory_order_relaxed));
+    }
+    mtx.unlock();
+}
+
+indexed_stack<lock_profile_stats> profiled_mutex::snapshot(){
+    indexed_stack<lock_profile_stats> stats;
+    const size_t count = std::min(profile_count.load(std::memory_order_acquire), MAX_PROFILED_LOCKS);
+
+    for(size_t i = 0; i < count; ++i){
+        const lock_profile& lock = profiles[i];
+        lock_profile_stats lock_stats{
+            .name = lock.name.load(std::memory_order_relaxed),
+            .index = lock.index.load(std::memory_order_relaxed),
+            .id = i,
+            .acquisitions = lock.acquisitions.load(std::memory_order_relaxed),
+            .contended_acquisitions = lock.contended_acquisitions.load(std::memory_order_relaxed),
+            .wait_ns = lock.wait_ns.load(std::memory_order_relaxed),
+            .max_hold_ns = lock.max_hold_ns.load(std::memory_order_relaxed),
+            .try_lock_attempts = lock.try_lock_attempts.load(std::memory_order_relaxed),
+            .try_lock_failures = lock.try_lock_failures.load(std::memory_order_relaxed)
+        };
+        if(lock_stats.acquisitions != 0 || lock_stats.try_lock_attempts != 0){
+            stats.push(lock_stats);
+        }
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const lock_profile_stats& a, const lock_profile_stats& b) -> bool {
+        if(a.wait_ns != b.wait_ns) return a.wait_ns > b.wait_ns;
+        return a.try_lock_failures > b.try_lock_failures;
+    });
+
+    return stats;
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#ifndef PROFILED_MUTEX_HPP
+#define PROFILED_MUTEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <concepts>
+#include <type_traits>
+
+#include "../indexed-stack/indexed-stack.hpp"
+
+#ifdef GCSIM_LOCK_PROFILING
+/// lock profiling is enabled with -DGCSIM_LOCK_PROFILING.
+constexpr bool LOCK_PROFILING_ENABLED = true;
+#else
+/// lock profiling is enabled with -DGCSIM_LOCK_PROFILING.
+constexpr bool LOCK_PROFILING_ENABLED = false;
+#endif
+
+/// maximum number of profiled lock instances, later instances aren't profiled.
+constexpr size_t MAX_PROFILED_LOCKS = 4096;
+
+/// index of the lock that isn't part of an array.
+constexpr size_t NO_LOCK_INDEX = SIZE_MAX;
+
+/**
+ * @struct lock_profile
+ * @brief counters of a single lock instance, outlive the lock.
+*/
+struct lock_profile {
+    /// name of the lock, must be a string literal.
+    std::atomic<const char*> name{"unnamed"};
+
+    /// index of the lock inside of its array, NO_LOCK_INDEX if lock isn't part of an array.
+    std::atomic<size_t> index{NO_LOCK_INDEX};
+
+    /// number of successful acquisitions, including try_lock.
+    std::atomic<uint64_t> acquisitions{0};
+
+    /// number of lock calls that had to wait for the owner.
+    std::atomic<uint64_t> contended_acquisitions{0};
+
+    /// total time spent waiting in lock calls, in nanoseconds.
+    std::atomic<uint64_t> wait_ns{0};
+
+    /// longest time the lock was held, in nanoseconds.
+    std::atomic<uint64_t> max_hold_ns{0};
+
+    /// number of try_lock calls.
+    std::atomic<uint64_t> try_lock_attempts{0};
+
+    /// number of try_lock calls that failed.
+    std::atomic<uint64_t> try_lock_failures{0};
+};
+
+/**
+ * @struct lock_profile_stats
+ * @brief snapshot of the counters of a single lock instance.
+*/
+struct lock_profile_stats {
+    /// name of the lock.
+    const char* name;
+
+    /// index of the lock inside of its array, NO_LOCK_INDEX if lock isn't part of an array.
+    size_t index;
+
+    /// order in which the lock was created.
+    size_t id;
+
+    /// number of successful acquisitions, including try_lock.
+    uint64_t acquisitions;
+
+    /// number of lock calls that had to wait for the owner.
+    uint64_t contended_acquisitions;
+
+    /// total time spent waiting in lock calls, in nanoseconds.
+    uint64_t wait_ns;
+
+    /// longest time the lock was held, in nanoseconds.
+    uint64_t max_hold_ns;
+
+    /// number of try_lock calls.
+    uint64_t try_lock_attempts;
+
+    /// number of try_lock calls that failed.
+    uint64_t try_lock_failures;
+
+    /**
+     * @brief calculates the fraction of lock calls that had to wait.
+     * @returns contention rate in range [0, 1].
+    */
+    double contention_rate() const noexcept {
+        const uint64_t lock_calls = acquisitions - (try_lock_attempts - try_lock_failures);
+        return lock_calls ? static_cast<double>(contended_acquisitions) / static_cast<double>(lock_calls) : 0.0;
+    }
+
+    /**
+     * @brief calculates the fraction of try_lock calls that failed.
+     * @returns failure rate in range [0, 1].
+    */
+    double try_lock_failure_rate() const noexcept {
+        return try_lock_attempts ? static_cast<double>(try_lock_failures) / static_cast<double>(try_lock_attempts) : 0.0;
+    }
+};
+
+/**
+ * @class profiled_mutex
+ * @brief std::mutex that records acquisitions, contention, wait time and hold time when lock profiling is enabled.
+ * @details counters are kept in a static registry, so they are reported even after the lock is destroyed.
+ * Without GCSIM_LOCK_PROFILING every call forwards to std::mutex.
+*/
+class profiled_mutex {
+private:
+    /// underlying mutex.
+    std::mutex mtx;
+
+    /// counters of the lock, nullptr if profiling is disabled or registry is full.
+    lock_profile* profile;
+
+    /// time the current owner acquired the lock, written only by the owner.
+    uint64_t hold_start_ns;
+
+    /// counters of every profiled lock, indexed by creation order.
+    static lock_profile profiles[MAX_PROFILED_LOCKS];
+
+    /// number of created profiled locks.
+    static std::atomic<size_t> profile_count;
+
+    /**
+     * @brief reserves the counters of a new lock.
+     * @param name - name of the lock.
+     * @param index - index of the lock inside of its array.
+     * @returns pointer to the counters, nullptr if registry is full.
+    */
+    static lock_profile* register_profile(const char* name, size_t index) noexcept;
+
+    /**
+     * @brief getter for the current time of the steady clock.
+     * @returns nanoseconds since the epoch of the steady clock.
+    */
+    static uint64_t clock_ns() noexcept;
+
+    /**
+     * @brief acquires the lock, recording contention and wait time.
+    */
+    void lock_profiled();
+
+    /**
+     * @brief tries to acquire the lock, recording the failure.
+     * @returns true if lock was acquired, false otherwise.
+    */
+    bool try_lock_profiled() noexcept;
+
+    /**
+     * @brief releases the lock, recording the hold time.
+    */
+    void unlock_profiled() noexcept;
+
+public:
+    /**
+     * @brief creates the lock.
+     * @param name - name of the lock, must be a string literal; defaults to "unnamed".
+     * @param index - index of the lock inside of its array, defaults to NO_LOCK_INDEX.
+    */
+    explicit profiled_mutex(const char* name = "unnamed", size_t index = NO_LOCK_INDEX) noexcept;
+
+    /**
+     * @brief deletes the lock, its counters are kept.
+    */
+    ~profiled_mutex() = default;
+
+    /// deleted copy constructor.
+    profiled_mutex(const profiled_mutex&) = delete;
+
+    /// deleted assignment operator.
+    profiled_mutex& operator=(const profiled_mutex&) = delete;
+
+    /**
+     * @brief renames the lock, used for locks created in arrays.
+     * @param name - name of the lock, must be a string literal.
+     * @param index - index of the lock inside of its array, defaults to NO_LOCK_INDEX.
+    */
+    void set_name(const char* name, size_t index = NO_LOCK_INDEX) noexcept;
+
+    /**
+     * @brief acquires the lock.
+    */
+    void lock() {
+        if constexpr (LOCK_PROFILING_ENABLED){
+            lock_profiled();
+        }
+        else {
+            mtx.lock();
+        }
+    }
+
+    /**
+     * @brief tries to acquire the lock without blocking.
+     * @returns true if lock was acquired, false otherwise.
+    */
+    bool try_lock() noexcept {
+        if constexpr (LOCK_PROFILING_ENABLED){
+            return try_lock_profiled();
+        }
+        else {
+            return mtx.try_lock();
+        }
+    }
+
+    /**
+     * @brief releases the lock.
+    */
+    void unlock() noexcept {
+        if constexpr (LOCK_PROFILING_ENABLED){
+            unlock_profiled();
+        }
+        else {
+            mtx.unlock();
+        }
+    }
+
+    /**
+     * @brief takes a snapshot of the counters of every lock that was acquired or tried.
+     * @returns counters ranked by total wait time, then by try_lock failures.
+    */
+    static indexed_stack<lock_profile_stats> snapshot();
+
+};
+
+/// mutex that can be waited on with pool_condition, profiled_mutex only if lock profiling is enabled.
+using pool_mutex = std::conditional_t<LOCK_PROFILING_ENABLED, profiled_mutex, std::mutex>;
+
+/// condition variable that works with pool_mutex.
+using pool_condition = std::conditional_t<LOCK_PROFILING_ENABLED, std::condition_variable_any, std::condition_variable>;
+
+/**
+ * @brief names the lock if it is profiled.
+ * @param mutex - reference to the lock.
+ * @param name - name of the lock, must be a string literal.
+ * @param index - index of the lock inside of its array, defaults to NO_LOCK_INDEX.
+*/
+template<typename Mutex>
+void set_lock_name(Mutex& mutex, const char* name, size_t index = NO_LOCK_INDEX) noexcept {
+    if constexpr (std::same_as<Mutex, profiled_mutex>){
+        mutex.set_name(name, index);
+    }
+    else {
+        (void)mutex;
+        (void)name;
+        (void)index;
+    }
+}
+
+#endif
\ No newline at end of file
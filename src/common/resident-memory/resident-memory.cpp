@@ -0,0 +1,42 @@
+#include "resident-memory.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <string>
+
+#include <sys/resource.h>
+
+uint64_t resident_memory::read_status_field(std::string_view field){
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)){
+        if(!line.starts_with(field)) continue;
+
+        const size_t digits = line.find_first_of("0123456789", field.size());
+        if(digits == std::string::npos) return 0;
+        uint64_t kilobytes = 0;
+        std::from_chars(line.data() + digits, line.data() + line.size(), kilobytes);
+        return kilobytes * 1024;
+    }
+    return 0;
+}
+
+uint64_t resident_memory::current_bytes(){
+    return read_status_field("VmRSS:");
+}
+
+uint64_t resident_memory::peak_bytes(){
+    const uint64_t peak = read_status_field("VmHWM:");
+    if(peak != 0) return peak;
+
+    struct rusage usage{};
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? static_cast<uint64_t>(usage.ru_maxrss) * 1024 : 0;
+}
+
+bool resident_memory::reset_peak() noexcept {
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    if(!clear_refs) return false;
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+}
\ No newline at end of file
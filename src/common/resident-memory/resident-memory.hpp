@@ -0,0 +1,42 @@
+#ifndef RESIDENT_MEMORY_HPP
+#define RESIDENT_MEMORY_HPP
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @class resident_memory
+ * @brief reads the resident set size of the process from /proc/self/status.
+ * @details peak is the kernel's high-water mark, it can be reset on Linux 4.0+ so each run measures its own peak.
+*/
+class resident_memory {
+private:
+    /**
+     * @brief reads a size field of /proc/self/status.
+     * @param field - name of the field including the colon, e.g. "VmRSS:".
+     * @returns value of the field in bytes, 0 if it can't be read.
+    */
+    static uint64_t read_status_field(std::string_view field);
+
+public:
+    /**
+     * @brief getter for the current resident set size.
+     * @returns resident bytes, 0 if they can't be read.
+    */
+    static uint64_t current_bytes();
+
+    /**
+     * @brief getter for the peak resident set size since the start or the last reset.
+     * @returns peak resident bytes, falls back to getrusage if /proc isn't available.
+    */
+    static uint64_t peak_bytes();
+
+    /**
+     * @brief resets the peak resident set size to the current one.
+     * @returns true if the peak was reset, false if the kernel doesn't support it.
+    */
+    static bool reset_peak() noexcept;
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,432 @@
+#include "results-document.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <format>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#include "../latency-histogram/latency-histogram.hpp"
+#include "../profiled-mutex/profiled-mutex.hpp"
+#include "../perf-counters/perf-counters.hpp"
+#include "../trace/trace.hpp"
+
+results_document::results_document(std::string tool) : tool(std::move(tool)), revision(git_revision()) {}
+
+std::string results_document::git_revision(){
+    if(const char* env_revision = std::getenv("GCSIM_GIT_REVISION"); env_revision != nullptr && *env_revision != '\0'){
+        return env_revision;
+    }
+
+    FILE* pipe = popen("git rev-parse HEAD 2>/dev/null", "r");
+    if(pipe == nullptr) return "unknown";
+    char buffer[64] = {};
+    const bool read = std::fgets(buffer, sizeof(buffer), pipe) != nullptr;
+    const int status = pclose(pipe);
+
+    std::string hash = read ? buffer : "";
+    while(!hash.empty() && (hash.back() == '\n' || hash.back() == '\r')) hash.pop_back();
+    return status != 0 || hash.empty() ? "unknown" : hash;
+}
+
+std::string results_document::environment_json(){
+    char hostname[256] = {};
+    if(gethostname(hostname, sizeof(hostname) - 1) != 0) hostname[0] = '\0';
+
+    struct utsname system_name{};
+    const bool has_uname = uname(&system_name) == 0;
+
+#ifdef __OPTIMIZE__
+    constexpr bool optimized = true;
+#else
+    constexpr bool optimized = false;
+#endif
+#ifdef NDEBUG
+    constexpr bool assertions = false;
+#else
+    constexpr bool assertions = true;
+#endif
+
+    return std::format("{{\"hostname\": {}, \"os\": {}, \"kernel\": {}, \"arch\": {}, \"hardware_threads\": {}, \"compiler\": {}, "
+        "\"optimized\": {}, \"assertions\": {}, \"latency_histograms\": {}, \"tracing\": {}, \"lock_profiling\": {}, \"perf_counters\": {}}}",
+        escape(hostname), escape(has_uname ? system_name.sysname : ""), escape(has_uname ? system_name.release : ""),
+        escape(has_uname ? system_name.machine : ""), std::thread::hardware_concurrency(), escape(__VERSION__),
+        optimized, assertions, LATENCY_HISTOGRAMS_ENABLED, TRACING_ENABLED, LOCK_PROFILING_ENABLED, PERF_COUNTERS_ENABLED
+    );
+}
+
+std::string results_document::escape(std::string_view text){
+    std::string escaped = "\"";
+    for(char c : text){
+        switch(c){
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20) escaped += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+                else escaped += c;
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+std::string results_document::format_number(double value){
+    return std::isfinite(value) ? std::format("{}", value) : "null";
+}
+
+void results_document::set_config(std::string_view description){
+    config = indexed_stack<std::pair<std::string, std::string>>();
+    while(!description.empty()){
+        const size_t line_end = std::min(description.find('\n'), description.size());
+        const std::string_view line = description.substr(0, line_end);
+        description.remove_prefix(std::min(line_end + 1, description.size()));
+
+        const size_t separator = line.find('=');
+        if(separator == std::string_view::npos) continue;
+        config.push(std::pair<std::string, std::string>(line.substr(0, separator), line.substr(separator + 1)));
+    }
+}
+
+void results_document::add_metric(std::string name, std::string unit, metric_goal goal, indexed_stack<double>&& samples){
+    result_metric metric{
+        .name = std::move(name),
+        .unit = std::move(unit),
+        .goal = goal,
+        .samples = std::move(samples),
+        .median = 0,
+        .mean = 0,
+        .ci_low = 0,
+        .ci_high = 0
+    };
+    summarize(metric);
+    metrics.push(std::move(metric));
+}
+
+const indexed_stack<result_metric>& results_document::get_metrics() const noexcept {
+    return metrics;
+}
+
+const result_metric* results_document::find_metric(std::string_view name) const noexcept {
+    for(const result_metric& metric : metrics){
+        if(metric.name == name) return &metric;
+    }
+    return nullptr;
+}
+
+const std::string& results_document::get_tool() const noexcept {
+    return tool;
+}
+
+const std::string& results_document::get_revision() const noexcept {
+    return revision;
+}
+
+double results_document::median_of_sorted(const indexed_stack<double>& sorted) noexcept {
+    const size_t count = sorted.get_size();
+    if(count == 0) return 0;
+    return count % 2 ? sorted[count / 2] : (sorted[count / 2 - 1] + sorted[count / 2]) / 2.0;
+}
+
+void results_document::summarize(result_metric& metric){
+    const size_t count = metric.samples.get_size();
+    if(count == 0){
+        metric.median = metric.mean = metric.ci_low = metric.ci_high = 0;
+        return;
+    }
+
+    indexed_stack<double> sorted;
+    double sum = 0;
+    for(double sample : metric.samples){
+        sorted.push(sample);
+        sum += sample;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    metric.median = median_of_sorted(sorted);
+    metric.mean = sum / static_cast<double>(count);
+
+    std::mt19937 rng(BOOTSTRAP_SEED);
+    std::uniform_int_distribution<size_t> index_dist(0, count - 1);
+    indexed_stack<double> medians;
+    indexed_stack<double> resample;
+    for(size_t i = 0; i < count; ++i) resample.push(0.0);
+    for(size_t r = 0; r < BOOTSTRAP_RESAMPLES; ++r){
+        for(double& value : resample){
+            value = sorted[index_dist(rng)];
+        }
+        std::sort(resample.begin(), resample.end());
+        medians.push(median_of_sorted(resample));
+    }
+    std::sort(medians.begin(), medians.end());
+
+    const double tail = (1.0 - CONFIDENCE_LEVEL) / 2;
+    metric.ci_low = medians[static_cast<size_t>(tail * static_cast<double>(BOOTSTRAP_RESAMPLES - 1))];
+    metric.ci_high = medians[static_cast<size_t>((1.0 - tail) * static_cast<double>(BOOTSTRAP_RESAMPLES - 1))];
+}
+
+const char* results_document::metric_goal_name(metric_goal goal) noexcept {
+    switch(goal){
+        case metric_goal::lower: return "lower";
+        case metric_goal::higher: return "higher";
+    }
+    return "lower";
+}
+
+bool results_document::write(const std::string& path) const {
+    std::ofstream out(path);
+    if(!out) return false;
+
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+    char timestamp[32] = {};
+    if(gmtime_r(&now, &utc) != nullptr) std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    out << "{\n";
+    out << std::format("  \"format_version\": {},\n", RESULTS_FORMAT_VERSION);
+    out << std::format("  \"tool\": {},\n", escape(tool));
+    out << std::format("  \"git_revision\": {},\n", escape(revision));
+    out << std::format("  \"timestamp\": {},\n", escape(timestamp));
+    out << std::format("  \"environment\": {},\n", environment_json());
+
+    out << "  \"config\": {";
+    for(size_t i = 0; i < config.get_size(); ++i){
+        out << std::format("{}\n    {}: {}", i == 0 ? "" : ",", escape(config[i].first), escape(config[i].second));
+    }
+    out << (config.empty() ? "},\n" : "\n  },\n");
+
+    out << "  \"metrics\": [";
+    for(size_t i = 0; i < metrics.get_size(); ++i){
+        const result_metric& metric = metrics[i];
+        std::string samples;
+        for(size_t j = 0; j < metric.samples.get_size(); ++j){
+            samples += std::format("{}{}", j == 0 ? "" : ", ", format_number(metric.samples[j]));
+        }
+        out << std::format("{}\n    {{\"name\": {}, \"unit\": {}, \"better\": \"{}\", \"count\": {}, \"median\": {}, \"mean\": {}, "
+            "\"ci_low\": {}, \"ci_high\": {}, \"confidence\": {}, \"samples\": [{}]}}",
+            i == 0 ? "" : ",", escape(metric.name), escape(metric.unit), metric_goal_name(metric.goal), metric.samples.get_size(),
+            format_number(metric.median), format_number(metric.mean), format_number(metric.ci_low), format_number(metric.ci_high),
+            CONFIDENCE_LEVEL, samples
+        );
+    }
+    out << (metrics.empty() ? "]\n" : "\n  ]\n");
+    out << "}\n";
+    return static_cast<bool>(out);
+}
+
+void results_document::skip_whitespace(std::string_view text, size_t& pos) noexcept {
+    while(pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) ++pos;
+}
+
+void results_document::expect(std::string_view text, size_t& pos, char expected){
+    skip_whitespace(text, pos);
+    if(pos >= text.size() || text[pos] != expected){
+        throw std::invalid_argument(std::format("Expected '{}' at offset {}", expected, pos));
+    }
+    ++pos;
+}
+
+std::string results_document::parse_string(std::string_view text, size_t& pos){
+    expect(text, pos, '"');
+    std::string value;
+    while(pos < text.size() && text[pos] != '"'){
+        char c = text[pos++];
+        if(c == '\\'){
+            if(pos >= text.size()) break;
+            c = text[pos++];
+            switch(c){
+                case 'n': value += '\n'; break;
+                case 'r': value += '\r'; break;
+                case 't': value += '\t'; break;
+                case 'b': value += '\b'; break;
+                case 'f': value += '\f'; break;
+                case 'u': {
+                    unsigned code = 0;
+                    if(pos + 4 > text.size() || std::from_chars(text.data() + pos, text.data() + pos + 4, code, 16).ptr != text.data() + pos + 4){
+                        throw std::invalid_argument(std::format("Invalid escape at offset {}", pos));
+                    }
+                    pos += 4;
+                    value += code < 0x80 ? static_cast<char>(code) : '?';
+                    break;
+                }
+                default: value += c;
+            }
+        }
+        else {
+            value += c;
+        }
+    }
+    expect(text, pos, '"');
+    return value;
+}
+
+double results_document::parse_number(std::string_view text, size_t& pos){
+    skip_whitespace(text, pos);
+    if(text.substr(pos, 4) == "null"){
+        pos += 4;
+        return std::nan("");
+    }
+
+    double value = 0;
+    const auto [end, error] = std::from_chars(text.data() + pos, text.data() + text.size(), value);
+    if(error != std::errc()){
+        throw std::invalid_argument(std::format("Invalid number at offset {}", pos));
+    }
+    pos = static_cast<size_t>(end - text.data());
+    return value;
+}
+
+template<typename key_fn>
+void results_document::parse_object(std::string_view text, size_t& pos, key_fn&& on_key){
+    expect(text, pos, '{');
+    skip_whitespace(text, pos);
+    if(pos < text.size() && text[pos] == '}'){
+        ++pos;
+        return;
+    }
+
+    while(true){
+        const std::string key = parse_string(text, pos);
+        expect(text, pos, ':');
+        skip_whitespace(text, pos);
+        on_key(key);
+        skip_whitespace(text, pos);
+        if(pos < text.size() && text[pos] == ','){
+            ++pos;
+            continue;
+        }
+        expect(text, pos, '}');
+        return;
+    }
+}
+
+template<typename element_fn>
+void results_document::parse_array(std::string_view text, size_t& pos, element_fn&& on_element){
+    expect(text, pos, '[');
+    skip_whitespace(text, pos);
+    if(pos < text.size() && text[pos] == ']'){
+        ++pos;
+        return;
+    }
+
+    while(true){
+        skip_whitespace(text, pos);
+        on_element();
+        skip_whitespace(text, pos);
+        if(pos < text.size() && text[pos] == ','){
+            ++pos;
+            continue;
+        }
+        expect(text, pos, ']');
+        return;
+    }
+}
+
+void results_document::skip_value(std::string_view text, size_t& pos){
+    skip_whitespace(text, pos);
+    if(pos >= text.size()){
+        throw std::invalid_argument("Unexpected end of document");
+    }
+
+    switch(text[pos]){
+        case '{': parse_object(text, pos, [&text, &pos](const std::string&) -> void { skip_value(text, pos); }); break;
+        case '[': parse_array(text, pos, [&text, &pos] -> void { skip_value(text, pos); }); break;
+        case '"': parse_string(text, pos); break;
+        case 't':
+        case 'f': {
+            const std::string_view literal = text[pos] == 't' ? "true" : "false";
+            if(text.substr(pos, literal.size()) != literal){
+                throw std::invalid_argument(std::format("Invalid literal at offset {}", pos));
+            }
+            pos += literal.size();
+            break;
+        }
+        default: parse_number(text, pos);
+    }
+}
+
+result_metric results_document::parse_metric(std::string_view text, size_t& pos){
+    result_metric metric{
+        .name = "",
+        .unit = "",
+        .goal = metric_goal::lower,
+        .samples = indexed_stack<double>(),
+        .median = 0,
+        .mean = 0,
+        .ci_low = 0,
+        .ci_high = 0
+    };
+
+    parse_object(text, pos, [&text, &pos, &metric](const std::string& key) -> void {
+        if(key == "name") metric.name = parse_string(text, pos);
+        else if(key == "unit") metric.unit = parse_string(text, pos);
+        else if(key == "better"){
+            const std::string goal = parse_string(text, pos);
+            if(goal == "lower") metric.goal = metric_goal::lower;
+            else if(goal == "higher") metric.goal = metric_goal::higher;
+            else throw std::invalid_argument(std::format("Invalid goal '{}' of metric {}", goal, metric.name));
+        }
+        else if(key == "samples"){
+            parse_array(text, pos, [&text, &pos, &metric] -> void {
+                const double sample = parse_number(text, pos);
+                if(std::isfinite(sample)) metric.samples.push(sample);
+            });
+        }
+        else skip_value(text, pos);
+    });
+
+    if(metric.name.empty()){
+        throw std::invalid_argument("Metric without a name");
+    }
+    summarize(metric);
+    return metric;
+}
+
+bool results_document::load(const std::string& path){
+    std::ifstream in(path);
+    if(!in) return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    tool.clear();
+    revision = "unknown";
+    config = indexed_stack<std::pair<std::string, std::string>>();
+    metrics = indexed_stack<result_metric>();
+
+    try {
+        size_t pos = 0;
+        bool has_metrics = false;
+        parse_object(text, pos, [this, &text, &pos, &has_metrics](const std::string& key) -> void {
+            if(key == "tool") tool = parse_string(text, pos);
+            else if(key == "git_revision") revision = parse_string(text, pos);
+            else if(key == "config"){
+                parse_object(text, pos, [this, &text, &pos](const std::string& config_key) -> void {
+                    config.push(std::pair<std::string, std::string>(config_key, parse_string(text, pos)));
+                });
+            }
+            else if(key == "metrics"){
+                has_metrics = true;
+                parse_array(text, pos, [this, &text, &pos] -> void {
+                    metrics.push(parse_metric(text, pos));
+                });
+            }
+            else skip_value(text, pos);
+        });
+        return has_metrics;
+    }
+    catch(const std::invalid_argument&){
+        metrics = indexed_stack<result_metric>();
+        return false;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,272 @@
+#ifndef RESULTS_DOCUMENT_HPP
+#define RESULTS_DOCUMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "../indexed-stack/indexed-stack.hpp"
+
+/// version of the results document format, bumped on incompatible changes.
+constexpr uint32_t RESULTS_FORMAT_VERSION = 1;
+
+/// number of resamples of the bootstrapped confidence intervals.
+constexpr size_t BOOTSTRAP_RESAMPLES = 2000;
+
+/// confidence level of the intervals.
+constexpr double CONFIDENCE_LEVEL = 0.95;
+
+/// seed of the bootstrap, fixed so the same samples always produce the same interval.
+constexpr uint32_t BOOTSTRAP_SEED = 0x9e3779b9;
+
+/**
+ * @enum metric_goal
+ * @brief direction in which a metric improves.
+*/
+enum class metric_goal {
+    lower,
+    higher
+};
+
+/**
+ * @struct result_metric
+ * @brief samples of a single metric with their summary.
+*/
+struct result_metric {
+    /// unique name of the metric, '/' separates the levels.
+    std::string name;
+
+    /// unit of the samples.
+    std::string unit;
+
+    /// direction in which the metric improves.
+    metric_goal goal;
+
+    /// raw samples, one per run or event.
+    indexed_stack<double> samples;
+
+    /// median of the samples.
+    double median;
+
+    /// mean of the samples.
+    double mean;
+
+    /// lower bound of the bootstrapped confidence interval of the median.
+    double ci_low;
+
+    /// upper bound of the bootstrapped confidence interval of the median.
+    double ci_high;
+};
+
+/**
+ * @class results_document
+ * @brief machine-readable results of a run: config, environment, git revision and metrics, stored as JSON.
+*/
+class results_document {
+private:
+    /// name of the program that produced the results.
+    std::string tool;
+
+    /// git revision of the source tree, "unknown" if it can't be determined.
+    std::string revision;
+
+    /// parameters of the run as key, value pairs.
+    indexed_stack<std::pair<std::string, std::string>> config;
+
+    /// metrics in the order they were added.
+    indexed_stack<result_metric> metrics;
+
+    /**
+     * @brief determines the git revision, GCSIM_GIT_REVISION overrides git rev-parse.
+     * @returns revision hash, "unknown" if it can't be determined.
+    */
+    static std::string git_revision();
+
+    /**
+     * @brief describes the machine and the build.
+     * @returns JSON object of the environment.
+    */
+    static std::string environment_json();
+
+    /**
+     * @brief escapes the text as a JSON string.
+     * @param text - text being escaped.
+     * @returns quoted JSON string.
+    */
+    static std::string escape(std::string_view text);
+
+    /**
+     * @brief formats the value as a JSON number.
+     * @param value - value being formatted.
+     * @returns shortest representation that round-trips, null if value isn't finite.
+    */
+    static std::string format_number(double value);
+
+    /**
+     * @brief skips whitespace of the JSON text.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text.
+    */
+    static void skip_whitespace(std::string_view text, size_t& pos) noexcept;
+
+    /**
+     * @brief consumes the expected character after optional whitespace.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text.
+     * @param expected - expected character.
+     * @throws std::invalid_argument when the character doesn't match.
+    */
+    static void expect(std::string_view text, size_t& pos, char expected);
+
+    /**
+     * @brief parses a JSON string.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the string.
+     * @returns unescaped string.
+     * @throws std::invalid_argument when the string is malformed.
+    */
+    static std::string parse_string(std::string_view text, size_t& pos);
+
+    /**
+     * @brief parses a JSON number, null is parsed as NaN.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the number.
+     * @returns parsed number.
+     * @throws std::invalid_argument when the number is malformed.
+    */
+    static double parse_number(std::string_view text, size_t& pos);
+
+    /**
+     * @brief skips any JSON value.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the value.
+     * @throws std::invalid_argument when the value is malformed.
+    */
+    static void skip_value(std::string_view text, size_t& pos);
+
+    /**
+     * @brief calls the handler for every key of a JSON object.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the object.
+     * @param on_key - handler called with the key while pos is at its value, must consume the value.
+     * @throws std::invalid_argument when the object is malformed.
+    */
+    template<typename key_fn>
+    static void parse_object(std::string_view text, size_t& pos, key_fn&& on_key);
+
+    /**
+     * @brief calls the handler for every element of a JSON array.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the array.
+     * @param on_element - handler called while pos is at the element, must consume it.
+     * @throws std::invalid_argument when the array is malformed.
+    */
+    template<typename element_fn>
+    static void parse_array(std::string_view text, size_t& pos, element_fn&& on_element);
+
+    /**
+     * @brief parses a metric object.
+     * @param text - JSON text.
+     * @param pos - reference to the position in the text, moved past the metric.
+     * @returns parsed metric, summarized from its samples.
+     * @throws std::invalid_argument when the metric is malformed.
+    */
+    static result_metric parse_metric(std::string_view text, size_t& pos);
+
+public:
+    /**
+     * @brief creates an empty document.
+     * @param tool - name of the program that produces the results.
+    */
+    explicit results_document(std::string tool = "");
+
+    /**
+     * @brief deletes the document.
+    */
+    ~results_document() = default;
+
+    /// deleted copy constructor.
+    results_document(const results_document&) = delete;
+
+    /// deleted assignment operator.
+    results_document& operator=(const results_document&) = delete;
+
+    /**
+     * @brief stores the parameters of the run.
+     * @param description - key=value lines, as produced by workload_config::describe.
+    */
+    void set_config(std::string_view description);
+
+    /**
+     * @brief adds a metric and summarizes its samples.
+     * @param name - unique name of the metric.
+     * @param unit - unit of the samples.
+     * @param goal - direction in which the metric improves.
+     * @param samples - rvalue of the raw samples.
+    */
+    void add_metric(std::string name, std::string unit, metric_goal goal, indexed_stack<double>&& samples);
+
+    /**
+     * @brief getter for the metrics.
+     * @returns const reference to the metrics in the order they were added.
+    */
+    const indexed_stack<result_metric>& get_metrics() const noexcept;
+
+    /**
+     * @brief finds the metric by its name.
+     * @param name - name of the metric.
+     * @returns const pointer to the metric, nullptr if there is none.
+    */
+    const result_metric* find_metric(std::string_view name) const noexcept;
+
+    /**
+     * @brief getter for the name of the program that produced the results.
+     * @returns const reference to the name.
+    */
+    const std::string& get_tool() const noexcept;
+
+    /**
+     * @brief getter for the git revision of the results.
+     * @returns const reference to the revision.
+    */
+    const std::string& get_revision() const noexcept;
+
+    /**
+     * @brief writes the document as JSON.
+     * @param path - path of the file.
+     * @returns true if the file was written, false otherwise.
+    */
+    bool write(const std::string& path) const;
+
+    /**
+     * @brief reads the tool, revision and metrics of a document written by write.
+     * @param path - path of the file.
+     * @returns true if the file was read, false if it can't be opened or isn't a results document.
+    */
+    bool load(const std::string& path);
+
+    /**
+     * @brief calculates median, mean and the bootstrapped confidence interval of the median.
+     * @param metric - reference to the metric being summarized.
+    */
+    static void summarize(result_metric& metric);
+
+    /**
+     * @brief calculates the median of sorted values.
+     * @param sorted - const reference to the values, sorted ascending.
+     * @returns median, 0 if there are no values.
+    */
+    static double median_of_sorted(const indexed_stack<double>& sorted) noexcept;
+
+    /**
+     * @brief getter for the name of the metric goal.
+     * @param goal - direction in which the metric improves.
+     * @returns "lower" or "higher".
+    */
+    static const char* metric_goal_name(metric_goal goal) noexcept;
+
+};
+
+#endif
\ No newline at end of file
@@ -1,6 +1,8 @@
 #ifndef ROOT_SET_BASE_HPP
 #define ROOT_SET_BASE_HPP
 
+#include <cstdint>
+
 #include "../gc/gc-visitor.hpp"
 
 /**
@@ -8,6 +10,10 @@
  * @brief parent class of root-set table entries.
 */
 class root_set_base {
+private:
+    /// id of the root in the allocation trace, 0 if root isn't recorded.
+    uint64_t trace_id = 0;
+
 public:
     /**
      * @brief deletes the root_set_base object.
@@ -20,6 +26,22 @@ public:
      * @returns void
     */
     virtual void accept(gc_visitor& visitor) noexcept = 0;
+
+    /**
+     * @brief setter for the id of the root in the allocation trace.
+     * @param id - id of the root, 0 if root isn't recorded.
+    */
+    void set_trace_id(uint64_t id) noexcept {
+        trace_id = id;
+    }
+
+    /**
+     * @brief getter for the id of the root in the allocation trace.
+     * @returns id of the root, 0 if root isn't recorded.
+    */
+    uint64_t get_trace_id() const noexcept {
+        return trace_id;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef REGION_RELEASER_HPP
+#define REGION_RELEASER_HPP
+
+class thread_local_stack;
+
+/**
+ * @class region_releaser
+ * @brief interface of the heap that carves region chunks, returns them when a region scope is exited.
+*/
+class region_releaser {
+public:
+    /**
+     * @brief deletes the region_releaser object.
+    */
+    virtual ~region_releaser() = default;
+
+    /**
+     * @brief exits the current scope of the thread stack and releases its region.
+     * @param tls - reference to a thread local stack whose current scope has a region.
+     * @param destr - flag if the scope is exited by the destructor of the stack, defaults to false.
+    */
+    virtual void pop_region_scope(thread_local_stack& tls, bool destr = false) = 0;
+};
+
+#endif
\ No newline at end of file
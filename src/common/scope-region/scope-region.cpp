@@ -0,0 +1,121 @@
+#include "scope-region.hpp"
+
+#include <utility>
+
+std::atomic<uint32_t> scope_region::next_region_id{1};
+
+std::atomic<uint32_t> scope_region::escape_counters[REGION_ESCAPE_SLOTS]{};
+
+scope_region::scope_region() : id(0), scope(0), escapes_at_open(0) {}
+
+scope_region::scope_region(size_t scope) : id(generate_id()), scope(scope),
+    escapes_at_open(escape_counters[id % REGION_ESCAPE_SLOTS].load(std::memory_order_acquire)) {}
+
+scope_region::scope_region(scope_region&& other) noexcept : id(std::exchange(other.id, 0)), scope(std::exchange(other.scope, 0)),
+    escapes_at_open(std::exchange(other.escapes_at_open, 0)), chunks(std::move(other.chunks)) {}
+
+scope_region& scope_region::operator=(scope_region&& other) noexcept {
+    if(this != &other){
+        id = std::exchange(other.id, 0);
+        scope = std::exchange(other.scope, 0);
+        escapes_at_open = std::exchange(other.escapes_at_open, 0);
+        chunks = std::move(other.chunks);
+    }
+    return *this;
+}
+
+uint32_t scope_region::generate_id() noexcept {
+    uint32_t region_id = 0;
+    while(region_id == 0){
+        region_id = next_region_id.fetch_add(1, std::memory_order_relaxed) & MAX_REGION_ID;
+    }
+    return region_id;
+}
+
+uint32_t scope_region::get_id() const noexcept {
+    return id;
+}
+
+size_t scope_region::get_scope() const noexcept {
+    return scope;
+}
+
+header* scope_region::allocate(uint32_t bytes) noexcept {
+    if(chunks.empty()) return nullptr;
+
+    region_chunk& chunk = chunks.peek();
+    header* current = chunk.tail;
+    if(!current || current->size < bytes){
+        return nullptr;
+    }
+
+    uint32_t remaining = current->size - bytes;
+    if(remaining >= static_cast<uint32_t>(sizeof(header)) + 16){
+        header* new_tail = reinterpret_cast<header*>(reinterpret_cast<uint8_t*>(current) + sizeof(header) + static_cast<size_t>(bytes));
+
+        new_tail->size = remaining - static_cast<uint32_t>(sizeof(header));
+        new_tail->next = nullptr;
+        new_tail->reset_flags(false);
+        new_tail->set_region_id(id);
+
+        current->size = bytes;
+        chunk.tail = new_tail;
+    }
+    else {
+        chunk.tail = nullptr;
+    }
+
+    return current;
+}
+
+void scope_region::add_chunk(size_t segment_index, header* chunk) {
+    chunk->next = nullptr;
+    chunk->reset_flags(false);
+    chunk->set_region_id(id);
+    chunks.push(region_chunk{.segment_index = segment_index, .begin = chunk, .tail = chunk, .size = chunk->size});
+}
+
+int scope_region::current_segment() const noexcept {
+    if(chunks.empty() || !chunks.peek().tail) return -1;
+    return static_cast<int>(chunks.peek().segment_index);
+}
+
+uint64_t scope_region::segment_mask() const noexcept {
+    uint64_t mask = 0;
+    for(const region_chunk& chunk : chunks){
+        mask |= uint64_t{1} << chunk.segment_index;
+    }
+    return mask;
+}
+
+size_t scope_region::mark_blocks(uint32_t root_kinds) noexcept {
+    size_t marked_blocks = 0;
+    for(region_chunk& chunk : chunks){
+        uint8_t* ptr = reinterpret_cast<uint8_t*>(chunk.begin);
+        const uint8_t* end_ptr = ptr + sizeof(header) + static_cast<size_t>(chunk.size);
+
+        while(ptr < end_ptr){
+            header* hdr = reinterpret_cast<header*>(ptr);
+            hdr->mark_from(root_kinds);
+            ptr += sizeof(header) + static_cast<size_t>(hdr->size);
+            ++marked_blocks;
+        }
+    }
+    return marked_blocks;
+}
+
+bool scope_region::escaped() const noexcept {
+    return escape_counters[id % REGION_ESCAPE_SLOTS].load(std::memory_order_acquire) != escapes_at_open;
+}
+
+indexed_stack<region_chunk>& scope_region::get_chunks() noexcept {
+    return chunks;
+}
+
+void scope_region::record_escape(header* obj) noexcept {
+    if(!obj || !obj->is_region()) return;
+
+    if(obj->set_escaped()){
+        escape_counters[obj->region_id() % REGION_ESCAPE_SLOTS].fetch_add(1, std::memory_order_acq_rel);
+    }
+}
\ No newline at end of file
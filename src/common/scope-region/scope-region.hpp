@@ -0,0 +1,182 @@
+#ifndef SCOPE_REGION_HPP
+#define SCOPE_REGION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+#include "../header/header.hpp"
+#include "../indexed-stack/indexed-stack.hpp"
+
+/// size of a single region chunk in bytes (including its header).
+constexpr uint32_t REGION_CHUNK_SIZE = 64 * 1024;
+
+/// maximum object size in bytes that is bump-allocated inside of a region.
+constexpr uint32_t REGION_OBJECT_THRESHOLD = 2 * 1024;
+
+/// number of escape counters shared by all regions.
+constexpr size_t REGION_ESCAPE_SLOTS = 1024;
+
+/// maximum id of the region, limited by the bits of the header flags.
+constexpr uint32_t MAX_REGION_ID = (1u << (32 - REGION_ID_SHIFT)) - 1;
+
+/**
+ * @struct region_chunk
+ * @brief contiguous block of a segment that is owned by a scope region.
+*/
+struct region_chunk {
+    /// index of the segment the chunk was carved from.
+    size_t segment_index;
+
+    /// header of the block that spans the whole chunk.
+    header* begin;
+
+    /// header of the unused remainder of the chunk, nullptr if chunk is full.
+    header* tail;
+
+    /// size of the chunk block without its header.
+    uint32_t size;
+};
+
+/**
+ * @class scope_region
+ * @brief bump allocator tied to a scope of the thread_local_stack.
+ * @details objects of the region are regular blocks of the segment, placed one after another inside of the chunks.
+ * Region is released at once when its scope is popped, unless one of its objects escaped the scope.
+*/
+class scope_region {
+private:
+    /// id of the region, stored in the flags of each block of the region.
+    uint32_t id;
+
+    /// scope of the thread_local_stack the region is tied to.
+    size_t scope;
+
+    /// value of the escape counter when the region was opened.
+    uint32_t escapes_at_open;
+
+    /// chunks owned by the region, last one is used for allocation.
+    indexed_stack<region_chunk> chunks;
+
+    /// id of the next region.
+    static std::atomic<uint32_t> next_region_id;
+
+    /// escape counters, shared by regions whose ids map to the same slot.
+    static std::atomic<uint32_t> escape_counters[REGION_ESCAPE_SLOTS];
+
+    /**
+     * @brief generates the id of a new region.
+     * @returns id of the region, never 0.
+    */
+    static uint32_t generate_id() noexcept;
+
+public:
+    /**
+     * @brief creates an empty region that isn't tied to any scope.
+     * @details id defaults to 0.
+    */
+    scope_region();
+
+    /**
+     * @brief creates the instance of the scope region.
+     * @param scope - scope of the thread_local_stack the region is tied to.
+    */
+    scope_region(size_t scope);
+
+    /**
+     * @brief deletes the scope region.
+     * @details doesn't release the chunks, releasing is done by heap manager.
+    */
+    ~scope_region() = default;
+
+    /// deleted copy constructor.
+    scope_region(const scope_region&) = delete;
+
+    /// deleted assignment operator.
+    scope_region& operator=(const scope_region&) = delete;
+
+    /**
+     * @brief constructs new scope region from an existing one.
+     * @param other - rvalue of the existing scope region.
+     * @details moves ownership of the chunks from other to this.
+    */
+    scope_region(scope_region&& other) noexcept;
+
+    /**
+     * @brief constructs new scope region by assigning it an existing one.
+     * @param other - rvalue of the existing scope region.
+     * @details moves ownership of the chunks from other to this.
+    */
+    scope_region& operator=(scope_region&& other) noexcept;
+
+    /**
+     * @brief getter for the id of the region.
+     * @returns id of the region.
+    */
+    uint32_t get_id() const noexcept;
+
+    /**
+     * @brief getter for the scope the region is tied to.
+     * @returns scope of the region.
+    */
+    size_t get_scope() const noexcept;
+
+    /**
+     * @brief bump-allocates an object inside of the last chunk.
+     * @param bytes - required memory, aligned to 16 bytes.
+     * @returns pointer to the header of the object, nullptr if the last chunk can't fit the object.
+     * @warning segment of the last chunk must be locked.
+    */
+    header* allocate(uint32_t bytes) noexcept;
+
+    /**
+     * @brief adds new chunk to the region.
+     * @param segment_index - index of the segment the chunk was allocated from.
+     * @param chunk - header of the allocated block that becomes the chunk.
+     * @warning segment of the chunk must be locked.
+    */
+    void add_chunk(size_t segment_index, header* chunk);
+
+    /**
+     * @brief getter for the segment of the chunk used for allocation.
+     * @returns index of the segment, -1 if there is no chunk with free space.
+    */
+    int current_segment() const noexcept;
+
+    /**
+     * @brief getter for the segments the region has chunks in.
+     * @returns bit mask of the segment indices.
+    */
+    uint64_t segment_mask() const noexcept;
+
+    /**
+     * @brief marks every block of the region, region is alive as long as its scope.
+     * @param root_kinds - bits of the root kinds recorded for the census, 0 only marks the blocks.
+     * @returns number of marked blocks.
+     * @warning must be called during the STW.
+    */
+    size_t mark_blocks(uint32_t root_kinds = 0) noexcept;
+
+    /**
+     * @brief checks if any object could have escaped the region.
+     * @returns true if escape was recorded since the region was opened, false otherwise.
+     * @note conservative, escapes of regions sharing the counter slot are reported as well.
+    */
+    bool escaped() const noexcept;
+
+    /**
+     * @brief getter for the chunks of the region.
+     * @returns reference to the chunks.
+    */
+    indexed_stack<region_chunk>& get_chunks() noexcept;
+
+    /**
+     * @brief records that object is referenced from outside of its scope.
+     * @param obj - pointer to the header of the stored object.
+     * @details cheap for objects that don't belong to a region, only the region bit is checked.
+    */
+    static void record_escape(header* obj) noexcept;
+
+};
+
+#endif
\ No newline at end of file
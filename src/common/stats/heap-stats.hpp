@@ -0,0 +1,160 @@
+#ifndef HEAP_STATS_HPP
+#define HEAP_STATS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+#include "../../heap/heap.hpp"
+
+/// smallest free block size class is 2^FREE_BLOCK_MIN_SIZE_SHIFT bytes (16B).
+constexpr size_t FREE_BLOCK_MIN_SIZE_SHIFT = 4;
+
+/// number of power of two free block size classes, from 16B up to the whole segment.
+constexpr size_t FREE_BLOCK_SIZE_CLASSES = std::bit_width(SEGMENT_SIZE) - FREE_BLOCK_MIN_SIZE_SHIFT;
+
+/**
+ * @struct fragmentation_stats
+ * @brief free space layout of a segment, measured by the last coalescing and extended by the region chunks released since.
+*/
+struct fragmentation_stats {
+    /// number of free blocks.
+    uint32_t free_blocks;
+
+    /// size of the largest free block without its header.
+    uint32_t largest_free_block;
+
+    /// sum of the sizes of the free blocks without their headers.
+    uint32_t free_block_bytes;
+
+    /// number of free blocks in each size class, class i holds sizes in [2^(i+4), 2^(i+5)).
+    uint32_t free_block_histogram[FREE_BLOCK_SIZE_CLASSES];
+
+    /**
+     * @brief getter for the size class of a free block.
+     * @param size - size of the block without its header.
+     * @returns index of the size class.
+    */
+    static constexpr size_t size_class(uint32_t size) noexcept {
+        const size_t width = static_cast<size_t>(std::bit_width(size));
+        if(width <= FREE_BLOCK_MIN_SIZE_SHIFT + 1) return 0;
+        const size_t size_class_index = width - 1 - FREE_BLOCK_MIN_SIZE_SHIFT;
+        return size_class_index < FREE_BLOCK_SIZE_CLASSES ? size_class_index : FREE_BLOCK_SIZE_CLASSES - 1;
+    }
+
+    /**
+     * @brief adds the free block to the statistics.
+     * @param size - size of the block without its header.
+    */
+    void add_free_block(uint32_t size) noexcept {
+        ++free_blocks;
+        free_block_bytes += size;
+        if(size > largest_free_block) largest_free_block = size;
+        ++free_block_histogram[size_class(size)];
+    }
+
+    /**
+     * @brief calculates the external fragmentation of the free space.
+     * @returns 1 - largest free block / total free space, 0 if there is no free space.
+    */
+    double external_fragmentation() const noexcept {
+        if(free_block_bytes == 0) return 0.0;
+        return 1.0 - static_cast<double>(largest_free_block) / static_cast<double>(free_block_bytes);
+    }
+};
+
+/**
+ * @struct category_stats
+ * @brief allocation counters of an object size category.
+*/
+struct category_stats {
+    /// number of successful allocations.
+    uint64_t allocations;
+
+    /// number of allocated bytes, aligned to 16 bytes, without headers.
+    uint64_t allocated_bytes;
+
+    /// number of allocations that entered the slow path (first attempt failed).
+    uint64_t slow_path_entries;
+
+    /// number of allocations that failed even after gc.
+    uint64_t failures;
+};
+
+/**
+ * @struct segment_stats
+ * @brief state of a segment at the time of the snapshot.
+*/
+struct segment_stats {
+    /// object size category the segment serves.
+    segment_category category;
+
+    /// number of free bytes, including headers of free blocks.
+    uint32_t free_bytes;
+
+    /// bytes held by region chunks of open scopes, including chunk headers.
+    uint32_t region_chunk_bytes;
+
+    /// free space layout after the last gc.
+    fragmentation_stats fragmentation;
+};
+
+/**
+ * @struct heap_stats
+ * @brief snapshot of the heap statistics.
+*/
+struct heap_stats {
+    /// allocation counters of each object size category.
+    category_stats categories[SEGMENT_CATEGORY_COUNT];
+
+    /// state of each segment.
+    segment_stats segments[TOTAL_SEGMENTS];
+
+    /// number of completed garbage collections.
+    uint64_t gc_count;
+
+    /// number of bytes occupied by live objects after the last garbage collection.
+    uint64_t live_bytes_after_gc;
+
+    /**
+     * @brief calculates the number of allocations of all categories.
+     * @returns total number of allocations.
+    */
+    uint64_t total_allocations() const noexcept {
+        uint64_t total = 0;
+        for(const category_stats& category : categories){
+            total += category.allocations;
+        }
+        return total;
+    }
+
+    /**
+     * @brief calculates the external fragmentation of the whole heap after the last gc.
+     * @returns 1 - sum of the largest free blocks of the segments / total free space, 0 if there is no free space.
+     * @details objects never span segments, so each segment contributes its own largest free block.
+    */
+    double external_fragmentation() const noexcept {
+        uint64_t free_block_bytes = 0;
+        uint64_t largest_free_blocks = 0;
+        for(const segment_stats& segment : segments){
+            free_block_bytes += segment.fragmentation.free_block_bytes;
+            largest_free_blocks += segment.fragmentation.largest_free_block;
+        }
+        if(free_block_bytes == 0) return 0.0;
+        return 1.0 - static_cast<double>(largest_free_blocks) / static_cast<double>(free_block_bytes);
+    }
+
+    /**
+     * @brief calculates the number of free bytes of all segments.
+     * @returns total number of free bytes.
+    */
+    uint64_t total_free_bytes() const noexcept {
+        uint64_t total = 0;
+        for(const segment_stats& segment : segments){
+            total += segment.free_bytes;
+        }
+        return total;
+    }
+};
+
+#endif
\ No newline at end of file
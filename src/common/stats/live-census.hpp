@@ -0,0 +1,165 @@
+#ifndef LIVE_CENSUS_HPP
+#define LIVE_CENSUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+#include <string_view>
+
+#include "../../heap/heap.hpp"
+
+/// granularity of the small census size classes, equal to the allocation alignment.
+constexpr size_t CENSUS_GRANULE = 16;
+
+/// largest object size in bytes that gets its own 16B size class.
+constexpr size_t CENSUS_SMALL_SIZE_LIMIT = 2 * 1024;
+
+/// number of 16B size classes, class i holds sizes (16i, 16(i+1)].
+constexpr size_t CENSUS_SMALL_CLASSES = CENSUS_SMALL_SIZE_LIMIT / CENSUS_GRANULE;
+
+/// number of power of two size classes above the small classes, up to the whole segment.
+constexpr size_t CENSUS_LARGE_CLASSES = std::bit_width(SEGMENT_SIZE - 1) - std::bit_width(CENSUS_SMALL_SIZE_LIMIT - 1);
+
+/// total number of census size classes.
+constexpr size_t CENSUS_SIZE_CLASSES = CENSUS_SMALL_CLASSES + CENSUS_LARGE_CLASSES;
+
+/**
+ * @enum root_kind
+ * @brief kind of the root an object was reached from during marking.
+*/
+enum class root_kind : uint8_t {
+    tls,
+    global,
+    reg
+};
+
+/// number of root kinds.
+constexpr size_t ROOT_KIND_COUNT = 3;
+
+/**
+ * @brief getter for the name of the root kind.
+ * @param kind - kind of the root.
+ * @returns name of the root kind.
+*/
+constexpr std::string_view root_kind_name(root_kind kind) noexcept {
+    switch(kind){
+        case root_kind::tls:
+            return "tls";
+        case root_kind::global:
+            return "global";
+        case root_kind::reg:
+            return "register";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief getter for the bit of the root kind inside of the root kind mask.
+ * @param kind - kind of the root.
+ * @returns bit of the root kind.
+*/
+constexpr uint32_t root_kind_bit(root_kind kind) noexcept {
+    return 1u << static_cast<uint32_t>(kind);
+}
+
+/**
+ * @struct census_bucket
+ * @brief number and size of the live objects counted into a bucket.
+*/
+struct census_bucket {
+    /// number of live objects.
+    uint64_t objects;
+
+    /// number of bytes occupied by live objects, without headers.
+    uint64_t bytes;
+
+    /**
+     * @brief adds the object to the bucket.
+     * @param size - size of the object without its header.
+    */
+    void add(uint64_t size) noexcept {
+        ++objects;
+        bytes += size;
+    }
+
+    /**
+     * @brief adds the counts of other bucket to this one.
+     * @param other - const reference to the bucket that is merged.
+    */
+    void merge(const census_bucket& other) noexcept {
+        objects += other.objects;
+        bytes += other.bytes;
+    }
+};
+
+/**
+ * @struct live_census
+ * @brief live objects that survived a gc cycle, grouped by size class and by the kind of the roots that reach them.
+ * @details object reachable from several root kinds is counted toward each of them.
+*/
+struct live_census {
+    /// live objects of each size class.
+    census_bucket size_classes[CENSUS_SIZE_CLASSES];
+
+    /// live objects retained by each root kind.
+    census_bucket root_kinds[ROOT_KIND_COUNT];
+
+    /// all live objects.
+    census_bucket total;
+
+    /**
+     * @brief getter for the size class of an object.
+     * @param size - size of the object without its header.
+     * @returns index of the size class.
+    */
+    static constexpr size_t size_class(uint32_t size) noexcept {
+        if(size <= CENSUS_SMALL_SIZE_LIMIT){
+            return size == 0 ? 0 : (size - 1) / CENSUS_GRANULE;
+        }
+        const size_t large_class = static_cast<size_t>(std::bit_width(size - 1)) - std::bit_width(CENSUS_SMALL_SIZE_LIMIT - 1) - 1;
+        return CENSUS_SMALL_CLASSES + (large_class < CENSUS_LARGE_CLASSES ? large_class : CENSUS_LARGE_CLASSES - 1);
+    }
+
+    /**
+     * @brief getter for the largest object size of a size class.
+     * @param size_class_index - index of the size class.
+     * @returns upper bound of the size class in bytes, inclusive.
+    */
+    static constexpr uint64_t size_class_limit(size_t size_class_index) noexcept {
+        if(size_class_index < CENSUS_SMALL_CLASSES){
+            return (size_class_index + 1) * CENSUS_GRANULE;
+        }
+        return uint64_t{CENSUS_SMALL_SIZE_LIMIT} << (size_class_index - CENSUS_SMALL_CLASSES + 1);
+    }
+
+    /**
+     * @brief adds the live object to the census.
+     * @param size - size of the object without its header.
+     * @param root_kinds_mask - bits of the root kinds that reached the object.
+    */
+    void add(uint32_t size, uint32_t root_kinds_mask) noexcept {
+        total.add(size);
+        size_classes[size_class(size)].add(size);
+        for(size_t i = 0; i < ROOT_KIND_COUNT; ++i){
+            if(root_kinds_mask & root_kind_bit(static_cast<root_kind>(i))){
+                root_kinds[i].add(size);
+            }
+        }
+    }
+
+    /**
+     * @brief adds the partial census to this one.
+     * @param other - const reference to the partial census.
+    */
+    void merge(const live_census& other) noexcept {
+        for(size_t i = 0; i < CENSUS_SIZE_CLASSES; ++i){
+            size_classes[i].merge(other.size_classes[i]);
+        }
+        for(size_t i = 0; i < ROOT_KIND_COUNT; ++i){
+            root_kinds[i].merge(other.root_kinds[i]);
+        }
+        total.merge(other.total);
+    }
+};
+
+#endif
\ No newline at end of file
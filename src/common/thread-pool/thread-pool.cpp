@@ -3,6 +3,8 @@
 #include <new>
 
 thread_pool::thread_pool(size_t thread_count) : stop(false), threads(nullptr), thread_count(thread_count) {
+    set_lock_name(mtx, "thread_pool::mtx");
+
     if (thread_count == 0) {
         throw std::invalid_argument("Thread count must be greater than zero");
     }
@@ -28,7 +30,7 @@ thread_pool::thread_pool(size_t thread_count) : stop(false), threads(nullptr), t
 
 thread_pool::~thread_pool() {
     {
-        std::lock_guard<std::mutex> lock(mtx);
+        std::lock_guard<pool_mutex> lock(mtx);
         stop = true;
     }
     cv.notify_all();
@@ -47,7 +49,7 @@ void thread_pool::worker() {
     while (true) {
         std::function<void()> task;
         {
-            std::unique_lock<std::mutex> lock(mtx);
+            std::unique_lock<pool_mutex> lock(mtx);
             cv.wait(lock, [this] {
                 return stop || !tasks.empty();
             });
@@ -60,4 +62,8 @@ void thread_pool::worker() {
         }
         task();
     }
+}
+
+size_t thread_pool::get_thread_count() const noexcept {
+    return thread_count;
 }
\ No newline at end of file
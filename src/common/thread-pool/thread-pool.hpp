@@ -9,6 +9,7 @@
 #include <stdexcept>
 
 #include "../queue/queue.hpp"
+#include "../profiled-mutex/profiled-mutex.hpp"
 
 /** 
  * @class thread_pool
@@ -17,10 +18,10 @@
 class thread_pool {
 private:
     /// mutex for concurrent access to tasks.
-    std::mutex mtx;
+    pool_mutex mtx;
 
     /// condition variable for waiting/notifying.
-    std::condition_variable cv;
+    pool_condition cv;
 
     /// flag that handles stoppage of worker threads.
     bool stop;
@@ -59,7 +60,7 @@ public:
     template<typename T>
     void enqueue(T&& f) {
         {
-            std::lock_guard<std::mutex> lock(mtx);
+            std::lock_guard<pool_mutex> lock(mtx);
             if(stop){
                 throw std::runtime_error("Enqueue on stopped thread");
             }
@@ -69,6 +70,12 @@ public:
         cv.notify_one();
     }
 
+    /**
+     * @brief getter for the number of worker threads.
+     * @returns number of threads in a thread pool.
+    */
+    size_t get_thread_count() const noexcept;
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+
+std::unique_ptr<trace_buffer> tracer::buffers[MAX_TRACE_THREADS];
+
+std::atomic<size_t> tracer::registered_threads{0};
+
+trace_buffer::trace_buffer(uint32_t thread_id) noexcept : thread_id(thread_id) {}
+
+void trace_buffer::push(const trace_event& event) noexcept {
+    const uint64_t index = written.load(std::memory_order_relaxed);
+    events[index % TRACE_BUFFER_CAPACITY] = event;
+    written.store(index + 1, std::memory_order_release);
+}
+
+uint64_t trace_buffer::get_written() const noexcept {
+    return written.load(std::memory_order_acquire);
+}
+
+const trace_event& trace_buffer::get_event(uint64_t index) const noexcept {
+    return events[index % TRACE_BUFFER_CAPACITY];
+}
+
+uint32_t trace_buffer::get_thread_id() const noexcept {
+    return thread_id;
+}
+
+trace_buffer* tracer::current_buffer() {
+    thread_local trace_buffer* buffer = nullptr;
+    thread_local bool registered = false;
+
+    if(!registered){
+        registered = true;
+        const size_t slot = registered_threads.fetch_add(1, std::memory_order_acq_rel);
+        if(slot < MAX_TRACE_THREADS){
+            buffers[slot] = std::make_unique<trace_buffer>(static_cast<uint32_t>(slot + 1));
+            buffer = buffers[slot].get();
+        }
+    }
+    return buffer;
+}
+
+void tracer::record_event(const char* name, const char* category, trace_phase phase) noexcept {
+    trace_buffer* buffer = nullptr;
+    try {
+        buffer = current_buffer();
+    }
+    catch(...) {
+        return;
+    }
+    if(!buffer) return;
+
+    const uint64_t timestamp_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count()
+    );
+    buffer->push(trace_event{.name = name, .category = category, .timestamp_ns = timestamp_ns, .phase = phase});
+}
+
+bool tracer::dump(const std::string& path){
+    std::ofstream out(path);
+    if(!out) return false;
+
+    const size_t thread_count = std::min(registered_threads.load(std::memory_order_acquire), MAX_TRACE_THREADS);
+    bool first = true;
+
+    out << "{\"traceEvents\":[\n";
+    for(size_t i = 0; i < thread_count; ++i){
+        const trace_buffer* buffer = buffers[i].get();
+        if(!buffer) continue;
+
+        const uint64_t written = buffer->get_written();
+        const uint64_t oldest = written > TRACE_BUFFER_CAPACITY ? written - TRACE_BUFFER_CAPACITY : 0;
+        for(uint64_t e = oldest; e < written; ++e){
+            const trace_event& event = buffer->get_event(e);
+            out << std::format("{}{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}{}}}",
+                first ? "" : ",\n", event.name, event.category, static_cast<char>(event.phase), 
+                static_cast<double>(event.timestamp_ns) / 1000.0, buffer->get_thread_id(), 
+                event.phase == trace_phase::instant ? ",\"s\":\"t\"" : ""
+            );
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    return static_cast<bool>(out);
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#ifdef GCSIM_TRACING
+/// tracing is enabled with -DGCSIM_TRACING.
+constexpr bool TRACING_ENABLED = true;
+#else
+/// tracing is enabled with -DGCSIM_TRACING.
+constexpr bool TRACING_ENABLED = false;
+#endif
+
+/// number of events kept per thread, older events are overwritten.
+constexpr size_t TRACE_BUFFER_CAPACITY = 16 * 1024;
+
+/// maximum number of traced threads, events of later threads are dropped.
+constexpr size_t MAX_TRACE_THREADS = 256;
+
+/// file the trace is written to.
+constexpr const char* TRACE_OUTPUT_PATH = "gcsim-trace.json";
+
+/**
+ * @enum trace_phase
+ * @brief defines the kind of the event, values match the "ph" field of the chrome trace-event format.
+ * @details begin - start of a duration event.
+ * end - end of a duration event.
+ * instant - event without duration.
+*/
+enum class trace_phase : char { begin = 'B', end = 'E', instant = 'i' };
+
+/**
+ * @struct trace_event
+ * @brief single event of the trace.
+*/
+struct trace_event {
+    /// name of the event, must be a string literal.
+    const char* name;
+
+    /// category of the event, must be a string literal.
+    const char* category;
+
+    /// time of the event on the steady clock, in nanoseconds.
+    uint64_t timestamp_ns;
+
+    /// kind of the event.
+    trace_phase phase;
+};
+
+/**
+ * @class trace_buffer
+ * @brief ring buffer of the events of a single thread.
+ * @details only the owning thread writes into the buffer.
+*/
+class trace_buffer {
+private:
+    /// recorded events.
+    trace_event events[TRACE_BUFFER_CAPACITY];
+
+    /// number of events written since the buffer was created.
+    std::atomic<uint64_t> written{0};
+
+    /// id of the thread in the trace.
+    uint32_t thread_id;
+
+public:
+    /**
+     * @brief creates an empty buffer.
+     * @param thread_id - id of the owning thread in the trace.
+    */
+    explicit trace_buffer(uint32_t thread_id) noexcept;
+
+    /**
+     * @brief deletes the buffer.
+    */
+    ~trace_buffer() = default;
+
+    /// deleted copy constructor.
+    trace_buffer(const trace_buffer&) = delete;
+
+    /// deleted assignment operator.
+    trace_buffer& operator=(const trace_buffer&) = delete;
+
+    /**
+     * @brief appends the event, overwriting the oldest one if buffer is full.
+     * @param event - const reference to the event.
+    */
+    void push(const trace_event& event) noexcept;
+
+    /**
+     * @brief getter for the number of written events.
+     * @returns number of events written since the buffer was created.
+    */
+    uint64_t get_written() const noexcept;
+
+    /**
+     * @brief getter for the event.
+     * @param index - index of the event since the buffer was created, must be one of the last TRACE_BUFFER_CAPACITY events.
+     * @returns const reference to the event.
+    */
+    const trace_event& get_event(uint64_t index) const noexcept;
+
+    /**
+     * @brief getter for the id of the owning thread.
+     * @returns id of the thread in the trace.
+    */
+    uint32_t get_thread_id() const noexcept;
+
+};
+
+/**
+ * @class tracer
+ * @brief records events into per-thread ring buffers and exports them as chrome trace-event JSON.
+ * @details every call compiles to nothing unless built with GCSIM_TRACING.
+ * The trace can be opened in chrome://tracing or ui.perfetto.dev.
+*/
+class tracer {
+private:
+    /// buffers of the traced threads, indexed by registration order.
+    static std::unique_ptr<trace_buffer> buffers[MAX_TRACE_THREADS];
+
+    /// number of threads that recorded an event.
+    static std::atomic<size_t> registered_threads;
+
+    /**
+     * @brief getter for the buffer of the calling thread.
+     * @returns pointer to the buffer, nullptr if MAX_TRACE_THREADS threads are already traced.
+     * @details buffer is created on the first call of the thread.
+    */
+    static trace_buffer* current_buffer();
+
+    /**
+     * @brief records the event into the buffer of the calling thread.
+     * @param name - name of the event.
+     * @param category - category of the event.
+     * @param phase - kind of the event.
+    */
+    static void record_event(const char* name, const char* category, trace_phase phase) noexcept;
+
+public:
+    /**
+     * @brief records the event if tracing is enabled.
+     * @param name - name of the event, must be a string literal.
+     * @param category - category of the event, must be a string literal.
+     * @param phase - kind of the event.
+    */
+    static void record(const char* name, const char* category, trace_phase phase) noexcept {
+        if constexpr (TRACING_ENABLED){
+            record_event(name, category, phase);
+        }
+        else {
+            (void)name;
+            (void)category;
+            (void)phase;
+        }
+    }
+
+    /**
+     * @brief writes the recorded events as chrome trace-event JSON.
+     * @param path - path of the output file.
+     * @returns true if the trace was written, false otherwise.
+     * @warning traced threads must not record events during the dump.
+    */
+    static bool dump(const std::string& path);
+
+};
+
+/**
+ * @class trace_scope
+ * @brief records begin event on creation and end event on destruction.
+*/
+class trace_scope {
+private:
+    /// name of the event.
+    const char* name;
+
+    /// category of the event.
+    const char* category;
+
+public:
+    /**
+     * @brief records the begin event.
+     * @param name - name of the event, must be a string literal.
+     * @param category - category of the event, must be a string literal.
+    */
+    trace_scope(const char* name, const char* category) noexcept : name(name), category(category) {
+        tracer::record(name, category, trace_phase::begin);
+    }
+
+    /**
+     * @brief records the end event.
+    */
+    ~trace_scope() noexcept {
+        tracer::record(name, category, trace_phase::end);
+    }
+
+    /// deleted copy constructor.
+    trace_scope(const trace_scope&) = delete;
+
+    /// deleted assignment operator.
+    trace_scope& operator=(const trace_scope&) = delete;
+
+};
+
+#endif
\ No newline at end of file
@@ -1,44 +1,67 @@
 #include "gc.hpp"
 
 #include <latch>
-#include <iostream>
+#include <memory>
 
-garbage_collector::garbage_collector(size_t thread_count) : gc_thread_pool(thread_count) {}
+garbage_collector::garbage_collector(size_t thread_count) : gc_thread_pool(thread_count), census_enabled(false), census_cycle(false), last_census{} {}
 
-void garbage_collector::collect(root_set_table& root_set, heap& heap_memory) noexcept {
-    std::cout << "Collecting garbage...\n";
-    mark(root_set);
-    sweep(heap_memory);
+void garbage_collector::collect(root_set_table& root_set, heap& heap_memory, gc_pause& pause) noexcept {
+    census_cycle = census_enabled.load(std::memory_order_acquire);
+
+    const uint64_t mark_start_ns = gc_pause_report::clock_ns();
+    {
+        trace_scope mark_trace("mark", "gc");
+        pause.mark_cpu_ns = mark(root_set);
+    }
+
+    const uint64_t sweep_start_ns = gc_pause_report::clock_ns();
+    {
+        trace_scope sweep_trace("sweep", "gc");
+        pause.sweep_cpu_ns = sweep(heap_memory);
+    }
+
+    pause.mark_ns = sweep_start_ns - mark_start_ns;
+    pause.sweep_ns = gc_pause_report::clock_ns() - sweep_start_ns;
 }
 
 void garbage_collector::visit(thread_local_stack& stack){
     auto& stack_data = stack.get_thread_stack_unlocked();
+    uint64_t marked_objects = 0;
     for(thread_local_stack_entry& entry : stack_data) {
         if(entry.ref_to){
-            entry.ref_to->set_marked(true);
+            entry.ref_to->mark_from(census_root_kinds(root_kind::tls));
+            ++marked_objects;
         }
     }
+
+    for(scope_region& region : stack.get_regions_unlocked()) {
+        marked_objects += region.mark_blocks(census_root_kinds(root_kind::tls));
+    }
+    mark_counters.add_objects(marked_objects);
 }
 
 void garbage_collector::visit(global_root& global){
     header* gvar = global.get_global_variable_unlocked();
     if(gvar){
-        gvar->set_marked(true);
+        gvar->mark_from(census_root_kinds(root_kind::global));
+        mark_counters.add_objects(1);
     }
 }
 
 void garbage_collector::visit(register_root& reg){
     header* reg_var = reg.get_register_variable_unlocked();
     if(reg_var){
-        reg_var->set_marked(true);
+        reg_var->mark_from(census_root_kinds(root_kind::reg));
+        mark_counters.add_objects(1);
     }
 }
 
-void garbage_collector::mark(root_set_table& root_set) noexcept {
+uint64_t garbage_collector::mark(root_set_table& root_set) noexcept {
     const size_t total = root_set.get_root_count();
-    if(total == 0) return;
+    if(total == 0) return 0;
 
     std::latch completion_latch(static_cast<std::ptrdiff_t>(total));
+    std::atomic<uint64_t> task_cpu_ns{0};
 
     auto& roots_table = root_set.get_roots();
     auto** buckets = roots_table.get_buckets();
@@ -47,9 +70,15 @@ void garbage_collector::mark(root_set_table& root_set) noexcept {
     for(size_t i = 0; i < capacity; ++i) {
         for(auto* root = buckets[i]; root; root = root->next){
             gc_thread_pool.enqueue([&, &root_value = root->value]{
-                if(root_value){
-                    root_value->accept(*this);
+                const uint64_t task_cpu_start_ns = gc_pause_report::thread_cpu_ns();
+                {
+                    trace_scope task_trace("mark root", "gc task");
+                    perf_scope task_counters(mark_counters);
+                    if(root_value){
+                        root_value->accept(*this);
+                    }
                 }
+                task_cpu_ns.fetch_add(gc_pause_report::thread_cpu_ns() - task_cpu_start_ns, std::memory_order_relaxed);
                 completion_latch.count_down();
             });
             
@@ -57,17 +86,27 @@ void garbage_collector::mark(root_set_table& root_set) noexcept {
     }
 
     completion_latch.wait();
+    return task_cpu_ns.load(std::memory_order_acquire);
+}
+
+uint32_t garbage_collector::census_root_kinds(root_kind kind) const noexcept {
+    return census_cycle ? root_kind_bit(kind) : 0;
 }
 
-void garbage_collector::sweep_segment(segment& seg) noexcept {
+size_t garbage_collector::sweep_segment(segment& seg, live_census* census) noexcept {
     uint8_t* ptr = seg.segment_memory;
     const uint8_t* endptr = seg.segment_memory + SEGMENT_SIZE;
+    size_t swept_blocks = 0;
     
     while(ptr + sizeof(header) <= endptr) {
         header* hdr = reinterpret_cast<header*>(ptr);
+        ++swept_blocks;
 
         if(hdr->is_marked()) {
-            hdr->set_marked(false);
+            if(census){
+                census->add(hdr->size, hdr->root_kinds());
+            }
+            hdr->clear_mark();
         }
         else {
             hdr->set_free(true);
@@ -75,31 +114,63 @@ void garbage_collector::sweep_segment(segment& seg) noexcept {
 
         ptr += sizeof(header) + static_cast<size_t>(hdr->size);
     }
+
+    return swept_blocks;
 }
 
-void garbage_collector::sweep(heap& heap_memory) noexcept {
-    if constexpr (TOTAL_SEGMENTS == 0) return;
+uint64_t garbage_collector::sweep(heap& heap_memory) noexcept {
+    if constexpr (TOTAL_SEGMENTS == 0) return 0;
     
     std::latch completion_latch(TOTAL_SEGMENTS);
-
-    auto enqueue_segment_sweep = [&](segment& segment) -> void {
-        gc_thread_pool.enqueue([&, seg = &segment] -> void {
-            sweep_segment(*seg);
+    std::atomic<uint64_t> task_cpu_ns{0};
+    std::unique_ptr<live_census[]> partial_census = census_cycle ? std::make_unique<live_census[]>(TOTAL_SEGMENTS) : nullptr;
+
+    auto enqueue_segment_sweep = [&](segment& segment, live_census* census) -> void {
+        gc_thread_pool.enqueue([&, seg = &segment, census] -> void {
+            const uint64_t task_cpu_start_ns = gc_pause_report::thread_cpu_ns();
+            {
+                trace_scope task_trace("sweep segment", "gc task");
+                perf_scope task_counters(sweep_counters);
+                task_counters.add_objects(sweep_segment(*seg, census));
+            }
+            task_cpu_ns.fetch_add(gc_pause_report::thread_cpu_ns() - task_cpu_start_ns, std::memory_order_relaxed);
             completion_latch.count_down();
         });
     };
 
-    for(size_t i = 0; i < SMALL_OBJECT_SEGMENTS; ++i) {
-        enqueue_segment_sweep(heap_memory.get_small_object_segment(i));
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i) {
+        enqueue_segment_sweep(heap_memory.get_segment(i), partial_census ? &partial_census[i] : nullptr);
     }
 
-    for(size_t i = 0; i < MEDIUM_OBJECT_SEGMENTS; ++i) {
-        enqueue_segment_sweep(heap_memory.get_medium_object_segment(i));
-    }
+    completion_latch.wait();
 
-    for(size_t i = 0; i < LARGE_OBJECT_SEGMENTS; ++i) {
-        enqueue_segment_sweep(heap_memory.get_large_object_segment(i));
+    if(partial_census){
+        last_census = live_census{};
+        for(size_t i = 0; i < TOTAL_SEGMENTS; ++i) {
+            last_census.merge(partial_census[i]);
+        }
     }
 
-    completion_latch.wait();
+    return task_cpu_ns.load(std::memory_order_acquire);
+}
+
+gc_perf_counters garbage_collector::get_perf_counters() const noexcept {
+    return gc_perf_counters{
+        .mark = mark_counters.load(),
+        .sweep = sweep_counters.load(),
+        .marked_objects = mark_counters.get_objects(),
+        .swept_objects = sweep_counters.get_objects()
+    };
+}
+
+size_t garbage_collector::get_thread_count() const noexcept {
+    return gc_thread_pool.get_thread_count();
+}
+
+void garbage_collector::set_census_enabled(bool enabled) noexcept {
+    census_enabled.store(enabled, std::memory_order_release);
+}
+
+const live_census& garbage_collector::get_last_census() const noexcept {
+    return last_census;
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #define GARBAGE_COLLECTOR_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <atomic>
 
 #include "../common/gc/gc-visitor.hpp"
 #include "../root-set-table/root-set-table.hpp"
@@ -10,6 +12,28 @@
 #include "../root-set-table/register-root.hpp"
 #include "../heap/heap.hpp"
 #include "../common/thread-pool/thread-pool.hpp"
+#include "../common/gc-pause/gc-pause.hpp"
+#include "../common/trace/trace.hpp"
+#include "../common/perf-counters/perf-counters.hpp"
+#include "../common/stats/live-census.hpp"
+
+/**
+ * @struct gc_perf_counters
+ * @brief hardware counters of the gc phases, accumulated over all cycles.
+*/
+struct gc_perf_counters {
+    /// counters of the mark tasks.
+    perf_sample mark;
+
+    /// counters of the sweep tasks.
+    perf_sample sweep;
+
+    /// number of objects marked from the roots.
+    uint64_t marked_objects;
+
+    /// number of blocks visited by the sweep.
+    uint64_t swept_objects;
+};
 
 /**
  * @class garbage_collector
@@ -20,23 +44,42 @@ private:
     /// thread pool for concurrent marking and sweeping.
     thread_pool gc_thread_pool;
 
+    /// hardware counters of the mark tasks.
+    perf_phase_counters mark_counters;
+
+    /// hardware counters of the sweep tasks.
+    perf_phase_counters sweep_counters;
+
+    /// flag for taking the live-object census during the next gc cycles.
+    std::atomic<bool> census_enabled;
+
+    /// flag for taking the census during the current gc cycle.
+    bool census_cycle;
+
+    /// census of the live objects after the last gc cycle that took it.
+    live_census last_census;
+
     /**
-     * @brief marks all objects that are reachable from the root-set-table.
-     * @param root_set - reference to a root-set-table
+     * @brief getter for the root kind bits recorded while marking.
+     * @param kind - kind of the root that is visited.
+     * @returns bit of the root kind if the census is taken during the cycle, 0 otherwise.
     */
-    void mark(root_set_table& root_set) noexcept;
+    uint32_t census_root_kinds(root_kind kind) const noexcept;
 
     /**
-     * @brief sweeps objects from a segment.
-     * @param seg - reference to a segment.
+     * @brief marks all objects that are reachable from the root-set-table.
+     * @param root_set - reference to a root-set-table
+     * @returns CPU time of the mark tasks in nanoseconds, summed over the gc threads.
     */
-    void sweep_segment(segment& seg) noexcept;
+    uint64_t mark(root_set_table& root_set) noexcept;
 
     /**
      * @brief sweeps the unmarked objects from heap.
      * @param heap_memory - reference to a heap.
+     * @returns CPU time of the sweep tasks in nanoseconds, summed over the gc threads.
+     * @details if census is taken, each segment counts its live objects into a partial census, partials are merged once all segments are swept.
     */
-    void sweep(heap& heap_memory) noexcept;
+    uint64_t sweep(heap& heap_memory) noexcept;
 
 public:
     /**
@@ -54,12 +97,23 @@ public:
      * @brief collects the garbage from the heap.
      * @param root_set - reference to a root-set-table.
      * @param heap_memory - reference to a heap.
+     * @param pause - reference to the pause of the cycle, mark and sweep wall and CPU times are stored into it.
     */
-    void collect(root_set_table& root_set, heap& heap_memory) noexcept;
+    void collect(root_set_table& root_set, heap& heap_memory, gc_pause& pause) noexcept;
+
+    /**
+     * @brief sweeps objects from a segment.
+     * @param seg - reference to a segment.
+     * @param census - pointer to the partial census of the segment, nullptr if census isn't taken.
+     * @returns number of visited blocks.
+     * @warning segment must be locked, also called on its own by the heap microbenchmarks.
+    */
+    size_t sweep_segment(segment& seg, live_census* census) noexcept;
 
     /**
      * @brief marks the objects on the stack.
      * @param stack - reference to a thread local stack.
+     * @details blocks of the open scope regions are marked as well.
     */
     void visit(thread_local_stack& stack) override final;
 
@@ -75,6 +129,31 @@ public:
     */
     void visit(register_root& reg) override final;
 
+    /**
+     * @brief getter for the hardware counters of the gc phases.
+     * @returns counters of the mark and sweep tasks, summed over the gc threads and all cycles.
+    */
+    gc_perf_counters get_perf_counters() const noexcept;
+
+    /**
+     * @brief getter for the number of gc threads.
+     * @returns number of threads that run the mark and sweep tasks.
+    */
+    size_t get_thread_count() const noexcept;
+
+    /**
+     * @brief enables or disables the live-object census, takes effect from the next gc cycle.
+     * @param enabled - true if the census is taken after marking, false otherwise.
+    */
+    void set_census_enabled(bool enabled) noexcept;
+
+    /**
+     * @brief getter for the live-object census.
+     * @returns census of the last gc cycle that took it, zeroed if no census was taken.
+     * @warning must not be called during the gc cycle.
+    */
+    const live_census& get_last_census() const noexcept;
+
 };
 
 #endif
\ No newline at end of file
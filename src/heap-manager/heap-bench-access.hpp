@@ -0,0 +1,141 @@
+#ifndef HEAP_BENCH_ACCESS_HPP
+#define HEAP_BENCH_ACCESS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "heap-manager.hpp"
+
+/**
+ * @class heap_bench_access
+ * @brief internal operations of the heap manager that microbenchmarks measure in isolation.
+ * @details only the listed operations are exposed, the benchmarks can't reach the rest of the private state.
+ * @warning heap must not be used by mutator or gc threads while the benchmark runs.
+*/
+class heap_bench_access {
+public:
+    /**
+     * @brief moves the time of the last gc to now, so neither periodic nor allocation triggered gc runs for MIN_GC_INTERVAL.
+     * @param heap_mng - reference to the benchmarked heap.
+    */
+    static void defer_gc(heap_manager& heap_mng) noexcept {
+        heap_mng.last_gc_time_ms.store(
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count(),
+            std::memory_order_release
+        );
+    }
+
+    /**
+     * @brief getter for the mutex of the root set.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @returns reference to the mutex.
+    */
+    static profiled_mutex& root_set_mutex(heap_manager& heap_mng) noexcept {
+        return heap_mng.root_set_mutex;
+    }
+
+    /**
+     * @brief getter for the lock of a segment.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @returns reference to the mutex of the segment.
+    */
+    static profiled_mutex& segment_lock(heap_manager& heap_mng, size_t segment_index) noexcept {
+        return heap_mng.segment_locks[segment_index];
+    }
+
+    /**
+     * @brief getter for a segment.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @returns reference to the segment.
+    */
+    static segment& get_segment(heap_manager& heap_mng, size_t segment_index) {
+        return heap_mng.get_segment(segment_index);
+    }
+
+    /**
+     * @brief getter for the object size category.
+     * @param bytes - size of the object.
+     * @returns category of the segments that serve the object.
+    */
+    static segment_category get_object_category(uint32_t bytes) noexcept {
+        return heap_manager::get_object_category(bytes);
+    }
+
+    /**
+     * @brief getter for the category of a segment.
+     * @param heap_mng - const reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @returns object size category the segment serves.
+    */
+    static segment_category get_segment_category(const heap_manager& heap_mng, size_t segment_index) {
+        return heap_mng.heap_memory.get_segment_category(segment_index);
+    }
+
+    /**
+     * @brief getter for the number of segments of a category.
+     * @param heap_mng - const reference to the benchmarked heap.
+     * @param category - object size category.
+     * @returns number of segments that serve the category.
+    */
+    static size_t get_category_segment_count(const heap_manager& heap_mng, segment_category category) {
+        return heap_mng.heap_memory.get_category_segment_count(category);
+    }
+
+    /**
+     * @brief turns the segment into a single free block.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @warning segment must be locked.
+    */
+    static void reset_segment(heap_manager& heap_mng, size_t segment_index) {
+        heap_mng.reset_segment(segment_index);
+    }
+
+    /**
+     * @brief allocates from the segment without the slow path.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @param bytes - number of bytes to allocate.
+     * @returns pointer to the header of the object, nullptr if the segment has no block that fits.
+     * @warning segment must be locked.
+    */
+    static header* allocate_from_segment(heap_manager& heap_mng, size_t segment_index, uint32_t bytes) {
+        return heap_mng.allocate_from_segment(segment_index, bytes);
+    }
+
+    /**
+     * @brief sweeps the unmarked objects from the segment.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @returns number of visited blocks.
+     * @warning segment must be locked.
+    */
+    static size_t sweep_segment(heap_manager& heap_mng, size_t segment_index) {
+        return heap_mng.gc.sweep_segment(heap_mng.get_segment(segment_index), nullptr);
+    }
+
+    /**
+     * @brief merges free blocks on the segment.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param segment_index - index of the segment.
+     * @warning segment must be locked.
+    */
+    static void coalesce_segment(heap_manager& heap_mng, size_t segment_index) {
+        heap_mng.coalesce_segment(segment_index);
+    }
+
+    /**
+     * @brief finds a segment that can store required bytes.
+     * @param heap_mng - reference to the benchmarked heap.
+     * @param bytes - number of bytes that need to be allocated.
+     * @returns index of the segment if segment can allocate enough bytes, -1 otherwise.
+    */
+    static int find_suitable_segment(heap_manager& heap_mng, uint32_t bytes) {
+        return heap_mng.find_suitable_segment(bytes);
+    }
+};
+
+#endif
\ No newline at end of file
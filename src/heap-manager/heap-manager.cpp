@@ -1,103 +1,390 @@
 #include "heap-manager.hpp"
 
+#include <algorithm>
 #include <condition_variable>
 #include <latch>
 
-heap_manager::heap_manager(size_t hm_thread_count, size_t gc_thread_count) 
+#include "../root-set-table/global-root.hpp"
+#include "../alloc-trace/alloc-trace.hpp"
+
+std::atomic<uint64_t> heap_manager::next_instance_id{0};
+
+heap_manager::heap_manager(size_t hm_thread_count, size_t gc_thread_count, allocation_policy policy) 
     : heap_manager_thread_pool(hm_thread_count), 
       gc(gc_thread_count), 
+      policy(policy), 
+      instance_id(next_instance_id.fetch_add(1, std::memory_order_relaxed)), 
       gc_timer_thread([this](std::stop_token st) -> void {periodic_gc_loop(st); }) {
 
     auto now = std::chrono::high_resolution_clock::now();
     last_gc_time_ms.store(std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count(), std::memory_order_release);
 
-    for(size_t i = 0; i < SMALL_OBJECT_SEGMENTS; ++i) {
-        segment& segment = heap_memory.get_small_object_segment(i);
-        header* initial_header = reinterpret_cast<header*>(segment.segment_memory);
-        free_memory_table.update_segment(i, initial_header, segment.free_memory);
-    }
-
-    for(size_t i = 0; i < MEDIUM_OBJECT_SEGMENTS; ++i) {
-        segment& segment = heap_memory.get_medium_object_segment(i);
-        header* initial_header = reinterpret_cast<header*>(segment.segment_memory);
-        free_memory_table.update_segment(SMALL_OBJECT_SEGMENTS + i, initial_header, segment.free_memory);
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i) {
+        segment_locks[i].set_name("segment_locks", i);
+        reset_segment(i);
     }
 
-    for(size_t i = 0; i < LARGE_OBJECT_SEGMENTS; ++i) {
-        segment& segment = heap_memory.get_large_object_segment(i);
-        header* initial_header = reinterpret_cast<header*>(segment.segment_memory);
-        free_memory_table.update_segment(SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS + i, initial_header, segment.free_memory);
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        latency_histograms = std::make_unique<allocation_latency_histograms[]>(MAX_MUTATOR_THREADS);
     }
 }
 
-header* heap_manager::allocate(uint32_t bytes){
+header* heap_manager::allocate(uint32_t bytes, allocation_site site){
     if(bytes == 0) return nullptr;
     bytes = (bytes + 15) & ~15;
 
-    int segment_index = find_suitable_segment(bytes);
-    if(segment_index >= 0){
-        std::lock_guard<std::mutex> seg_lock(segment_locks[segment_index]);
-        if(header* obj = allocate_from_segment(static_cast<size_t>(segment_index), bytes))
-            return obj;
+    std::chrono::steady_clock::time_point start_time{};
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    if(header* obj = try_allocate(bytes)){
+        mutator_context& mutator = current_mutator();
+        record_latency(mutator, allocation_path::fast_path, start_time);
+        sample_allocation(mutator, obj, bytes, site);
+        alloc_trace::record_alloc(obj, bytes);
+        return obj;
     }
+
+    trace_scope slow_path_trace("allocation slow path", "allocation");
+    const size_t category = static_cast<size_t>(get_object_category(bytes));
+    mutator_context& mutator = current_mutator();
+    mutator.category_slow_path_entries[category].fetch_add(1, std::memory_order_relaxed);
     
+    bool waited_for_gc = false;
     if(should_run_gc()){
         bool expected = false;
         if(gc_in_progress.compare_exchange_strong(expected, true, std::memory_order_acq_rel)){
             collect_garbage();
             gc_in_progress.store(false, std::memory_order_release);
             gc_in_progress.notify_all();
+            waited_for_gc = true;
         }
     }
 
-    while(gc_in_progress.load(std::memory_order_acquire)){
-        gc_in_progress.wait(true);
+    if(gc_in_progress.load(std::memory_order_acquire)){
+        trace_scope gc_wait_trace("gc wait", "allocation");
+        while(gc_in_progress.load(std::memory_order_acquire)){
+            gc_in_progress.wait(true);
+            waited_for_gc = true;
+        }
+    }
+
+    header* obj = try_allocate(bytes);
+    if(!obj){
+        mutator.category_failures[category].fetch_add(1, std::memory_order_relaxed);
+    }
+    record_latency(mutator, waited_for_gc ? allocation_path::gc_wait : allocation_path::slow_path, start_time);
+    sample_allocation(mutator, obj, bytes, site);
+    alloc_trace::record_alloc(obj, bytes);
+    return obj;
+}
+
+header* heap_manager::allocate_in_scope(thread_local_stack& tls, uint32_t bytes, allocation_site site){
+    if(bytes == 0) return nullptr;
+    bytes = (bytes + 15) & ~15;
+
+    if(bytes > REGION_OBJECT_THRESHOLD || !tls.has_region()){
+        return allocate(bytes, site);
     }
 
-    segment_index = find_suitable_segment(bytes);
+    std::chrono::steady_clock::time_point start_time{};
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    int segment_index = tls.region_segment();
     if(segment_index >= 0){
-        std::lock_guard<std::mutex> seg_lock(segment_locks[segment_index]);
-        return allocate_from_segment(static_cast<size_t>(segment_index), bytes);
+        std::lock_guard<profiled_mutex> seg_lock(segment_locks[segment_index]);
+        if(header* obj = tls.region_allocate(bytes)){
+            mutator_context& mutator = current_mutator();
+            record_allocation(mutator, bytes);
+            record_latency(mutator, allocation_path::fast_path, start_time);
+            sample_allocation(mutator, obj, bytes, site);
+            alloc_trace::record_alloc_in_scope(tls.get_trace_id(), obj, bytes);
+            return obj;
+        }
     }
 
-    return nullptr;
+    segment_index = find_suitable_segment(REGION_CHUNK_SIZE - static_cast<uint32_t>(sizeof(header)));
+    if(segment_index >= 0){
+        std::lock_guard<profiled_mutex> seg_lock(segment_locks[segment_index]);
+        if(header* chunk = allocate_from_segment(static_cast<size_t>(segment_index), REGION_CHUNK_SIZE - static_cast<uint32_t>(sizeof(header)))){
+            region_chunk_bytes[segment_index].fetch_add(chunk->size + static_cast<uint32_t>(sizeof(header)), std::memory_order_relaxed);
+            if(!tls.add_region_chunk(static_cast<size_t>(segment_index), chunk, *this)){
+                region_chunk unused{.segment_index = static_cast<size_t>(segment_index), .begin = chunk, .tail = nullptr, .size = chunk->size};
+                release_region_chunk(unused, false);
+            }
+            else if(header* obj = tls.region_allocate(bytes)){
+                mutator_context& mutator = current_mutator();
+                record_allocation(mutator, bytes);
+                record_latency(mutator, allocation_path::slow_path, start_time);
+                sample_allocation(mutator, obj, bytes, site);
+                alloc_trace::record_alloc_in_scope(tls.get_trace_id(), obj, bytes);
+                return obj;
+            }
+        }
+    }
+
+    return allocate(bytes, site);
+}
+
+heap_manager::~heap_manager(){
+    clear_roots();
+}
+
+void heap_manager::pop_region_scope(thread_local_stack& tls, bool destr){
+    const uint64_t segment_mask = tls.region_segment_mask();
+
+    std::unique_lock<profiled_mutex> locks[TOTAL_SEGMENTS];
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        if(segment_mask & (uint64_t{1} << i)){
+            locks[i] = std::unique_lock<profiled_mutex>(segment_locks[i]);
+        }
+    }
+
+    if(!destr){
+        alloc_trace::record_scope_pop(tls.get_trace_id(), true);
+    }
+    scope_region region = tls.pop_region_scope();
+    release_region(region);
+}
+
+indexed_stack<mutator_stats> heap_manager::get_mutator_stats() const {
+    indexed_stack<mutator_stats> stats;
+    const size_t count = std::min(get_registered_mutator_count(), MAX_MUTATOR_THREADS);
+
+    for(size_t i = 0; i < count; ++i){
+        const mutator_context& mutator = mutators[i];
+        stats.push(mutator_stats{
+            .slot = i,
+            .allocations = mutator.allocations.load(std::memory_order_relaxed),
+            .home_hits = mutator.home_hits.load(std::memory_order_relaxed),
+            .lock_attempts = mutator.lock_attempts.load(std::memory_order_relaxed),
+            .contended_locks = mutator.contended_locks.load(std::memory_order_relaxed)
+        });
+    }
+
+    return stats;
+}
+
+heap_stats heap_manager::stats(){
+    heap_stats snapshot{};
+    const size_t mutator_count = std::min(get_registered_mutator_count(), MAX_MUTATOR_THREADS);
+
+    for(size_t i = 0; i < mutator_count; ++i){
+        const mutator_context& mutator = mutators[i];
+        for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+            category_stats& category = snapshot.categories[c];
+            category.allocations += mutator.category_allocations[c].load(std::memory_order_relaxed);
+            category.allocated_bytes += mutator.category_bytes[c].load(std::memory_order_relaxed);
+            category.slow_path_entries += mutator.category_slow_path_entries[c].load(std::memory_order_relaxed);
+            category.failures += mutator.category_failures[c].load(std::memory_order_relaxed);
+        }
+    }
+
+    snapshot.gc_count = gc_count.load(std::memory_order_acquire);
+    snapshot.live_bytes_after_gc = live_bytes_after_gc.load(std::memory_order_acquire);
+
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        std::lock_guard<profiled_mutex> seg_lock(segment_locks[i]);
+        segment_stats& segment = snapshot.segments[i];
+        segment.category = heap_memory.get_segment_category(i);
+        segment.fragmentation = segment_fragmentation[i];
+        segment.region_chunk_bytes = region_chunk_bytes[i].load(std::memory_order_relaxed);
+
+        const segment_info* seg_info = free_memory_table.get_segment_info(i);
+        if(!seg_info) continue;
+
+        segment.free_bytes = seg_info->free_bytes;
+    }
+
+    return snapshot;
+}
+
+allocation_latency_summary heap_manager::get_allocation_latency() const {
+    if(!latency_histograms) return allocation_latency_summary{};
+
+    allocation_latency_histograms merged;
+    latency_histogram all;
+    const size_t count = std::min(get_registered_mutator_count(), MAX_MUTATOR_THREADS);
+
+    for(size_t i = 0; i < count; ++i){
+        merged.fast_path.merge(latency_histograms[i].fast_path);
+        merged.slow_path.merge(latency_histograms[i].slow_path);
+        merged.gc_wait.merge(latency_histograms[i].gc_wait);
+    }
+    all.merge(merged.fast_path);
+    all.merge(merged.slow_path);
+    all.merge(merged.gc_wait);
+
+    return allocation_latency_summary{
+        .fast_path = merged.fast_path.summarize(),
+        .slow_path = merged.slow_path.summarize(),
+        .gc_wait = merged.gc_wait.summarize(),
+        .all = all.summarize()
+    };
+}
+
+void heap_manager::reset_allocation_latency() noexcept {
+    if(!latency_histograms) return;
+    for(size_t i = 0; i < MAX_MUTATOR_THREADS; ++i){
+        latency_histograms[i].fast_path.clear();
+        latency_histograms[i].slow_path.clear();
+        latency_histograms[i].gc_wait.clear();
+    }
+}
+
+indexed_stack<gc_pause> heap_manager::get_gc_pauses(uint64_t since_ns){
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+    indexed_stack<gc_pause> pauses;
+    for(const gc_pause& pause : gc_pauses){
+        if(pause.start_ns >= since_ns){
+            pauses.push(pause);
+        }
+    }
+    return pauses;
+}
+
+void heap_manager::set_sampling_interval(uint64_t interval){
+    sampler.set_sampling_interval(interval);
+    for(mutator_context& mutator : mutators){
+        mutator.bytes_until_sample.store(sampler.next_sample_distance(), std::memory_order_relaxed);
+    }
+}
+
+indexed_stack<allocation_site_stats> heap_manager::get_allocation_sites(){
+    return sampler.get_site_stats();
+}
+
+bool heap_manager::write_allocation_profile(const std::string& path){
+    return sampler.write_pprof(path);
+}
+
+gc_perf_counters heap_manager::get_gc_perf_counters() const noexcept {
+    return gc.get_perf_counters();
+}
+
+void heap_manager::set_heap_limit(uint64_t bytes) noexcept {
+    const uint64_t segment_limit = bytes == 0 ? SEGMENT_SIZE : std::clamp<uint64_t>(bytes / TOTAL_SEGMENTS, MIN_SEGMENT_HEAP_LIMIT, SEGMENT_SIZE);
+    segment_reserve.store(SEGMENT_SIZE - static_cast<uint32_t>(segment_limit), std::memory_order_relaxed);
+}
+
+uint64_t heap_manager::get_heap_limit() const noexcept {
+    return static_cast<uint64_t>(SEGMENT_SIZE - segment_reserve.load(std::memory_order_relaxed)) * TOTAL_SEGMENTS;
+}
+
+void heap_manager::set_census_enabled(bool enabled) noexcept {
+    gc.set_census_enabled(enabled);
+}
+
+live_census heap_manager::get_live_census(){
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+    return gc.get_last_census();
+}
+
+size_t heap_manager::get_registered_mutator_count() const noexcept {
+    return registered_mutators.load(std::memory_order_acquire);
+}
+
+size_t heap_manager::get_gc_thread_count() const noexcept {
+    return gc.get_thread_count();
+}
+
+size_t heap_manager::get_coalesce_thread_count() const noexcept {
+    return heap_manager_thread_pool.get_thread_count();
 }
 
 void heap_manager::add_root(std::string key, std::unique_ptr<root_set_base> base){
-    std::lock_guard<std::mutex> root_set_lock(root_set_mutex);
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+    if(base && alloc_trace::is_recording()){
+        const root_kind kind = dynamic_cast<thread_local_stack*>(base.get()) ? root_kind::tls 
+            : dynamic_cast<global_root*>(base.get()) ? root_kind::global : root_kind::reg;
+        base->set_trace_id(alloc_trace::record_root_add(kind));
+    }
     root_set.add_root(std::move(key), std::move(base));
 }
 
 root_set_base* heap_manager::get_root(const std::string& key) {
-    std::lock_guard<std::mutex> root_set_lock(root_set_mutex);
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
     return root_set.get_root(key);
 }
 
 void heap_manager::remove_root(const std::string& key){
-    std::lock_guard<std::mutex> root_set_lock(root_set_mutex);
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+    if(root_set_base* root = root_set.get_root(key)){
+        alloc_trace::record_root_remove(root->get_trace_id());
+    }
     root_set.remove_root(key);
 }
 
 void heap_manager::clear_roots() noexcept {
-    std::lock_guard<std::mutex> root_set_lock(root_set_mutex);
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
     root_set.clear();
 }
 
+void heap_manager::reset(){
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+    alloc_trace::record_reset();
+    // thread stacks release their regions when they're destroyed, which locks the segments of the regions
+    root_set.clear();
+
+    std::unique_lock<profiled_mutex> locks[TOTAL_SEGMENTS];
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        locks[i] = std::unique_lock<profiled_mutex>(segment_locks[i]);
+    }
+
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        reset_segment(i);
+    }
+    sampler.clear_live_samples();
+}
+
 void heap_manager::collect_garbage(){
     last_gc_time_ms.store(
         std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::high_resolution_clock::now().time_since_epoch()
         ).count(),std::memory_order_release
     );
-    std::lock_guard<std::mutex> root_set_lock(root_set_mutex);
+    trace_scope gc_trace("gc", "gc");
+    gc_pause pause{};
+    pause.start_ns = gc_pause_report::clock_ns();
+    pause.periodic = std::this_thread::get_id() == gc_timer_thread.get_id();
+    const uint64_t collector_cpu_start_ns = gc_pause_report::thread_cpu_ns();
+
+    tracer::record("lock acquisition", "gc", trace_phase::begin);
+    std::lock_guard<profiled_mutex> root_set_lock(root_set_mutex);
+
+    std::unique_lock<profiled_mutex> locks[TOTAL_SEGMENTS];
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        locks[i] = std::unique_lock<profiled_mutex>(segment_locks[i]);
+    }
+    pause.lock_acquire_ns = gc_pause_report::clock_ns() - pause.start_ns;
+    tracer::record("lock acquisition", "gc", trace_phase::end);
+
+    gc.collect(root_set, heap_memory, pause);
+    sampler.after_gc();
+
+    const uint64_t coalesce_start_ns = gc_pause_report::clock_ns();
+    {
+        trace_scope coalesce_trace("coalesce", "gc");
+        pause.coalesce_cpu_ns = coalesce_segments();
+    }
+    pause.coalesce_ns = gc_pause_report::clock_ns() - coalesce_start_ns;
 
-    std::unique_lock<std::mutex> locks[TOTAL_SEGMENTS];
+    uint64_t live_bytes = 0;
     for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
-        locks[i] = std::unique_lock<std::mutex>(segment_locks[i]);
+        const segment_info* seg_info = free_memory_table.get_segment_info(i);
+        live_bytes += SEGMENT_SIZE - (seg_info ? seg_info->free_bytes : 0);
     }
+    live_bytes_after_gc.store(live_bytes, std::memory_order_release);
+    gc_count.fetch_add(1, std::memory_order_acq_rel);
 
-    gc.collect(root_set, heap_memory);
-    coalesce_segments();
+    rebalance_segments();
+
+    pause.total_ns = gc_pause_report::clock_ns() - pause.start_ns;
+    pause.collector_cpu_ns = gc_pause_report::thread_cpu_ns() - collector_cpu_start_ns;
+    gc_pauses.push(pause);
 }
 
 bool heap_manager::should_run_gc() const noexcept {
@@ -129,83 +416,184 @@ void heap_manager::periodic_gc_loop(std::stop_token stop_token){
     }
 }
 
-size_t heap_manager::get_segment_category_index(size_t segment_index) const noexcept {
-    if(segment_index < SMALL_OBJECT_SEGMENTS){
-        return segment_index;
-    } 
-    else if(segment_index < SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS){
-        return segment_index - SMALL_OBJECT_SEGMENTS;
-    }
-    else{
-        return segment_index - SMALL_OBJECT_SEGMENTS - MEDIUM_OBJECT_SEGMENTS;
-    }
+segment& heap_manager::get_segment(size_t segment_index){
+    return heap_memory.get_segment(segment_index);
 }
 
-segment& heap_manager::get_segment(size_t segment_index){
-    if(segment_index < SMALL_OBJECT_SEGMENTS){
-        return heap_memory.get_small_object_segment(segment_index);
-    }
-    else if(segment_index < SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS){
-        return heap_memory.get_medium_object_segment(segment_index - SMALL_OBJECT_SEGMENTS);
+segment_category heap_manager::get_object_category(uint32_t bytes) noexcept {
+    if(bytes <= SMALL_OBJECT_THRESHOLD){
+        return segment_category::small;
     }
-    else{
-        return heap_memory.get_large_object_segment(segment_index - SMALL_OBJECT_SEGMENTS - MEDIUM_OBJECT_SEGMENTS);
+    else if(bytes <= MEDIUM_OBJECT_THRESHOLD){
+        return segment_category::medium;
     }
+    return segment_category::large;
 }
 
-int heap_manager::find_suitable_segment(uint32_t bytes) noexcept {
-    size_t start_idx{}, end_idx{};
-    std::atomic<size_t>* last_segment_idx;
-    int fallback_segment_idx = -1;
-    uint32_t fallback_segment_size = 0;
+mutator_context& heap_manager::current_mutator() noexcept {
+    thread_local uint64_t cached_instance_id = UINT64_MAX;
+    thread_local mutator_context* cached_mutator = nullptr;
 
-    if(bytes <= SMALL_OBJECT_THRESHOLD){
-        start_idx = 0;
-        end_idx = SMALL_OBJECT_SEGMENTS;
-        last_segment_idx = &last_small_segment;
+    if(cached_instance_id != instance_id){
+        const size_t slot = registered_mutators.fetch_add(1, std::memory_order_acq_rel);
+        cached_mutator = &mutators[slot % MAX_MUTATOR_THREADS];
+        if(slot < MAX_MUTATOR_THREADS){
+            cached_mutator->slot = slot;
+            cached_mutator->bytes_until_sample.store(sampler.next_sample_distance(), std::memory_order_relaxed);
+        }
+        cached_instance_id = instance_id;
     }
-    else if(bytes <= MEDIUM_OBJECT_THRESHOLD){
-        start_idx = SMALL_OBJECT_SEGMENTS;
-        end_idx = SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS;
-        last_segment_idx = &last_medium_segment;
+    return *cached_mutator;
+}
+
+int heap_manager::get_home_segment(segment_category category, size_t slot) const {
+    const size_t segment_count = heap_memory.get_category_segment_count(category);
+    if(segment_count == 0) return -1;
+
+    size_t home = slot % segment_count;
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        if(heap_memory.get_segment_category(i) != category) continue;
+        if(home-- == 0) return static_cast<int>(i);
     }
-    else {
-        start_idx = SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS;
-        end_idx = SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS + LARGE_OBJECT_SEGMENTS;
-        last_segment_idx = &last_large_segment;
+    return -1;
+}
+
+int heap_manager::find_suitable_segment(uint32_t bytes, uint64_t skipped_segments){
+    const segment_category category = get_object_category(bytes);
+    std::atomic<size_t>& last_segment_idx = last_category_segment[static_cast<size_t>(category)];
+    const uint64_t required_bytes = uint64_t{bytes} + sizeof(header) + segment_reserve.load(std::memory_order_relaxed);
+
+    if(policy == allocation_policy::thread_affinity){
+        const int home = get_home_segment(category, current_mutator().slot);
+        if(home >= 0 && !(skipped_segments & (uint64_t{1} << home))){
+            const segment_info* seg_info = free_memory_table.get_segment_info(static_cast<size_t>(home));
+            if(seg_info && std::atomic_ref<const uint32_t>(seg_info->free_bytes).load(std::memory_order_acquire) >= required_bytes){
+                return home;
+            }
+        }
     }
 
-    const size_t segment_count = end_idx - start_idx;
-    size_t last_used = last_segment_idx->load(std::memory_order_acquire); 
-    size_t start_offset = (last_used >= start_idx && last_used < end_idx) ? (last_used - start_idx) : 0;
+    size_t candidates[TOTAL_SEGMENTS];
+    uint32_t candidate_free_bytes[TOTAL_SEGMENTS];
+    size_t candidate_count = 0;
+
+    const size_t last_used = policy == allocation_policy::round_robin ? last_segment_idx.load(std::memory_order_acquire) % TOTAL_SEGMENTS : TOTAL_SEGMENTS - 1;
 
-    for(size_t offset = 0; offset < segment_count; ++offset){
-        size_t relative_idx = (start_offset + offset + 1) % segment_count;
-        size_t idx = start_idx + relative_idx;
+    for(size_t offset = 0; offset < TOTAL_SEGMENTS; ++offset){
+        size_t idx = (last_used + offset + 1) % TOTAL_SEGMENTS;
+        if(skipped_segments & (uint64_t{1} << idx)) continue;
+        if(heap_memory.get_segment_category(idx) != category) continue;
 
         const segment_info* seg_info = free_memory_table.get_segment_info(idx);
         if(!seg_info) continue;
 
         const uint32_t free_bytes = std::atomic_ref<const uint32_t>(seg_info->free_bytes).load(std::memory_order_acquire);
-        if(free_bytes < bytes + sizeof(header)) continue;
-        
-        if(fallback_segment_idx == -1 || fallback_segment_size < free_bytes){
-            fallback_segment_idx = idx;
-            fallback_segment_size = free_bytes;
+        if(free_bytes < required_bytes) continue;
+
+        size_t position = candidate_count++;
+        if(policy != allocation_policy::round_robin){
+            for(; position > 0 && candidate_free_bytes[position - 1] > free_bytes; --position){
+                candidates[position] = candidates[position - 1];
+                candidate_free_bytes[position] = candidate_free_bytes[position - 1];
+            }
         }
+        candidates[position] = idx;
+        candidate_free_bytes[position] = free_bytes;
+    }
 
-        std::unique_lock<std::mutex> segment_lock(segment_locks[idx], std::try_to_lock);
+    if(candidate_count == 0) return -1;
+
+    for(size_t i = 0; i < candidate_count; ++i){
+        std::unique_lock<profiled_mutex> segment_lock(segment_locks[candidates[i]], std::try_to_lock);
         if(!segment_lock.owns_lock()) continue;
 
-        last_segment_idx->store(idx, std::memory_order_release);
-        return static_cast<int>(idx);
+        if(policy == allocation_policy::round_robin){
+            last_segment_idx.store(candidates[i], std::memory_order_release);
+        }
+        return static_cast<int>(candidates[i]);
     }
 
-    if(fallback_segment_idx != -1){
-        last_segment_idx->store(static_cast<size_t>(fallback_segment_idx), std::memory_order_release);
+    size_t fallback = 0;
+    if(policy == allocation_policy::round_robin){
+        for(size_t i = 1; i < candidate_count; ++i){
+            if(candidate_free_bytes[i] > candidate_free_bytes[fallback]){
+                fallback = i;
+            }
+        }
+        last_segment_idx.store(candidates[fallback], std::memory_order_release);
+    }
+
+    return static_cast<int>(candidates[fallback]);
+}
+
+void heap_manager::record_latency(const mutator_context& mutator, allocation_path path, std::chrono::steady_clock::time_point start_time) noexcept {
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        const uint64_t elapsed_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count());
+        allocation_latency_histograms& histograms = latency_histograms[mutator.slot];
+
+        switch(path){
+            case allocation_path::fast_path:
+                histograms.fast_path.record(elapsed_ns);
+                break;
+            case allocation_path::slow_path:
+                histograms.slow_path.record(elapsed_ns);
+                break;
+            case allocation_path::gc_wait:
+                histograms.gc_wait.record(elapsed_ns);
+                break;
+        }
+    }
+    else {
+        (void)mutator;
+        (void)path;
+        (void)start_time;
+    }
+}
+
+void heap_manager::sample_allocation(mutator_context& mutator, header* obj, uint32_t bytes, const allocation_site& site){
+    if(!obj || !sampler.is_enabled()) return;
+
+    const int64_t remaining = mutator.bytes_until_sample.load(std::memory_order_relaxed) - static_cast<int64_t>(bytes);
+    if(remaining > 0){
+        mutator.bytes_until_sample.store(remaining, std::memory_order_relaxed);
+        return;
+    }
+
+    sampler.record(obj, bytes, site);
+    mutator.bytes_until_sample.store(sampler.next_sample_distance(), std::memory_order_relaxed);
+}
+
+void heap_manager::record_allocation(mutator_context& mutator, uint32_t bytes) noexcept {
+    const size_t category = static_cast<size_t>(get_object_category(bytes));
+    mutator.allocations.fetch_add(1, std::memory_order_relaxed);
+    mutator.category_allocations[category].fetch_add(1, std::memory_order_relaxed);
+    mutator.category_bytes[category].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+header* heap_manager::try_allocate(uint32_t bytes){
+    mutator_context& mutator = current_mutator();
+    uint64_t tried_segments = 0;
+
+    for(int segment_index = find_suitable_segment(bytes); segment_index >= 0; segment_index = find_suitable_segment(bytes, tried_segments)){
+        mutator.lock_attempts.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<profiled_mutex> seg_lock(segment_locks[segment_index], std::try_to_lock);
+        if(!seg_lock.owns_lock()){
+            mutator.contended_locks.fetch_add(1, std::memory_order_relaxed);
+            seg_lock.lock();
+        }
+
+        if(header* obj = allocate_from_segment(static_cast<size_t>(segment_index), bytes)){
+            record_allocation(mutator, bytes);
+            if(policy == allocation_policy::thread_affinity && segment_index == get_home_segment(get_object_category(bytes), mutator.slot)){
+                mutator.home_hits.fetch_add(1, std::memory_order_relaxed);
+            }
+            return obj;
+        }
+        if(policy == allocation_policy::round_robin) break;
+        tried_segments |= uint64_t{1} << segment_index;
     }
 
-    return fallback_segment_idx;
+    return nullptr;
 }
 
 header* heap_manager::allocate_from_segment(size_t segment_index, uint32_t bytes){
@@ -235,15 +623,13 @@ header* heap_manager::allocate_from_segment(size_t segment_index, uint32_t bytes
         
         new_header->size = remaining - static_cast<uint32_t>(sizeof(header));
         new_header->next = current->next;
-        new_header->set_free(true);
-        new_header->set_marked(false);
+        new_header->reset_flags(true);
 
         current->size = bytes;
         current->next = new_header;
     }
 
-    current->set_free(false);
-    current->set_marked(false);
+    current->reset_flags(false);
 
     if(prev){
         prev->next = current->next;
@@ -257,6 +643,73 @@ header* heap_manager::allocate_from_segment(size_t segment_index, uint32_t bytes
     return current;
 }
 
+void heap_manager::release_region(scope_region& region){
+    const bool escaped = region.escaped();
+    for(region_chunk& chunk : region.get_chunks()){
+        release_region_chunk(chunk, escaped);
+    }
+}
+
+void heap_manager::release_region_chunk(region_chunk& chunk, bool escaped){
+    segment_info* seg_info = free_memory_table.get_segment_info(chunk.segment_index);
+    if(!seg_info) return;
+    region_chunk_bytes[chunk.segment_index].fetch_sub(chunk.size + static_cast<uint32_t>(sizeof(header)), std::memory_order_relaxed);
+
+    fragmentation_stats& fragmentation = segment_fragmentation[chunk.segment_index];
+    auto push_free_block = [seg_info, &fragmentation](header* hdr) -> void {
+        hdr->reset_flags(true);
+        hdr->next = seg_info->free_list_head;
+        seg_info->free_list_head = hdr;
+        seg_info->free_bytes += hdr->size + static_cast<uint32_t>(sizeof(header));
+        fragmentation.add_free_block(hdr->size);
+    };
+
+    if(!escaped){
+        chunk.begin->size = chunk.size;
+        push_free_block(chunk.begin);
+        return;
+    }
+
+    uint8_t* current_ptr = reinterpret_cast<uint8_t*>(chunk.begin);
+    const uint8_t* end_ptr = current_ptr + sizeof(header) + static_cast<size_t>(chunk.size);
+    header* free_run = nullptr;
+
+    while(current_ptr < end_ptr){
+        header* hdr = reinterpret_cast<header*>(current_ptr);
+        current_ptr += sizeof(header) + static_cast<size_t>(hdr->size);
+
+        if(hdr->is_escaped()){
+            if(free_run){
+                push_free_block(free_run);
+                free_run = nullptr;
+            }
+            hdr->reset_flags(false);
+        }
+        else if(free_run){
+            free_run->size += static_cast<uint32_t>(sizeof(header)) + hdr->size;
+        }
+        else {
+            free_run = hdr;
+        }
+    }
+
+    if(free_run){
+        push_free_block(free_run);
+    }
+}
+
+void heap_manager::reset_segment(size_t segment_index){
+    segment& seg = get_segment(segment_index);
+    seg.initialize();
+
+    header* initial_header = reinterpret_cast<header*>(seg.segment_memory);
+    free_memory_table.update_segment(segment_index, initial_header, seg.free_memory + static_cast<uint32_t>(sizeof(header)));
+
+    segment_fragmentation[segment_index] = fragmentation_stats{};
+    segment_fragmentation[segment_index].add_free_block(initial_header->size);
+    region_chunk_bytes[segment_index].store(0, std::memory_order_relaxed);
+}
+
 void heap_manager::coalesce_segment(size_t segment_index){
     segment& seg = get_segment(segment_index);
     segment_info* seg_info = free_memory_table.get_segment_info(segment_index);
@@ -265,6 +718,7 @@ void heap_manager::coalesce_segment(size_t segment_index){
 
     header* free_list = nullptr;
     uint32_t free_bytes = 0;
+    fragmentation_stats fragmentation{};
 
     uint8_t* current_ptr = seg.segment_memory;
     uint8_t* end_ptr = seg.segment_memory + SEGMENT_SIZE;
@@ -289,26 +743,101 @@ void heap_manager::coalesce_segment(size_t segment_index){
             hdr->next = free_list;
             free_list = hdr;
             free_bytes += hdr->size + sizeof(header);
+            fragmentation.add_free_block(hdr->size);
         }
 
         current_ptr = current_ptr + sizeof(header) + static_cast<size_t>(hdr->size);
     }
 
+    segment_fragmentation[segment_index] = fragmentation;
     seg_info->free_list_head = free_list;
     std::atomic_ref<uint32_t>(seg_info->free_bytes).store(free_bytes, std::memory_order_release);
 }
 
-void heap_manager::coalesce_segments(){
-    if constexpr (TOTAL_SEGMENTS == 0) return;
+void heap_manager::rebalance_segments(){
+    uint64_t failures[SEGMENT_CATEGORY_COUNT]{};
+    size_t segment_counts[SEGMENT_CATEGORY_COUNT]{};
+    uint64_t free_bytes[SEGMENT_CATEGORY_COUNT]{};
+    double occupancy[SEGMENT_CATEGORY_COUNT]{};
+
+    const size_t mutator_count = std::min(get_registered_mutator_count(), MAX_MUTATOR_THREADS);
+    for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+        uint64_t slow_path_entries = 0;
+        for(size_t i = 0; i < mutator_count; ++i){
+            slow_path_entries += mutators[i].category_slow_path_entries[c].load(std::memory_order_relaxed);
+        }
+        failures[c] = slow_path_entries - rebalanced_slow_path_entries[c];
+        rebalanced_slow_path_entries[c] = slow_path_entries;
+    }
+
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        const size_t c = static_cast<size_t>(heap_memory.get_segment_category(i));
+        const segment_info* seg_info = free_memory_table.get_segment_info(i);
+        ++segment_counts[c];
+        free_bytes[c] += (seg_info ? seg_info->free_bytes : 0) + region_chunk_bytes[i].load(std::memory_order_relaxed);
+    }
+
+    for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+        occupancy[c] = segment_counts[c] == 0 ? 1.0 
+            : 1.0 - static_cast<double>(free_bytes[c]) / (static_cast<double>(segment_counts[c]) * SEGMENT_SIZE);
+    }
+
+    int target = -1;
+    for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+        if(failures[c] == 0) continue;
+        if(target == -1 || failures[c] > failures[target] || (failures[c] == failures[target] && occupancy[c] > occupancy[target])){
+            target = static_cast<int>(c);
+        }
+    }
+
+    if(target == -1){
+        for(size_t c = 0; c < SEGMENT_CATEGORY_COUNT; ++c){
+            if(occupancy[c] < SEGMENT_REPURPOSE_OCCUPANCY) continue;
+            if(target == -1 || occupancy[c] > occupancy[target]){
+                target = static_cast<int>(c);
+            }
+        }
+    }
+
+    if(target == -1) return;
+
+    int donor_idx = -1;
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
+        const size_t c = static_cast<size_t>(heap_memory.get_segment_category(i));
+        if(static_cast<int>(c) == target || segment_counts[c] <= 1) continue;
+        if(failures[c] == failures[target] && occupancy[c] >= occupancy[target]) continue;
+
+        const segment_info* seg_info = free_memory_table.get_segment_info(i);
+        if(!seg_info || seg_info->free_bytes != SEGMENT_SIZE) continue;
+
+        if(donor_idx == -1 || occupancy[c] < occupancy[static_cast<size_t>(heap_memory.get_segment_category(donor_idx))]){
+            donor_idx = static_cast<int>(i);
+        }
+    }
+
+    if(donor_idx != -1){
+        heap_memory.set_segment_category(static_cast<size_t>(donor_idx), static_cast<segment_category>(target));
+    }
+}
+
+uint64_t heap_manager::coalesce_segments(){
+    if constexpr (TOTAL_SEGMENTS == 0) return 0;
     
     std::latch completion_latch{TOTAL_SEGMENTS};
+    std::atomic<uint64_t> task_cpu_ns{0};
 
     for(size_t i = 0; i < TOTAL_SEGMENTS; ++i){
         heap_manager_thread_pool.enqueue([&, i] -> void {
-            coalesce_segment(i);
+            const uint64_t task_cpu_start_ns = gc_pause_report::thread_cpu_ns();
+            {
+                trace_scope task_trace("coalesce segment", "gc task");
+                coalesce_segment(i);
+            }
+            task_cpu_ns.fetch_add(gc_pause_report::thread_cpu_ns() - task_cpu_start_ns, std::memory_order_relaxed);
             completion_latch.count_down();
         });
     }
 
     completion_latch.wait();
+    return task_cpu_ns.load(std::memory_order_acquire);
 }
\ No newline at end of file
@@ -13,6 +13,18 @@
 #include "../segment-free-memory-table/segment-free-memory-table.hpp"
 #include "../root-set-table/root-set-table.hpp"
 #include "../garbage-collector/gc.hpp"
+#include "../root-set-table/thread-local-stack.hpp"
+#include "../common/scope-region/scope-region.hpp"
+#include "../common/scope-region/region-releaser.hpp"
+#include "../common/mutator/mutator-context.hpp"
+#include "../common/stats/heap-stats.hpp"
+#include "../common/latency-histogram/latency-histogram.hpp"
+#include "../common/gc-pause/gc-pause.hpp"
+#include "../common/trace/trace.hpp"
+#include "../common/profiled-mutex/profiled-mutex.hpp"
+#include "../common/allocation-site/allocation-site.hpp"
+#include "../allocation-sampler/allocation-sampler.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
 
 /// maximum small object size in bytes (up to 256B).
 constexpr uint32_t SMALL_OBJECT_THRESHOLD = 256;
@@ -23,17 +35,45 @@ constexpr uint32_t MEDIUM_OBJECT_THRESHOLD = 2 * 1024;
 /// maximum large object size in bytes (up to 256KB).
 constexpr uint32_t LARGE_OBJECT_THRESHOLD = 256 * 1024;
 
+/// capacity of the whole heap in bytes.
+constexpr uint64_t HEAP_CAPACITY = static_cast<uint64_t>(TOTAL_SEGMENTS) * SEGMENT_SIZE;
+
+/// smallest usable part of a segment under a heap limit, leaves room for the largest objects and region chunks.
+constexpr uint32_t MIN_SEGMENT_HEAP_LIMIT = 1024 * 1024;
+
+static_assert(TOTAL_SEGMENTS <= 64, "Region segment mask can't hold more than 64 segments");
+
+/**
+ * @enum allocation_policy
+ * @brief defines the order in which segments of a category are tried for allocation.
+ * @details round_robin - continues from the segment that was used last, spreading objects over all segments.
+ * fullest_first - prefers the most occupied segment that can still fit the object, 
+ * so long-lived objects concentrate in few segments and the rest can drain completely.
+ * thread_affinity - each mutator thread allocates from its home segment of the category, assigned round-robin at registration;
+ * other segments are tried, fullest first, only when the home segment is full.
+*/
+enum class allocation_policy { round_robin, fullest_first, thread_affinity };
+
+/**
+ * @enum allocation_path
+ * @brief defines the path an allocation took, used to pick its latency histogram.
+ * @details fast_path - served by the first attempt, a bump inside of the current region chunk for region allocations.
+ * slow_path - first attempt failed, served without waiting for gc; region allocations that needed a new chunk.
+ * gc_wait - allocation ran the gc or waited for it to finish.
+*/
+enum class allocation_path { fast_path, slow_path, gc_wait };
+
 /**
  * @class heap_manager
  * @brief manages the memory on the heap.
 */
-class heap_manager {
+class heap_manager final : public region_releaser {
 private:
     /// locks for heap segments.
-    std::mutex segment_locks[TOTAL_SEGMENTS];
+    profiled_mutex segment_locks[TOTAL_SEGMENTS];
 
     /// locks the root-set-table.
-    std::mutex root_set_mutex;
+    profiled_mutex root_set_mutex{"root_set_mutex"};
 
     /// segmented memory for object allocation.
     heap heap_memory;
@@ -50,17 +90,53 @@ private:
     /// gc for heap cleanup.
     garbage_collector gc;
 
+    /// order in which segments are tried for allocation.
+    const allocation_policy policy;
+
     /// indicates whether gc is currently running.
     std::atomic<bool> gc_in_progress{false};
 
-    /// small object segment that was used last, default to last.
-    std::atomic<size_t> last_small_segment{SMALL_OBJECT_SEGMENTS - 1};
+    /// segment of each object size category that was used last, defaults to last segment.
+    std::atomic<size_t> last_category_segment[SEGMENT_CATEGORY_COUNT]{TOTAL_SEGMENTS - 1, TOTAL_SEGMENTS - 1, TOTAL_SEGMENTS - 1};
+
+    /// slow path entries of each object size category at the last rebalancing.
+    uint64_t rebalanced_slow_path_entries[SEGMENT_CATEGORY_COUNT]{};
+
+    /// bytes of each segment that are kept free to emulate a smaller heap, 0 without a heap limit.
+    std::atomic<uint32_t> segment_reserve{0};
+
+    /// number of completed garbage collections.
+    std::atomic<uint64_t> gc_count{0};
+
+    /// number of bytes occupied by live objects after the last garbage collection.
+    std::atomic<uint64_t> live_bytes_after_gc{0};
+
+    /// phase durations of every gc cycle, guarded by root_set_mutex.
+    indexed_stack<gc_pause> gc_pauses;
 
-    /// medium object segment that was used last, default to last.
-    std::atomic<size_t> last_medium_segment{SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS - 1};
+    /// free space layout of each segment after the last coalescing and the region chunks released since, guarded by the segment locks.
+    fragmentation_stats segment_fragmentation[TOTAL_SEGMENTS];
 
-    /// large object segment that was used last, default to last.
-    std::atomic<size_t> last_large_segment{SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS + LARGE_OBJECT_SEGMENTS - 1};
+    /// bytes of each segment held by region chunks of open scopes, including chunk headers.
+    std::atomic<uint32_t> region_chunk_bytes[TOTAL_SEGMENTS]{};
+
+    /// allocation site profiler, disabled unless sampling interval is set.
+    allocation_sampler sampler;
+
+    /// per-thread state of the mutator threads, indexed by registration order.
+    mutator_context mutators[MAX_MUTATOR_THREADS];
+
+    /// number of mutator threads that registered.
+    std::atomic<size_t> registered_mutators{0};
+
+    /// allocation latency histograms of the mutator threads, indexed like mutators, nullptr if latency recording is disabled.
+    std::unique_ptr<allocation_latency_histograms[]> latency_histograms;
+
+    /// id of the heap manager, distinguishes instances for thread-local registration.
+    const uint64_t instance_id;
+
+    /// id of the next heap manager instance.
+    static std::atomic<uint64_t> next_instance_id;
     
     /// last time garbage collection was done.
     std::atomic<uint64_t> last_gc_time_ms;
@@ -68,12 +144,18 @@ private:
     /// minimum time between GC runs.
     static constexpr std::chrono::milliseconds MIN_GC_INTERVAL{100};
 
+    /// occupancy of the category above which it receives free segments without slow path entries.
+    static constexpr double SEGMENT_REPURPOSE_OCCUPANCY = 0.9;
+
     /// periodic gc interval.
     static constexpr std::chrono::seconds PERIODIC_GC_INTERVAL{1};
 
     /// background gc thread.
     std::jthread gc_timer_thread;
 
+    /// exposes the hot paths that microbenchmarks measure in isolation, see heap-bench-access.hpp.
+    friend class heap_bench_access;
+
     /**
      * @brief checks if enough time has passed since last garbage collection.
      * @returns true if gc should run, false otherwise.
@@ -86,13 +168,6 @@ private:
     */
     void periodic_gc_loop(std::stop_token stop_token);
 
-    /**
-     * @brief getter for the index of the segment based on object size category.
-     * @param segment_index - index of the segment 0 to (n-1).
-     * @returns index of the segment in an object category.
-    */
-    size_t get_segment_category_index(size_t segment_index) const noexcept;
-
     /**
      * @brief getter for the segment based on index.
      * @param segment_index - index of the segment.
@@ -100,12 +175,74 @@ private:
     */
     segment& get_segment(size_t segment_index);
 
+    /**
+     * @brief getter for the object size category.
+     * @param bytes - size of the object.
+     * @returns category of the segments that serve the object.
+    */
+    static segment_category get_object_category(uint32_t bytes) noexcept;
+
+    /**
+     * @brief getter for the context of the calling mutator thread.
+     * @returns reference to the mutator context.
+     * @details thread is registered on its first call, contexts are shared once MAX_MUTATOR_THREADS is exceeded.
+    */
+    mutator_context& current_mutator() noexcept;
+
+    /**
+     * @brief getter for the home segment of a mutator thread.
+     * @param category - object size category.
+     * @param slot - registration order of the mutator thread.
+     * @returns index of the home segment, -1 if category has no segments.
+     * @details home segments are assigned round-robin among the segments of the category.
+    */
+    int get_home_segment(segment_category category, size_t slot) const;
+
     /**
      * @brief finds a segment that can store required bytes.
      * @param bytes - number of bytes that need to be allocated.
+     * @param skipped_segments - bit mask of the segments that are not considered, defaults to 0.
      * @returns index of the segment if segment can allocate enough bytes, -1 otherwise.
+     * @details candidates are ranked by the allocation policy from unlocked snapshots of their free bytes,
+     * first candidate that can be locked without waiting is returned.
+     * With thread_affinity policy the home segment is returned even if it is locked, mutator is only looked up for this policy.
+     * Lock attempts are counted by the caller on the lock it allocates under, probing a candidate isn't counted.
+    */
+    int find_suitable_segment(uint32_t bytes, uint64_t skipped_segments = 0);
+
+    /**
+     * @brief updates the allocation counters of the mutator thread.
+     * @param mutator - reference to the context of the allocating thread.
+     * @param bytes - number of allocated bytes.
+    */
+    void record_allocation(mutator_context& mutator, uint32_t bytes) noexcept;
+
+    /**
+     * @brief records the latency of the allocation into the histogram of the mutator thread.
+     * @param mutator - const reference to the context of the allocating thread.
+     * @param path - path the allocation took.
+     * @param start_time - time when the allocation started.
+     * @details no-op unless built with GCSIM_LATENCY_HISTOGRAMS.
+    */
+    void record_latency(const mutator_context& mutator, allocation_path path, std::chrono::steady_clock::time_point start_time) noexcept;
+
+    /**
+     * @brief counts down the bytes until the next sample of the mutator thread and samples the object when it reaches 0.
+     * @param mutator - reference to the context of the allocating thread.
+     * @param obj - pointer to the header of the allocated object, nullptr if allocation failed.
+     * @param bytes - number of allocated bytes.
+     * @param site - const reference to the allocation site.
+    */
+    void sample_allocation(mutator_context& mutator, header* obj, uint32_t bytes, const allocation_site& site);
+
+    /**
+     * @brief tries to allocate memory on the heap without triggering gc.
+     * @param bytes - number of bytes that need to be allocated, aligned to 16 bytes.
+     * @returns pointer to header of the object if allocation is successful, nullptr otherwise.
+     * @details if the chosen segment is too fragmented to fit the object, next ranked segment is tried, round_robin makes a single attempt.
+     * Lock attempts and contention of the mutator are counted on the segment lock the allocation is tried under.
     */
-    int find_suitable_segment(uint32_t bytes) noexcept;
+    header* try_allocate(uint32_t bytes);
 
     /**
      * @brief allocates object on the heap segment.
@@ -115,30 +252,68 @@ private:
     */
     header* allocate_from_segment(size_t segment_index, uint32_t bytes);
 
+    /**
+     * @brief returns the chunks of the region to the free lists of their segments.
+     * @param region - reference to the region of the exited scope.
+     * @warning segments of the region must be locked.
+    */
+    void release_region(scope_region& region);
+
+    /**
+     * @brief returns the chunk to the free list of its segment.
+     * @param chunk - reference to the chunk of the region.
+     * @param escaped - whether objects of the region could have escaped.
+     * @details whole chunk is freed in O(1) if nothing escaped, 
+     * otherwise escaped objects are promoted to regular objects and the rest is freed.
+     * Freed blocks are added to the fragmentation of the segment, adjacent free blocks are counted separately until coalescing merges them.
+     * @warning segment of the chunk must be locked.
+    */
+    void release_region_chunk(region_chunk& chunk, bool escaped);
+
+    /**
+     * @brief turns the segment into a single free block and updates its free memory info.
+     * @param segment_index - index of the segment.
+     * @warning segment must be locked or not yet in use.
+    */
+    void reset_segment(size_t segment_index);
+
     /**
      * @brief merges free blocks on the segment.
      * @param segment_index - index of the segment. 
     */
     void coalesce_segment(size_t segment_index);
 
+    /**
+     * @brief moves an entirely free segment to the category under the most pressure.
+     * @details category with the most slow path entries since the last rebalancing is chosen, 
+     * otherwise the most occupied category above SEGMENT_REPURPOSE_OCCUPANCY. Bytes held by region chunks count as free,
+     * chunks are carved from any category and released with their scope, so they don't put pressure on the category.
+     * Segment is taken from the least occupied category with fewer slow path entries that keeps at least one segment.
+     * @warning must be called during the STW, after segments are coalesced.
+    */
+    void rebalance_segments();
+
     /**
      * @brief merges free blocks of segments.
+     * @returns CPU time of the coalesce tasks in nanoseconds, summed over the heap manager threads.
      * @warning must be called during the STW, after gc finishes collecting.
     */
-    void coalesce_segments();
+    uint64_t coalesce_segments();
 
 public:
     /**
      * @brief creates the instance of the heap manager.
      * @param gc_thread_count - size of gc thread pool, defaults to 1.
+     * @param policy - order in which segments are tried for allocation, defaults to round_robin.
      * @details initializes the segments on the heap, initializes free memory tables.
     */
-    heap_manager(size_t hm_thread_count, size_t gc_thread_count = 1);
+    heap_manager(size_t hm_thread_count, size_t gc_thread_count = 1, allocation_policy policy = allocation_policy::round_robin);
 
     /**
      * @brief deletes the instance of the heap manager.
+     * @details removes the roots first, so thread stacks release their regions while the heap is intact.
     */
-    ~heap_manager() = default;
+    ~heap_manager() override;
 
     /// deleted copy constructor.
     heap_manager(const heap_manager&) = delete;
@@ -155,9 +330,134 @@ public:
     /**
      * @brief tries to allocate memory on the heap.
      * @param bytes - number of bytes that need to be allocated.
+     * @param site - allocation site for the sampling profiler, defaults to the source location of the caller.
+     * @returns pointer to header of the object if allocation is successful, nullptr otherwise.
+    */
+    header* allocate(uint32_t bytes, allocation_site site = std::source_location::current());
+
+    /**
+     * @brief tries to allocate memory inside of the region of the current tls scope.
+     * @param tls - reference to a thread local stack whose scope was opened with push_region_scope.
+     * @param bytes - number of bytes that need to be allocated.
+     * @param site - allocation site for the sampling profiler, defaults to the source location of the caller.
      * @returns pointer to header of the object if allocation is successful, nullptr otherwise.
+     * @details falls back to allocate if scope has no region or object is larger than REGION_OBJECT_THRESHOLD.
+     * Objects bump-allocated inside of the region are sampled like the ones of allocate, but their survival isn't followed.
+    */
+    header* allocate_in_scope(thread_local_stack& tls, uint32_t bytes, allocation_site site = std::source_location::current());
+
+    /**
+     * @brief exits the current tls scope and releases its region.
+     * @param tls - reference to a thread local stack.
+     * @param destr - flag if the scope is exited by the destructor of the stack, it isn't recorded in the trace; defaults to false.
+     * @details region is freed at once if none of its objects escaped, otherwise escaped objects are kept.
+     * thread_local_stack::pop_scope and its destructor exit region scopes through here as well.
+    */
+    void pop_region_scope(thread_local_stack& tls, bool destr = false) override;
+
+    /**
+     * @brief takes a snapshot of the heap statistics.
+     * @returns allocation counters per category, gc counters and the state of each segment.
+     * @details counters are sharded per mutator thread and summed here, allocation doesn't contend on them.
+     * Segments are locked one at a time to copy their counters, free lists aren't walked.
+    */
+    heap_stats stats();
+
+    /**
+     * @brief getter for the per-thread allocation statistics.
+     * @returns snapshot of the counters of each used mutator context, indexed by slot.
+     * @details counters are cumulative since the heap was created, threads registered after MAX_MUTATOR_THREADS share contexts.
+    */
+    indexed_stack<mutator_stats> get_mutator_stats() const;
+
+    /**
+     * @brief merges the allocation latency histograms of the mutator threads.
+     * @returns latency percentiles in nanoseconds per allocation path since the last reset, zeroed if latency recording is disabled.
+    */
+    allocation_latency_summary get_allocation_latency() const;
+
+    /**
+     * @brief clears the allocation latency histograms of the mutator threads.
+     * @warning no thread may allocate while the histograms are cleared.
+    */
+    void reset_allocation_latency() noexcept;
+
+    /**
+     * @brief getter for the hardware counters of the gc phases.
+     * @returns counters of the mark and sweep tasks, accumulated over all cycles.
+    */
+    gc_perf_counters get_gc_perf_counters() const noexcept;
+
+    /**
+     * @brief limits the heap, segments are treated as full once their free bytes drop to their share of the unused capacity.
+     * @param bytes - usable heap size, 0 or HEAP_CAPACITY and above remove the limit.
+     * @details limit is split evenly between the segments, each keeps at least MIN_SEGMENT_HEAP_LIMIT usable bytes.
+     * A smaller heap makes allocations enter the slow path and run gc sooner.
+    */
+    void set_heap_limit(uint64_t bytes) noexcept;
+
+    /**
+     * @brief getter for the usable heap size.
+     * @returns usable heap size in bytes, HEAP_CAPACITY without a limit.
     */
-    header* allocate(uint32_t bytes);
+    uint64_t get_heap_limit() const noexcept;
+
+    /**
+     * @brief enables or disables the live-object census of the gc.
+     * @param enabled - true if the census is taken during the following gc cycles, false otherwise.
+    */
+    void set_census_enabled(bool enabled) noexcept;
+
+    /**
+     * @brief getter for the live-object census.
+     * @returns copy of the census taken by the last gc cycle, zeroed if no census was taken.
+    */
+    live_census get_live_census();
+
+    /**
+     * @brief getter for the recorded gc pauses.
+     * @param since_ns - steady clock time, pauses that started earlier are skipped; defaults to 0.
+     * @returns copy of the phase durations of the gc cycles that started after since_ns.
+    */
+    indexed_stack<gc_pause> get_gc_pauses(uint64_t since_ns = 0);
+
+    /**
+     * @brief sets the average number of allocated bytes between two sampled allocations.
+     * @param interval - sampling interval in bytes, 0 disables sampling.
+     * @details the countdown of every mutator context is redrawn, so the first allocation of a thread isn't always sampled.
+    */
+    void set_sampling_interval(uint64_t interval);
+
+    /**
+     * @brief getter for the sampled allocation sites.
+     * @returns site statistics ranked by estimated allocated bytes.
+    */
+    indexed_stack<allocation_site_stats> get_allocation_sites();
+
+    /**
+     * @brief writes the sampled allocation sites as a pprof profile.
+     * @param path - path of the output file.
+     * @returns true if the profile was written, false otherwise.
+    */
+    bool write_allocation_profile(const std::string& path);
+
+    /**
+     * @brief getter for the number of registered mutator threads.
+     * @returns number of threads that allocated on the heap.
+    */
+    size_t get_registered_mutator_count() const noexcept;
+
+    /**
+     * @brief getter for the number of gc threads.
+     * @returns number of threads that run the mark and sweep tasks.
+    */
+    size_t get_gc_thread_count() const noexcept;
+
+    /**
+     * @brief getter for the number of heap manager threads.
+     * @returns number of threads that run the coalesce tasks.
+    */
+    size_t get_coalesce_thread_count() const noexcept;
 
     /**
      * @brief adds new root to a root-set-table.
@@ -184,6 +484,13 @@ public:
     */
     void clear_roots() noexcept;
 
+    /**
+     * @brief empties the heap without collecting garbage.
+     * @details "Stop the world", removes all roots and reinitializes each segment to a single free block in O(segments).
+     * @warning every object on the heap is released, references to them must not be used afterwards.
+    */
+    void reset();
+
     /**
      * @brief starts the garbage collection.
      * @details "Stop the world", mark & sweep collection and coalescing of segments.
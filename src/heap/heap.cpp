@@ -2,44 +2,54 @@
 
 #include <stdexcept>
 
-segment& heap::get_small_object_segment(size_t index) {
-    if(index >= SMALL_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Small object segment index out of range");
+heap::heap() {
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i) {
+        if(i < SMALL_OBJECT_SEGMENTS) {
+            segment_categories[i].store(segment_category::small, std::memory_order_relaxed);
+        }
+        else if(i < SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS) {
+            segment_categories[i].store(segment_category::medium, std::memory_order_relaxed);
+        }
+        else {
+            segment_categories[i].store(segment_category::large, std::memory_order_relaxed);
+        }
     }
-    return small_object_segments[index];
 }
 
-const segment& heap::get_small_object_segment(size_t index) const {
-    if(index >= SMALL_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Small object segment index out of range");
+segment& heap::get_segment(size_t index) {
+    if(index >= TOTAL_SEGMENTS) {
+        throw std::out_of_range("Segment index out of range");
     }
-    return small_object_segments[index];
+    return segments[index];
 }
 
-segment& heap::get_medium_object_segment(size_t index) {
-    if(index >= MEDIUM_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Medium object segment index out of range");
+const segment& heap::get_segment(size_t index) const {
+    if(index >= TOTAL_SEGMENTS) {
+        throw std::out_of_range("Segment index out of range");
     }
-    return medium_object_segments[index];
+    return segments[index];
 }
 
-const segment& heap::get_medium_object_segment(size_t index) const {
-    if(index >= MEDIUM_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Medium object segment index out of range");
+segment_category heap::get_segment_category(size_t index) const {
+    if(index >= TOTAL_SEGMENTS) {
+        throw std::out_of_range("Segment index out of range");
     }
-    return medium_object_segments[index];
+    return segment_categories[index].load(std::memory_order_acquire);
 }
 
-segment& heap::get_large_object_segment(size_t index) {
-    if(index >= LARGE_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Large object segment index out of range");
+void heap::set_segment_category(size_t index, segment_category category) {
+    if(index >= TOTAL_SEGMENTS) {
+        throw std::out_of_range("Segment index out of range");
     }
-    return large_object_segments[index];
+    segment_categories[index].store(category, std::memory_order_release);
 }
 
-const segment& heap::get_large_object_segment(size_t index) const {
-    if(index >= LARGE_OBJECT_SEGMENTS) {
-        throw std::out_of_range("Large object segment index out of range");
+size_t heap::get_category_segment_count(segment_category category) const noexcept {
+    size_t count = 0;
+    for(size_t i = 0; i < TOTAL_SEGMENTS; ++i) {
+        if(segment_categories[i].load(std::memory_order_acquire) == category) {
+            ++count;
+        }
     }
-    return large_object_segments[index];
+    return count;
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define HEAP_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <utility>
 
 #include "../common/segment/segment.hpp"
 
@@ -17,27 +20,49 @@ constexpr size_t LARGE_OBJECT_SEGMENTS = 2;
 /// total number of segments.
 constexpr size_t TOTAL_SEGMENTS = SMALL_OBJECT_SEGMENTS + MEDIUM_OBJECT_SEGMENTS + LARGE_OBJECT_SEGMENTS;
 
+/// number of object size categories.
+constexpr size_t SEGMENT_CATEGORY_COUNT = 3;
+
+/**
+ * @enum segment_category
+ * @brief defines the object size category the segment serves.
+*/
+enum class segment_category : uint8_t { small, medium, large };
+
+/**
+ * @brief getter for the name of the object size category.
+ * @param category - object size category.
+ * @returns name of the category.
+*/
+constexpr const char* segment_category_name(segment_category category) {
+    switch(category) {
+        case segment_category::small: return "small";
+        case segment_category::medium: return "medium";
+        case segment_category::large: return "large";
+    }
+    std::unreachable();
+}
+
 /**
  * @class heap
  * @brief implementation of the segmented heap.
+ * @details segments start with SMALL_OBJECT_SEGMENTS small, MEDIUM_OBJECT_SEGMENTS medium and LARGE_OBJECT_SEGMENTS large segments,
+ * category of each segment can be changed at runtime.
 */
 class heap {
 private:
-    /// segments for small object allocation.
-    segment small_object_segments[SMALL_OBJECT_SEGMENTS];
-    
-    /// segments for medium object allocation.
-    segment medium_object_segments[MEDIUM_OBJECT_SEGMENTS];
-    
-    /// segments for large object allocation.
-    segment large_object_segments[LARGE_OBJECT_SEGMENTS];
+    /// segments for object allocation.
+    segment segments[TOTAL_SEGMENTS];
+
+    /// maps index of the segment to the object size category it serves.
+    std::atomic<segment_category> segment_categories[TOTAL_SEGMENTS];
 
 public:
     /**
      * @brief creates the instance of the heap.
-     * @details initializes all segments.
+     * @details initializes all segments, assigns the initial category to each segment.
     */
-    heap() = default;
+    heap();
 
     /**
      * @brief deletes the heap object.
@@ -58,46 +83,43 @@ public:
     heap& operator=(heap&&) = delete;
 
     /**
-     * @brief getter for small object segments.
-     * @param index - index of the small object segment.
-     * @returns reference to a small object segment.
-    */
-    segment& get_small_object_segment(size_t index);
-
-    /**
-     * @brief getter for small object segments.
-     * @param index - index of the small object segment.
-     * @returns const reference to a small object segment.
+     * @brief getter for segments.
+     * @param index - index of the segment.
+     * @returns reference to a segment.
+     * @throws std::out_of_range when index is bigger than or equal to TOTAL_SEGMENTS.
     */
-    const segment& get_small_object_segment(size_t index) const;
+    segment& get_segment(size_t index);
 
     /**
-     * @brief getter for medium object segments.
-     * @param index - index of the medium object segment.
-     * @returns reference to a medium object segment.
+     * @brief getter for segments.
+     * @param index - index of the segment.
+     * @returns const reference to a segment.
+     * @throws std::out_of_range when index is bigger than or equal to TOTAL_SEGMENTS.
     */
-    segment& get_medium_object_segment(size_t index);
+    const segment& get_segment(size_t index) const;
 
     /**
-     * @brief getter for medium object segments.
-     * @param index - index of the medium object segment.
-     * @returns const reference to a medium object segment.
+     * @brief getter for the category of the segment.
+     * @param index - index of the segment.
+     * @returns object size category the segment serves.
+     * @throws std::out_of_range when index is bigger than or equal to TOTAL_SEGMENTS.
     */
-    const segment& get_medium_object_segment(size_t index) const;
+    segment_category get_segment_category(size_t index) const;
 
     /**
-     * @brief getter for large object segments.
-     * @param index - index of the large object segment.
-     * @returns reference to a large object segment.
+     * @brief moves the segment to another category.
+     * @param index - index of the segment.
+     * @param category - new object size category of the segment.
+     * @throws std::out_of_range when index is bigger than or equal to TOTAL_SEGMENTS.
     */
-    segment& get_large_object_segment(size_t index);
+    void set_segment_category(size_t index, segment_category category);
 
     /**
-     * @brief getter for large object segments.
-     * @param index - index of the large object segment.
-     * @returns const reference to a large object segment.
+     * @brief counts the segments of the category.
+     * @param category - object size category.
+     * @returns number of segments serving the category.
     */
-    const segment& get_large_object_segment(size_t index) const;
+    size_t get_category_segment_count(segment_category category) const noexcept;
 
 };
 
@@ -0,0 +1,82 @@
+#include "lifetime-sampler.hpp"
+
+#include <cmath>
+
+lifetime_sampler::lifetime_sampler(const workload_config& config) : config(config), percent_dist(0, 99) {}
+
+uint64_t lifetime_sampler::exponential_lifetime(std::mt19937& rng, double mean){
+    if(mean <= 0) return 0;
+    return static_cast<uint64_t>(std::llround(lifetime_dist(rng, std::exponential_distribution<double>::param_type(1.0 / mean))));
+}
+
+lifetime_sample lifetime_sampler::next(std::mt19937& rng, uint64_t clock){
+    switch(config.lifetime){
+        case lifetime_model::exponential:
+            return lifetime_sample{.lifetime = exponential_lifetime(rng, config.lifetime_mean), .cached = false};
+        case lifetime_model::generational: {
+            const bool young = percent_dist(rng) < config.young_percent;
+            return lifetime_sample{.lifetime = exponential_lifetime(rng, young ? config.young_mean : config.old_mean), .cached = false};
+        }
+        case lifetime_model::lru_cache:
+            if(percent_dist(rng) < config.cache_insert_percent){
+                return lifetime_sample{.lifetime = 0, .cached = true};
+            }
+            return lifetime_sample{.lifetime = exponential_lifetime(rng, config.young_mean), .cached = false};
+        case lifetime_model::phased: {
+            const bool young_phase = (clock / config.phase_length) % 2 == 0;
+            return lifetime_sample{.lifetime = exponential_lifetime(rng, young_phase ? config.young_mean : config.old_mean), .cached = false};
+        }
+        case lifetime_model::scoped:
+        case lifetime_model::region:
+            break;
+    }
+    return lifetime_sample{.lifetime = 0, .cached = false};
+}
+
+bool lifetime_sampler::next_cache_hit(std::mt19937& rng){
+    return percent_dist(rng) < config.cache_hit_percent;
+}
+
+lru_cache_slots::lru_cache_slots(size_t capacity)
+    : capacity(capacity), size(0), prev(std::make_unique<size_t[]>(capacity + 1)), next(std::make_unique<size_t[]>(capacity + 1)) {
+    prev[capacity] = capacity;
+    next[capacity] = capacity;
+}
+
+void lru_cache_slots::unlink(size_t entry) noexcept {
+    next[prev[entry]] = next[entry];
+    prev[next[entry]] = prev[entry];
+}
+
+void lru_cache_slots::push_front(size_t entry) noexcept {
+    prev[entry] = capacity;
+    next[entry] = next[capacity];
+    prev[next[capacity]] = entry;
+    next[capacity] = entry;
+}
+
+size_t lru_cache_slots::insert() noexcept {
+    if(size < capacity){
+        push_front(size);
+        return size++;
+    }
+
+    const size_t least_recent = prev[capacity];
+    unlink(least_recent);
+    push_front(least_recent);
+    return least_recent;
+}
+
+void lru_cache_slots::touch(size_t entry) noexcept {
+    if(entry >= size) return;
+    unlink(entry);
+    push_front(entry);
+}
+
+bool lru_cache_slots::is_full() const noexcept {
+    return size == capacity;
+}
+
+size_t lru_cache_slots::get_size() const noexcept {
+    return size;
+}
\ No newline at end of file
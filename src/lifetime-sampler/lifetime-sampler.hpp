@@ -0,0 +1,150 @@
+#ifndef LIFETIME_SAMPLER_HPP
+#define LIFETIME_SAMPLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+#include "../workload-config/workload-config.hpp"
+
+/**
+ * @struct lifetime_sample
+ * @brief lifetime drawn for a newly allocated object.
+*/
+struct lifetime_sample {
+    /// number of allocations of the thread the object stays reachable for, 0 if it's garbage right away.
+    uint64_t lifetime;
+
+    /// whether the object is inserted into the cache, lifetime is ignored then and the object lives until evicted.
+    bool cached;
+};
+
+/**
+ * @class lifetime_sampler
+ * @brief draws object lifetimes from the lifetime model of the workload.
+ * @details lifetimes are measured in allocations of the same thread.
+ * exponential - every object lives exp(lifetime-mean).
+ * generational - young-percent of objects live exp(young-mean), the rest live exp(old-mean).
+ * lru_cache - cache-insert-percent of objects enter the cache, the rest live exp(young-mean).
+ * phased - phases of phase-length allocations alternate between exp(young-mean) and exp(old-mean) lifetimes.
+*/
+class lifetime_sampler {
+private:
+    /// reference to the parameters of the workload.
+    const workload_config& config;
+
+    /// distribution for percentages.
+    std::uniform_int_distribution<uint32_t> percent_dist;
+
+    /// distribution for lifetimes, mean is passed on each draw.
+    std::exponential_distribution<double> lifetime_dist;
+
+    /**
+     * @brief draws an exponentially distributed lifetime.
+     * @param rng - reference to the random number generator.
+     * @param mean - mean lifetime in allocations.
+     * @returns lifetime rounded to whole allocations.
+    */
+    uint64_t exponential_lifetime(std::mt19937& rng, double mean);
+
+public:
+    /**
+     * @brief creates the sampler.
+     * @param config - const reference to the parameters of the workload, must outlive the sampler.
+    */
+    explicit lifetime_sampler(const workload_config& config);
+
+    /**
+     * @brief deletes the sampler.
+    */
+    ~lifetime_sampler() = default;
+
+    /**
+     * @brief draws the lifetime of the next allocated object.
+     * @param rng - reference to the random number generator.
+     * @param clock - number of earlier allocations of the thread.
+     * @returns lifetime of the object.
+    */
+    lifetime_sample next(std::mt19937& rng, uint64_t clock);
+
+    /**
+     * @brief checks if a cached object should be accessed after an allocation.
+     * @param rng - reference to the random number generator.
+     * @returns true with cache-hit-percent probability.
+    */
+    bool next_cache_hit(std::mt19937& rng);
+
+};
+
+/**
+ * @class lru_cache_slots
+ * @brief fixed number of cache entries ordered from the most to the least recently used.
+ * @details entries are indices 0..capacity-1, kept in an intrusive doubly linked list, every operation is O(1).
+*/
+class lru_cache_slots {
+private:
+    /// maximum number of entries.
+    size_t capacity;
+
+    /// number of used entries.
+    size_t size;
+
+    /// previous entry of each entry, index capacity is the list head.
+    std::unique_ptr<size_t[]> prev;
+
+    /// next entry of each entry, index capacity is the list head.
+    std::unique_ptr<size_t[]> next;
+
+    /**
+     * @brief removes the entry from the list.
+     * @param entry - index of the entry.
+    */
+    void unlink(size_t entry) noexcept;
+
+    /**
+     * @brief makes the entry the most recently used.
+     * @param entry - index of the entry, must not be in the list.
+    */
+    void push_front(size_t entry) noexcept;
+
+public:
+    /**
+     * @brief creates an empty cache.
+     * @param capacity - maximum number of entries.
+    */
+    explicit lru_cache_slots(size_t capacity);
+
+    /**
+     * @brief deletes the cache.
+    */
+    ~lru_cache_slots() = default;
+
+    /**
+     * @brief takes an entry for a new object, evicting the least recently used one if cache is full.
+     * @returns index of the entry, the previous object of the entry is evicted if cache was full.
+     * @warning capacity must not be 0.
+    */
+    size_t insert() noexcept;
+
+    /**
+     * @brief marks the entry as the most recently used.
+     * @param entry - index of a used entry.
+    */
+    void touch(size_t entry) noexcept;
+
+    /**
+     * @brief checks if every entry is used.
+     * @returns true if the next insert evicts, false otherwise.
+    */
+    bool is_full() const noexcept;
+
+    /**
+     * @brief getter for the number of used entries.
+     * @returns number of used entries.
+    */
+    size_t get_size() const noexcept;
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "malloc-baseline.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <format>
+#include <thread>
+
+#include "../lifetime-sampler/lifetime-sampler.hpp"
+#include "../common/resident-memory/resident-memory.hpp"
+
+thread_local std::mt19937 malloc_baseline::rng{std::random_device{}() + std::hash<std::thread::id>{}(std::this_thread::get_id())};
+
+malloc_baseline::malloc_baseline(size_t thread_count, const workload_config& config)
+    : alloc_thread_pool(thread_count), config(config), allocations(0), failed_allocations(0), frees(0),
+      latency(std::make_unique<latency_histogram>()) {}
+
+simulation_result malloc_baseline::simulate_alloc(){
+    allocations.store(0, std::memory_order_relaxed);
+    failed_allocations.store(0, std::memory_order_relaxed);
+    frees.store(0, std::memory_order_relaxed);
+    latency = std::make_unique<latency_histogram>();
+
+    resident_memory::reset_peak();
+    const uint64_t rss_at_start = resident_memory::current_bytes();
+    const uint64_t run_start_ns = gc_pause_report::clock_ns();
+    const uint64_t deadline_ns = config.duration_ms == 0 ? 0 : run_start_ns + config.duration_ms * 1'000'000;
+    std::latch completion_latch(config.tls_roots + config.global_roots + config.register_roots);
+
+    for(size_t i = 0; i < config.tls_roots; ++i){
+        enqueue_simulation([this](latency_histogram& task_latency) -> void {
+            simulate_tls_alloc(task_latency);
+        }, completion_latch, deadline_ns);
+    }
+
+    for(size_t i = 0; i < config.global_roots; ++i){
+        enqueue_simulation([this](latency_histogram& task_latency) -> void {
+            simulate_single_root(config.global_allocs, task_latency);
+        }, completion_latch, deadline_ns);
+    }
+
+    for(size_t i = 0; i < config.register_roots; ++i){
+        enqueue_simulation([this](latency_histogram& task_latency) -> void {
+            simulate_single_root(config.register_allocs, task_latency);
+        }, completion_latch, deadline_ns);
+    }
+
+    completion_latch.wait();
+    const uint64_t run_end_ns = gc_pause_report::clock_ns();
+    const uint64_t peak_rss = resident_memory::peak_bytes();
+    const latency_summary allocation_latency = LATENCY_HISTOGRAMS_ENABLED ? latency->summarize() : latency_summary{};
+
+    return simulation_result{
+        .allocations = allocations.load(std::memory_order_relaxed),
+        .failed_allocations = failed_allocations.load(std::memory_order_relaxed),
+        .duration_ns = run_end_ns - run_start_ns,
+        .start_ns = run_start_ns,
+        .allocation_p50_ns = allocation_latency.p50,
+        .allocation_p99_ns = allocation_latency.p99,
+        .allocation_p999_ns = allocation_latency.p999,
+        .gc_pause_p99_ns = 0,
+        .gc_count = 0,
+        .peak_rss_bytes = peak_rss,
+        .rss_growth_bytes = peak_rss > rss_at_start ? peak_rss - rss_at_start : 0
+    };
+}
+
+baseline_object malloc_baseline::allocate(latency_histogram& task_latency){
+    const uint32_t size = config.generate_size(rng);
+    baseline_object obj{.ptr = nullptr, .size = size};
+
+    if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+        const uint64_t start_ns = gc_pause_report::clock_ns();
+        obj.ptr = std::malloc(size);
+        task_latency.record(gc_pause_report::clock_ns() - start_ns);
+    }
+    else {
+        obj.ptr = std::malloc(size);
+    }
+
+    if(obj.ptr) allocations.fetch_add(1, std::memory_order_relaxed);
+    else failed_allocations.fetch_add(1, std::memory_order_relaxed);
+    return obj;
+}
+
+void malloc_baseline::release(baseline_object& obj) noexcept {
+    if(!obj.ptr) return;
+    std::free(obj.ptr);
+    obj.ptr = nullptr;
+    frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void malloc_baseline::simulate_tls_alloc(latency_histogram& task_latency){
+    if(config.lifetime != lifetime_model::scoped && config.lifetime != lifetime_model::region){
+        simulate_lifetime_model(task_latency);
+        return;
+    }
+
+    indexed_stack<baseline_object> live;
+    for(size_t scope = 0; scope < config.tls_scopes; ++scope){
+        simulate_scope(scope, 0, live, task_latency);
+    }
+}
+
+void malloc_baseline::simulate_scope(size_t scope, size_t level, indexed_stack<baseline_object>& live, latency_histogram& task_latency){
+    const size_t allocs_per_level = config.tls_allocs_per_scope / config.scope_depth;
+    const bool innermost = level + 1 == config.scope_depth;
+    const size_t allocs = innermost ? config.tls_allocs_per_scope - allocs_per_level * level : allocs_per_level;
+    const size_t scope_start = live.get_size();
+
+    for(size_t i = 0; i < allocs; ++i){
+        live.push(allocate(task_latency));
+        touch_memory(live.peek(), &live);
+    }
+    if(!innermost){
+        simulate_scope(scope, level + 1, live, task_latency);
+    }
+
+    while(live.get_size() > scope_start){
+        release(live.peek());
+        live.pop();
+    }
+}
+
+void malloc_baseline::simulate_lifetime_model(latency_histogram& task_latency){
+    lifetime_sampler sampler(config);
+    const bool use_cache = config.lifetime == lifetime_model::lru_cache;
+    lru_cache_slots cache(use_cache ? config.cache_capacity : 0);
+    std::uniform_int_distribution<size_t> entry_dist;
+
+    // min-heap of (allocation clock at which the object dies, its slot), the same as allocators::simulate_lifetime_model;
+    // cache entries hold slots too, so touches pick among every reachable object
+    indexed_stack<std::pair<uint64_t, size_t>> deaths;
+    indexed_stack<size_t> free_slots;
+    indexed_stack<baseline_object> slots;
+    indexed_stack<size_t> cache_slots;
+    auto later = [](const std::pair<uint64_t, size_t>& lhs, const std::pair<uint64_t, size_t>& rhs) -> bool {
+        return lhs.first > rhs.first;
+    };
+    auto take_slot = [&slots, &free_slots](const baseline_object& obj) -> size_t {
+        if(free_slots.empty()){
+            slots.push(obj);
+            return slots.get_size() - 1;
+        }
+        const size_t slot = free_slots.peek();
+        free_slots.pop();
+        slots[slot] = obj;
+        return slot;
+    };
+
+    const uint64_t allocs = static_cast<uint64_t>(config.tls_scopes) * config.tls_allocs_per_scope;
+    for(uint64_t clock = 0; clock < allocs; ++clock){
+        while(!deaths.empty() && deaths[0].first <= clock){
+            const size_t slot = deaths[0].second;
+            std::pop_heap(deaths.begin(), deaths.end(), later);
+            deaths.pop();
+            release(slots[slot]);
+            free_slots.push(slot);
+        }
+
+        baseline_object obj = allocate(task_latency);
+        const lifetime_sample sample = sampler.next(rng, clock);
+        if(sample.cached){
+            const bool evicting = cache.is_full();
+            const size_t entry = cache.insert();
+            if(evicting){
+                baseline_object& evicted = slots[cache_slots[entry]];
+                release(evicted);
+                evicted = obj;
+            }
+            else {
+                cache_slots.push(take_slot(obj));
+            }
+        }
+        else if(sample.lifetime > 0){
+            deaths.push(std::pair{clock + sample.lifetime, take_slot(obj)});
+            std::push_heap(deaths.begin(), deaths.end(), later);
+        }
+        touch_memory(obj, &slots);
+
+        if(!sample.cached && sample.lifetime == 0){
+            // short-lived object is dropped as soon as its payload is written
+            release(obj);
+        }
+
+        if(use_cache && cache.get_size() != 0 && sampler.next_cache_hit(rng)){
+            cache.touch(entry_dist(rng, std::uniform_int_distribution<size_t>::param_type(0, cache.get_size() - 1)));
+        }
+    }
+
+    for(baseline_object& slot : slots) release(slot);
+}
+
+void malloc_baseline::simulate_single_root(size_t allocs, latency_histogram& task_latency){
+    baseline_object current{.ptr = nullptr, .size = 0};
+    for(size_t i = 0; i < allocs; ++i){
+        release(current);
+        if(i & 1) continue;
+        current = allocate(task_latency);
+        touch_memory(current, nullptr);
+    }
+    release(current);
+}
+
+void malloc_baseline::touch_memory(const baseline_object& obj, const indexed_stack<baseline_object>* live){
+    if(config.init_payload && obj.ptr){
+        std::memset(obj.ptr, INIT_PAYLOAD_BYTE, obj.size);
+    }
+    if(config.touch_intensity == 0) return;
+
+    auto touch = [](const baseline_object& target) -> void {
+        if(!target.ptr) return;
+        uint8_t* data = static_cast<uint8_t*>(target.ptr);
+        for(size_t offset = 0; offset + sizeof(uint64_t) <= target.size; offset += MEMORY_TOUCH_STRIDE){
+            uint64_t word;
+            std::memcpy(&word, data + offset, sizeof(word));
+            ++word;
+            std::memcpy(data + offset, &word, sizeof(word));
+        }
+    };
+
+    if(live && !live->empty()){
+        for(size_t i = 0; i < config.touch_intensity; ++i){
+            touch((*live)[std::uniform_int_distribution<size_t>(0, live->get_size() - 1)(rng)]);
+        }
+    }
+    else if(!live){
+        touch(obj);
+    }
+}
+
+uint64_t malloc_baseline::get_free_count() const noexcept {
+    return frees.load(std::memory_order_relaxed);
+}
+
+std::string malloc_baseline::allocator_name(){
+    const char* preload = std::getenv("LD_PRELOAD");
+    return preload == nullptr || *preload == '\0' ? std::string("glibc malloc") : std::format("malloc from LD_PRELOAD={}", preload);
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+#ifndef MALLOC_BASELINE_HPP
+#define MALLOC_BASELINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <random>
+
+#include "../allocators/allocators.hpp"
+#include "../common/thread-pool/thread-pool.hpp"
+#include "../common/latency-histogram/latency-histogram.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
+#include "../workload-config/workload-config.hpp"
+
+/**
+ * @struct baseline_object
+ * @brief object allocated with malloc, together with its size.
+*/
+struct baseline_object {
+    /// pointer returned by malloc, nullptr if allocation failed.
+    void* ptr;
+
+    /// requested size in bytes.
+    uint32_t size;
+};
+
+/**
+ * @class malloc_baseline
+ * @brief runs the allocation and lifetime stream of the simulation against malloc and free.
+ * @details every allocation and lifetime decision mirrors allocators, but where the simulation drops the
+ * last reference to an object (scope pop, lifetime expiry, cache eviction, overwritten root) the object is freed.
+ * malloc and free resolve at load time, so an allocator preloaded with LD_PRELOAD is measured instead of glibc.
+ * Scope regions have no malloc counterpart, objects of a region scope are freed one by one when it's popped.
+*/
+class malloc_baseline {
+private:
+    /// allocators thread pool.
+    thread_pool alloc_thread_pool;
+
+    /// parameters of the simulated workload.
+    const workload_config& config;
+
+    /// number of successful allocations of the run.
+    std::atomic<uint64_t> allocations;
+
+    /// number of allocations that returned nullptr.
+    std::atomic<uint64_t> failed_allocations;
+
+    /// number of freed objects.
+    std::atomic<uint64_t> frees;
+
+    /// allocation latencies of the finished tasks.
+    std::unique_ptr<latency_histogram> latency;
+
+    /// mutex for merging the latencies of the tasks.
+    std::mutex latency_mutex;
+
+    /// random number generator of the sizes and lifetimes.
+    static thread_local std::mt19937 rng;
+
+    /**
+     * @brief runs the simulation in the thread pool, repeating it until the deadline.
+     * @param simulate - simulation of a single root, called with the histogram of the task.
+     * @param completion_latch - reference to the latch counted down when the task finishes.
+     * @param deadline_ns - time on the steady clock the simulation repeats until, 0 runs it once.
+    */
+    template<typename fn>
+    void enqueue_simulation(fn&& simulate, std::latch& completion_latch, uint64_t deadline_ns){
+        alloc_thread_pool.enqueue([this, simulate = std::forward<fn>(simulate), &completion_latch, deadline_ns]{
+            std::unique_ptr<latency_histogram> task_latency = std::make_unique<latency_histogram>();
+            do {
+                simulate(*task_latency);
+            } while(gc_pause_report::clock_ns() < deadline_ns);
+
+            {
+                std::lock_guard<std::mutex> lock(latency_mutex);
+                latency->merge(*task_latency);
+            }
+            completion_latch.count_down();
+        });
+    }
+
+    /**
+     * @brief allocates an object of a random size.
+     * @param task_latency - reference to the histogram of the task.
+     * @returns allocated object, its pointer is nullptr if malloc failed.
+    */
+    baseline_object allocate(latency_histogram& task_latency);
+
+    /**
+     * @brief frees the object.
+     * @param obj - reference to the object, reset to nullptr.
+    */
+    void release(baseline_object& obj) noexcept;
+
+    /**
+     * @brief simulates the allocations of a tls root with scoped and region lifetimes, or the lifetime model.
+     * @param task_latency - reference to the histogram of the task.
+    */
+    void simulate_tls_alloc(latency_histogram& task_latency);
+
+    /**
+     * @brief simulates a scope and its nested scopes, freeing its objects when it's popped.
+     * @param scope - index of the outermost scope.
+     * @param level - nesting level of the scope.
+     * @param live - reference to the objects of the enclosing scopes.
+     * @param task_latency - reference to the histogram of the task.
+    */
+    void simulate_scope(size_t scope, size_t level, indexed_stack<baseline_object>& live, latency_histogram& task_latency);
+
+    /**
+     * @brief simulates the lifetime model, freeing objects when they die or are evicted.
+     * @param task_latency - reference to the histogram of the task.
+    */
+    void simulate_lifetime_model(latency_histogram& task_latency);
+
+    /**
+     * @brief simulates a global or register root, freeing the previous object when it's overwritten.
+     * @param allocs - number of assignments of the root.
+     * @param task_latency - reference to the histogram of the task.
+    */
+    void simulate_single_root(size_t allocs, latency_histogram& task_latency);
+
+    /**
+     * @brief initializes the payload and touches live objects, like allocators::touch_memory.
+     * @param obj - const reference to the new object.
+     * @param live - pointer to the live objects of the root, nullptr if only obj is reachable.
+    */
+    void touch_memory(const baseline_object& obj, const indexed_stack<baseline_object>* live);
+
+public:
+    /**
+     * @brief creates the baseline.
+     * @param thread_count - number of threads running the simulation.
+     * @param config - const reference to the parameters of the workload, must outlive the baseline.
+    */
+    malloc_baseline(size_t thread_count, const workload_config& config);
+
+    /**
+     * @brief deletes the baseline.
+    */
+    ~malloc_baseline() = default;
+
+    /// deleted copy constructor.
+    malloc_baseline(const malloc_baseline&) = delete;
+
+    /// deleted assignment operator.
+    malloc_baseline& operator=(const malloc_baseline&) = delete;
+
+    /**
+     * @brief runs the simulation against malloc, every object is freed when it finishes.
+     * @returns headline metrics of the run, gc fields are 0.
+    */
+    simulation_result simulate_alloc();
+
+    /**
+     * @brief getter for the number of freed objects of the last run.
+     * @returns number of freed objects.
+    */
+    uint64_t get_free_count() const noexcept;
+
+    /**
+     * @brief getter for the name of the measured allocator.
+     * @returns "glibc malloc", or the preloaded library if LD_PRELOAD is set.
+    */
+    static std::string allocator_name();
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "request-server.hpp"
+
+#include <chrono>
+#include <format>
+#include <memory>
+#include <thread>
+
+thread_local std::mt19937 request_server::rng{std::random_device{}() + std::hash<std::thread::id>{}(std::this_thread::get_id())};
+
+request_server::request_server(heap_manager& heap_manager_ref, size_t worker_count, const workload_config& config)
+    : heap_manager_ref(heap_manager_ref), worker_count(worker_count), config(config), next_request(0), allocations(0), failed_allocations(0) {}
+
+void request_server::generate_arrivals(double rate){
+    arrivals = indexed_stack<uint64_t>();
+    const uint64_t load_duration_ns = config.request_duration_ms * 1'000'000;
+    std::exponential_distribution<double> interarrival_dist(rate / 1e9);
+
+    double arrival_ns = interarrival_dist(rng);
+    while(arrival_ns < static_cast<double>(load_duration_ns)){
+        arrivals.push(static_cast<uint64_t>(arrival_ns));
+        arrival_ns += interarrival_dist(rng);
+    }
+}
+
+request_load_stats request_server::run_load(double rate){
+    generate_arrivals(rate);
+    next_request.store(0, std::memory_order_relaxed);
+    allocations.store(0, std::memory_order_relaxed);
+    failed_allocations.store(0, std::memory_order_relaxed);
+
+    std::unique_ptr<latency_histogram> latency = std::make_unique<latency_histogram>();
+    std::unique_ptr<latency_histogram> queueing = std::make_unique<latency_histogram>();
+    std::unique_ptr<thread_local_stack*[]> stacks = std::make_unique<thread_local_stack*[]>(worker_count);
+    for(size_t i = 0; i < worker_count; ++i){
+        std::unique_ptr<thread_local_stack> tls = std::make_unique<thread_local_stack>(config.request_objects << 1);
+        stacks[i] = tls.get();
+        heap_manager_ref.add_root(std::format("q{}", i), std::move(tls));
+    }
+
+    const uint64_t start_ns = gc_pause_report::clock_ns();
+    {
+        std::unique_ptr<std::jthread[]> workers = std::make_unique<std::jthread[]>(worker_count);
+        for(size_t i = 0; i < worker_count; ++i){
+            workers[i] = std::jthread([this, tls = stacks[i], start_ns, &latency, &queueing] -> void {
+                serve(*tls, start_ns, *latency, *queueing);
+            });
+        }
+    }
+    const uint64_t end_ns = gc_pause_report::clock_ns();
+
+    for(size_t i = 0; i < worker_count; ++i){
+        heap_manager_ref.remove_root(std::format("q{}", i));
+    }
+
+    return request_load_stats{
+        .offered_rate = rate,
+        .requests = latency->get_count(),
+        .allocations = allocations.load(std::memory_order_relaxed),
+        .failed_allocations = failed_allocations.load(std::memory_order_relaxed),
+        .duration_ns = end_ns - start_ns,
+        .start_ns = start_ns,
+        .latency = latency->summarize(),
+        .queueing = queueing->summarize()
+    };
+}
+
+void request_server::serve(thread_local_stack& tls, uint64_t start_ns, latency_histogram& latency, latency_histogram& queueing){
+    for(size_t request = next_request.fetch_add(1, std::memory_order_relaxed); request < arrivals.get_size(); request = next_request.fetch_add(1, std::memory_order_relaxed)){
+        const uint64_t intended_ns = start_ns + arrivals[request];
+        wait_until(intended_ns);
+
+        const uint64_t begin_ns = gc_pause_report::clock_ns();
+        handle_request(tls);
+        const uint64_t end_ns = gc_pause_report::clock_ns();
+
+        queueing.record(begin_ns - intended_ns);
+        latency.record(end_ns - intended_ns);
+    }
+}
+
+void request_server::handle_request(thread_local_stack& tls){
+    const bool use_scope_regions = config.lifetime == lifetime_model::region;
+    if(use_scope_regions){
+        tls.push_region_scope();
+    }
+    else {
+        tls.push_scope();
+    }
+
+    uint64_t failed = 0;
+    for(size_t i = 0; i < config.request_objects; ++i){
+        const uint32_t bytes = config.generate_size(rng);
+        header* obj = use_scope_regions ? heap_manager_ref.allocate_in_scope(tls, bytes) : heap_manager_ref.allocate(bytes);
+        if(!obj) ++failed;
+        tls.init(std::format("o{}", i), obj);
+    }
+    allocations.fetch_add(config.request_objects, std::memory_order_relaxed);
+    failed_allocations.fetch_add(failed, std::memory_order_relaxed);
+
+    if(config.service_time_us != 0){
+        wait_until(gc_pause_report::clock_ns() + config.service_time_us * 1'000);
+    }
+
+    if(use_scope_regions){
+        heap_manager_ref.pop_region_scope(tls);
+    }
+    else {
+        tls.pop_scope();
+    }
+}
+
+void request_server::wait_until(uint64_t deadline_ns){
+    uint64_t now_ns = gc_pause_report::clock_ns();
+    if(deadline_ns > now_ns + MIN_ARRIVAL_SLEEP_NS){
+        std::this_thread::sleep_for(std::chrono::nanoseconds(deadline_ns - now_ns - MIN_ARRIVAL_SLEEP_NS));
+        now_ns = gc_pause_report::clock_ns();
+    }
+    while(now_ns < deadline_ns){
+        std::this_thread::yield();
+        now_ns = gc_pause_report::clock_ns();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#ifndef REQUEST_SERVER_HPP
+#define REQUEST_SERVER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <random>
+
+#include "../heap-manager/heap-manager.hpp"
+#include "../root-set-table/thread-local-stack.hpp"
+#include "../common/latency-histogram/latency-histogram.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
+#include "../workload-config/workload-config.hpp"
+
+/// shortest wait for an arrival that is slept instead of spun, in nanoseconds.
+constexpr uint64_t MIN_ARRIVAL_SLEEP_NS = 50'000;
+
+/**
+ * @struct request_load_stats
+ * @brief results of serving requests at a single offered load.
+*/
+struct request_load_stats {
+    /// offered load in requests per second.
+    double offered_rate;
+
+    /// number of served requests.
+    uint64_t requests;
+
+    /// number of allocations of the requests.
+    uint64_t allocations;
+
+    /// number of allocations that returned nullptr.
+    uint64_t failed_allocations;
+
+    /// time from the first intended arrival until the last request finished, in nanoseconds.
+    uint64_t duration_ns;
+
+    /// start of the load on the steady clock.
+    uint64_t start_ns;
+
+    /// percentiles of the time from the intended arrival until the request finished, in nanoseconds.
+    latency_summary latency;
+
+    /// percentiles of the time from the intended arrival until a worker started the request, in nanoseconds.
+    latency_summary queueing;
+
+    /**
+     * @brief calculates the rate requests were served at.
+     * @returns served requests per second, 0 if load took no time.
+    */
+    double achieved_rate() const noexcept {
+        return duration_ns == 0 ? 0.0 : static_cast<double>(requests) * 1e9 / static_cast<double>(duration_ns);
+    }
+};
+
+/**
+ * @class request_server
+ * @brief open-loop server simulation, requests arrive at a Poisson rate regardless of how fast they are served.
+ * @details a request pushes a scope of the worker's thread local stack, allocates its object graph into it,
+ * holds it for the service time and pops the scope. Arrival times are drawn up front and every latency is measured
+ * from the intended arrival, so requests delayed by a gc pause or a busy worker count their full queueing delay.
+*/
+class request_server {
+private:
+    /// reference to the heap the requests allocate on.
+    heap_manager& heap_manager_ref;
+
+    /// number of worker threads.
+    size_t worker_count;
+
+    /// parameters of the workload.
+    const workload_config& config;
+
+    /// intended arrival of each request, nanoseconds since the start of the load.
+    indexed_stack<uint64_t> arrivals;
+
+    /// index of the next request to be taken by a worker.
+    std::atomic<size_t> next_request;
+
+    /// number of allocations of the current load.
+    std::atomic<uint64_t> allocations;
+
+    /// number of failed allocations of the current load.
+    std::atomic<uint64_t> failed_allocations;
+
+    /// random number generator of the arrivals and the object sizes.
+    static thread_local std::mt19937 rng;
+
+    /**
+     * @brief draws the arrival times of a load.
+     * @param rate - offered load in requests per second.
+    */
+    void generate_arrivals(double rate);
+
+    /**
+     * @brief takes requests until every arrival of the load is served.
+     * @param tls - reference to the thread local stack of the worker.
+     * @param start_ns - start of the load on the steady clock.
+     * @param latency - reference to the histogram of the end-to-end latencies.
+     * @param queueing - reference to the histogram of the queueing delays.
+    */
+    void serve(thread_local_stack& tls, uint64_t start_ns, latency_histogram& latency, latency_histogram& queueing);
+
+    /**
+     * @brief serves a single request.
+     * @param tls - reference to the thread local stack of the worker.
+    */
+    void handle_request(thread_local_stack& tls);
+
+    /**
+     * @brief waits until the steady clock reaches the deadline, sleeping while it's far away.
+     * @param deadline_ns - time on the steady clock.
+    */
+    static void wait_until(uint64_t deadline_ns);
+
+public:
+    /**
+     * @brief creates the server.
+     * @param heap_manager_ref - reference to the heap the requests allocate on.
+     * @param worker_count - number of worker threads.
+     * @param config - const reference to the parameters of the workload, must outlive the server.
+    */
+    request_server(heap_manager& heap_manager_ref, size_t worker_count, const workload_config& config);
+
+    /**
+     * @brief deletes the server.
+    */
+    ~request_server() = default;
+
+    /// deleted copy constructor.
+    request_server(const request_server&) = delete;
+
+    /// deleted assignment operator.
+    request_server& operator=(const request_server&) = delete;
+
+    /**
+     * @brief serves requests arriving at the rate for request-duration-ms.
+     * @param rate - offered load in requests per second.
+     * @returns results of the load.
+    */
+    request_load_stats run_load(double rate);
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,222 @@
+#include "results-comparison.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <random>
+
+results_comparison::results_comparison(double significance, double min_change) : significance(significance), min_change(min_change) {}
+
+double results_comparison::mann_whitney_p(const indexed_stack<double>& a, const indexed_stack<double>& b){
+    const size_t n1 = a.get_size();
+    const size_t n2 = b.get_size();
+    if(n1 == 0 || n2 == 0) return 1.0;
+
+    indexed_stack<std::pair<double, bool>> pooled;
+    for(double sample : a) pooled.push(std::pair<double, bool>(sample, false));
+    for(double sample : b) pooled.push(std::pair<double, bool>(sample, true));
+    std::sort(pooled.begin(), pooled.end(), [](const std::pair<double, bool>& x, const std::pair<double, bool>& y) -> bool {
+        return x.first < y.first;
+    });
+
+    // average ranks of tied samples are halves, doubled ranks keep the exact distribution in integers
+    const size_t n = pooled.get_size();
+    indexed_stack<size_t> doubled_ranks;
+    size_t doubled_rank_sum_b = 0;
+    double tie_term = 0;
+    for(size_t i = 0; i < n;){
+        size_t j = i;
+        while(j < n && pooled[j].first == pooled[i].first) ++j;
+        for(size_t k = i; k < j; ++k){
+            doubled_ranks.push(i + j + 1);
+            if(pooled[k].second) doubled_rank_sum_b += i + j + 1;
+        }
+        const double ties = static_cast<double>(j - i);
+        tie_term += ties * ties * ties - ties;
+        i = j;
+    }
+
+    if(n <= MAX_EXACT_TEST_SAMPLES){
+        return exact_rank_sum_p(doubled_ranks, n2, doubled_rank_sum_b);
+    }
+
+    const double size_a = static_cast<double>(n1);
+    const double size_b = static_cast<double>(n2);
+    const double total = static_cast<double>(n);
+    const double u = static_cast<double>(doubled_rank_sum_b) / 2 - size_b * (size_b + 1) / 2;
+    const double mean_u = size_a * size_b / 2;
+    const double variance_u = size_a * size_b / 12 * ((total + 1) - tie_term / (total * (total - 1)));
+    if(variance_u <= 0) return 1.0;
+
+    const double z = std::max(std::abs(u - mean_u) - 0.5, 0.0) / std::sqrt(variance_u);
+    return std::min(std::erfc(z / std::sqrt(2.0)), 1.0);
+}
+
+double results_comparison::exact_rank_sum_p(const indexed_stack<size_t>& doubled_ranks, size_t size_b, size_t observed_sum){
+    size_t max_sum = 0;
+    for(size_t rank : doubled_ranks) max_sum += rank;
+
+    // ways[k * (max_sum + 1) + s] - number of ways to choose k of the ranks seen so far with doubled sum s,
+    // counts stay below 2^53 for MAX_EXACT_TEST_SAMPLES, so doubles hold them exactly
+    const size_t row = max_sum + 1;
+    indexed_stack<double> ways;
+    for(size_t i = 0; i < (size_b + 1) * row; ++i) ways.push(0.0);
+    ways[0] = 1.0;
+
+    size_t seen = 0;
+    for(size_t rank : doubled_ranks){
+        ++seen;
+        for(size_t k = std::min(seen, size_b); k > 0; --k){
+            for(size_t s = max_sum; s >= rank; --s){
+                ways[k * row + s] += ways[(k - 1) * row + s - rank];
+            }
+        }
+    }
+
+    double at_least = 0;
+    double at_most = 0;
+    double total = 0;
+    for(size_t s = 0; s <= max_sum; ++s){
+        total += ways[size_b * row + s];
+        if(s >= observed_sum) at_least += ways[size_b * row + s];
+        if(s <= observed_sum) at_most += ways[size_b * row + s];
+    }
+    return total == 0 ? 1.0 : std::min(2 * std::min(at_least, at_most) / total, 1.0);
+}
+
+void results_comparison::bootstrap_change_ci(const indexed_stack<double>& baseline, const indexed_stack<double>& candidate, double& low, double& high){
+    std::mt19937 rng(BOOTSTRAP_SEED);
+    std::uniform_int_distribution<size_t> baseline_dist(0, baseline.get_size() - 1);
+    std::uniform_int_distribution<size_t> candidate_dist(0, candidate.get_size() - 1);
+
+    indexed_stack<double> baseline_resample;
+    indexed_stack<double> candidate_resample;
+    for(size_t i = 0; i < baseline.get_size(); ++i) baseline_resample.push(0.0);
+    for(size_t i = 0; i < candidate.get_size(); ++i) candidate_resample.push(0.0);
+
+    indexed_stack<double> changes;
+    for(size_t r = 0; r < BOOTSTRAP_RESAMPLES; ++r){
+        for(double& value : baseline_resample) value = baseline[baseline_dist(rng)];
+        for(double& value : candidate_resample) value = candidate[candidate_dist(rng)];
+        std::sort(baseline_resample.begin(), baseline_resample.end());
+        std::sort(candidate_resample.begin(), candidate_resample.end());
+
+        const double baseline_median = results_document::median_of_sorted(baseline_resample);
+        if(baseline_median == 0) continue;
+        changes.push(results_document::median_of_sorted(candidate_resample) / baseline_median - 1.0);
+    }
+
+    if(changes.empty()){
+        low = high = 0;
+        return;
+    }
+    std::sort(changes.begin(), changes.end());
+    const double tail = (1.0 - CONFIDENCE_LEVEL) / 2;
+    low = changes[static_cast<size_t>(tail * static_cast<double>(changes.get_size() - 1))];
+    high = changes[static_cast<size_t>((1.0 - tail) * static_cast<double>(changes.get_size() - 1))];
+}
+
+metric_comparison results_comparison::compare_metric(const result_metric& baseline, const result_metric& candidate) const {
+    metric_comparison comparison{
+        .name = baseline.name,
+        .unit = baseline.unit,
+        .baseline_median = baseline.median,
+        .candidate_median = candidate.median,
+        .change = baseline.median == 0 ? 0.0 : candidate.median / baseline.median - 1.0,
+        .change_ci_low = 0,
+        .change_ci_high = 0,
+        .p_value = 1.0,
+        .verdict = comparison_verdict::unchanged
+    };
+
+    if(baseline.samples.get_size() < MIN_TEST_SAMPLES || candidate.samples.get_size() < MIN_TEST_SAMPLES){
+        comparison.verdict = comparison_verdict::insufficient_samples;
+        return comparison;
+    }
+
+    bootstrap_change_ci(baseline.samples, candidate.samples, comparison.change_ci_low, comparison.change_ci_high);
+    comparison.p_value = mann_whitney_p(baseline.samples, candidate.samples);
+    if(comparison.p_value <= significance && std::abs(comparison.change) >= min_change){
+        const bool worse = baseline.goal == metric_goal::lower ? comparison.change > 0 : comparison.change < 0;
+        comparison.verdict = worse ? comparison_verdict::regression : comparison_verdict::improvement;
+    }
+    return comparison;
+}
+
+void results_comparison::compare(const results_document& baseline, const results_document& candidate){
+    comparisons = indexed_stack<metric_comparison>();
+    for(const result_metric& metric : baseline.get_metrics()){
+        const result_metric* other = candidate.find_metric(metric.name);
+        if(other != nullptr){
+            comparisons.push(compare_metric(metric, *other));
+            continue;
+        }
+        comparisons.push(metric_comparison{
+            .name = metric.name, .unit = metric.unit, .baseline_median = metric.median, .candidate_median = std::nan(""),
+            .change = 0, .change_ci_low = 0, .change_ci_high = 0, .p_value = 1.0, .verdict = comparison_verdict::missing
+        });
+    }
+
+    for(const result_metric& metric : candidate.get_metrics()){
+        if(baseline.find_metric(metric.name) != nullptr) continue;
+        comparisons.push(metric_comparison{
+            .name = metric.name, .unit = metric.unit, .baseline_median = std::nan(""), .candidate_median = metric.median,
+            .change = 0, .change_ci_low = 0, .change_ci_high = 0, .p_value = 1.0, .verdict = comparison_verdict::missing
+        });
+    }
+}
+
+const indexed_stack<metric_comparison>& results_comparison::get_comparisons() const noexcept {
+    return comparisons;
+}
+
+size_t results_comparison::count(comparison_verdict verdict) const noexcept {
+    return static_cast<size_t>(std::count_if(comparisons.begin(), comparisons.end(), [verdict](const metric_comparison& comparison) -> bool {
+        return comparison.verdict == verdict;
+    }));
+}
+
+std::string results_comparison::report() const {
+    std::string text = std::format("Comparison ({} metrics, two-sided Mann-Whitney p <= {}, change >= {:.1f}%, {:.0f}% bootstrap intervals):\n",
+        comparisons.get_size(), significance, min_change * 100, CONFIDENCE_LEVEL * 100
+    );
+    text += std::format("  {:<64} {:>14} {:>14} {:>9} {:>20} {:>8} {:>12}\n",
+        "metric", "baseline", "candidate", "change", "interval", "p", "verdict"
+    );
+
+    constexpr comparison_verdict order[] = {
+        comparison_verdict::regression, comparison_verdict::improvement, comparison_verdict::unchanged,
+        comparison_verdict::insufficient_samples, comparison_verdict::missing
+    };
+    for(comparison_verdict verdict : order){
+        for(const metric_comparison& comparison : comparisons){
+            if(comparison.verdict != verdict) continue;
+
+            const bool tested = verdict != comparison_verdict::insufficient_samples && verdict != comparison_verdict::missing;
+            const std::string interval = tested ? std::format("[{:+.1f}%, {:+.1f}%]", comparison.change_ci_low * 100, comparison.change_ci_high * 100) : "-";
+            const std::string p_value = tested ? std::format("{:.4f}", comparison.p_value) : "-";
+            const std::string change = verdict == comparison_verdict::missing ? "-" : std::format("{:+.1f}%", comparison.change * 100);
+            text += std::format("  {:<64} {:>14.6g} {:>14.6g} {:>9} {:>20} {:>8} {:>12}\n",
+                std::format("{} ({})", comparison.name, comparison.unit), comparison.baseline_median, comparison.candidate_median,
+                change, interval, p_value, verdict_name(verdict)
+            );
+        }
+    }
+
+    text += std::format("{} regressions, {} improvements, {} unchanged, {} with too few samples, {} missing\n",
+        count(comparison_verdict::regression), count(comparison_verdict::improvement), count(comparison_verdict::unchanged),
+        count(comparison_verdict::insufficient_samples), count(comparison_verdict::missing)
+    );
+    return text;
+}
+
+const char* results_comparison::verdict_name(comparison_verdict verdict) noexcept {
+    switch(verdict){
+        case comparison_verdict::regression: return "REGRESSION";
+        case comparison_verdict::improvement: return "improvement";
+        case comparison_verdict::unchanged: return "unchanged";
+        case comparison_verdict::insufficient_samples: return "few samples";
+        case comparison_verdict::missing: return "missing";
+    }
+    return "unchanged";
+}
\ No newline at end of file
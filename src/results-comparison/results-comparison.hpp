@@ -0,0 +1,170 @@
+#ifndef RESULTS_COMPARISON_HPP
+#define RESULTS_COMPARISON_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../common/indexed-stack/indexed-stack.hpp"
+#include "../common/results-document/results-document.hpp"
+
+/// default p-value at or below which a difference counts as significant.
+constexpr double DEFAULT_SIGNIFICANCE = 0.05;
+
+/// default smallest relative change of the median that is reported as a regression or an improvement.
+constexpr double DEFAULT_MIN_CHANGE = 0.02;
+
+/// fewest samples on each side for the Mann-Whitney test to be used, 4 vs 4 separated samples reach p = 2/70, 3 vs 3 only 0.1.
+constexpr size_t MIN_TEST_SAMPLES = 4;
+
+/// largest number of pooled samples whose p-value is computed from the exact U distribution, larger ones use the normal approximation.
+constexpr size_t MAX_EXACT_TEST_SAMPLES = 40;
+
+/**
+ * @enum comparison_verdict
+ * @brief outcome of comparing a metric of two results.
+*/
+enum class comparison_verdict {
+    regression,
+    improvement,
+    unchanged,
+    insufficient_samples,
+    missing
+};
+
+/**
+ * @struct metric_comparison
+ * @brief comparison of a single metric of the baseline and the candidate.
+*/
+struct metric_comparison {
+    /// name of the metric.
+    std::string name;
+
+    /// unit of the metric.
+    std::string unit;
+
+    /// median of the baseline samples.
+    double baseline_median;
+
+    /// median of the candidate samples.
+    double candidate_median;
+
+    /// relative change of the median, candidate / baseline - 1.
+    double change;
+
+    /// lower bound of the bootstrapped confidence interval of the change.
+    double change_ci_low;
+
+    /// upper bound of the bootstrapped confidence interval of the change.
+    double change_ci_high;
+
+    /// two-sided p-value of the Mann-Whitney U test, 1 if it wasn't run.
+    double p_value;
+
+    /// outcome of the comparison.
+    comparison_verdict verdict;
+};
+
+/**
+ * @class results_comparison
+ * @brief compares the metrics of two results documents and flags statistically significant regressions.
+ * @details a metric regresses when the two-sided Mann-Whitney U test rejects equal distributions at the significance level
+ * and the median moved in the wrong direction by at least the minimum change. The side isn't picked from the observed change,
+ * so the significance level is the false positive rate of the verdicts. Metrics with fewer than MIN_TEST_SAMPLES samples on either side are reported but never flagged.
+*/
+class results_comparison {
+private:
+    /// p-value at or below which a difference counts as significant.
+    double significance;
+
+    /// smallest relative change of the median that is flagged.
+    double min_change;
+
+    /// comparisons in the order of the baseline metrics, followed by metrics only in the candidate.
+    indexed_stack<metric_comparison> comparisons;
+
+    /**
+     * @brief compares the samples of a metric.
+     * @param baseline - const reference to the baseline metric.
+     * @param candidate - const reference to the candidate metric.
+     * @returns comparison of the metric.
+    */
+    metric_comparison compare_metric(const result_metric& baseline, const result_metric& candidate) const;
+
+    /**
+     * @brief runs the two-sided Mann-Whitney U test that the samples come from the same distribution.
+     * @param a - const reference to the first samples.
+     * @param b - const reference to the second samples.
+     * @returns p-value, 1 if either side has no samples or all samples are tied.
+     * @details up to MAX_EXACT_TEST_SAMPLES pooled samples the p-value is counted over every assignment of the pooled ranks,
+     * ties included, larger samples use the normal approximation with tie and continuity correction.
+    */
+    static double mann_whitney_p(const indexed_stack<double>& a, const indexed_stack<double>& b);
+
+    /**
+     * @brief counts the assignments of the ranks to the second samples whose rank sum is at least and at most the observed one.
+     * @param doubled_ranks - const reference to the doubled average ranks of the pooled samples, integers even with ties.
+     * @param size_b - number of the second samples.
+     * @param observed_sum - doubled rank sum of the second samples.
+     * @returns exact two-sided p-value of the rank sum, twice the smaller tail and at most 1.
+    */
+    static double exact_rank_sum_p(const indexed_stack<size_t>& doubled_ranks, size_t size_b, size_t observed_sum);
+
+    /**
+     * @brief bootstraps the confidence interval of the relative change of the median.
+     * @param baseline - const reference to the baseline samples.
+     * @param candidate - const reference to the candidate samples.
+     * @param low - reference to the lower bound.
+     * @param high - reference to the upper bound.
+    */
+    static void bootstrap_change_ci(const indexed_stack<double>& baseline, const indexed_stack<double>& candidate, double& low, double& high);
+
+public:
+    /**
+     * @brief creates the comparison.
+     * @param significance - p-value at or below which a difference counts as significant.
+     * @param min_change - smallest relative change of the median that is flagged.
+    */
+    results_comparison(double significance = DEFAULT_SIGNIFICANCE, double min_change = DEFAULT_MIN_CHANGE);
+
+    /**
+     * @brief deletes the comparison.
+    */
+    ~results_comparison() = default;
+
+    /**
+     * @brief compares every metric of the documents.
+     * @param baseline - const reference to the baseline results.
+     * @param candidate - const reference to the candidate results.
+    */
+    void compare(const results_document& baseline, const results_document& candidate);
+
+    /**
+     * @brief getter for the comparisons.
+     * @returns const reference to the comparisons.
+    */
+    const indexed_stack<metric_comparison>& get_comparisons() const noexcept;
+
+    /**
+     * @brief counts the comparisons with the verdict.
+     * @param verdict - outcome being counted.
+     * @returns number of comparisons with the verdict.
+    */
+    size_t count(comparison_verdict verdict) const noexcept;
+
+    /**
+     * @brief formats the comparisons as a table, regressions first.
+     * @returns report of the comparison.
+    */
+    std::string report() const;
+
+    /**
+     * @brief getter for the name of the verdict.
+     * @param verdict - outcome of a comparison.
+     * @returns name of the verdict.
+    */
+    static const char* verdict_name(comparison_verdict verdict) noexcept;
+
+};
+
+#endif
\ No newline at end of file
@@ -1,14 +1,21 @@
 #include "global-root.hpp"
 
-global_root::global_root(header* var_ptr) : global_variable_ptr{ var_ptr } {}
+#include "../common/scope-region/scope-region.hpp"
+#include "../alloc-trace/alloc-trace.hpp"
+
+global_root::global_root(header* var_ptr) : global_variable_ptr{ var_ptr } {
+    scope_region::record_escape(var_ptr);
+}
 
 void global_root::set_global_variable(header* var_ptr) noexcept {
-    std::lock_guard<std::mutex> global_lock(global_mutex);
+    std::lock_guard<profiled_mutex> global_lock(global_mutex);
+    scope_region::record_escape(var_ptr);
+    alloc_trace::record_root_set(get_trace_id(), var_ptr);
     global_variable_ptr = var_ptr;
 }
 
 void global_root::accept(gc_visitor& visitor) noexcept {
-    std::lock_guard<std::mutex> global_lock(global_mutex);
+    std::lock_guard<profiled_mutex> global_lock(global_mutex);
     visitor.visit(*this);
 }
 
@@ -6,6 +6,7 @@
 #include "../common/header/header.hpp"
 #include "../common/root-set/root-set-base.hpp"
 #include "../common/gc/gc-visitor.hpp"
+#include "../common/profiled-mutex/profiled-mutex.hpp"
 
 /**
  * @class global_root
@@ -15,7 +16,7 @@
 class global_root final : public root_set_base {
 private:
     /// used for global variable synchronization.
-    mutable std::mutex global_mutex;
+    mutable profiled_mutex global_mutex{"global_mutex"};
 
     /// pointer to a header of the variable on the heap
     header* global_variable_ptr;
@@ -40,6 +41,7 @@ public:
     /**
      * @brief setter for the global variable.
      * @param var_ptr - pointer to the header of the global variable on the heap
+     * @details objects of a scope region are recorded as escaped.
     */
     void set_global_variable(header* var_ptr) noexcept;
     
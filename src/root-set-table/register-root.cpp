@@ -2,15 +2,22 @@
 
 #include <mutex>
 
-register_root::register_root(header* var_ptr) : register_variable{ var_ptr } {}
+#include "../common/scope-region/scope-region.hpp"
+#include "../alloc-trace/alloc-trace.hpp"
+
+register_root::register_root(header* var_ptr) : register_variable{ var_ptr } {
+    scope_region::record_escape(var_ptr);
+}
 
 void register_root::set_register_variable(header* var_ptr) noexcept {
-    std::lock_guard<std::mutex> register_lock(register_mutex);
+    std::lock_guard<profiled_mutex> register_lock(register_mutex);
+    scope_region::record_escape(var_ptr);
+    alloc_trace::record_root_set(get_trace_id(), var_ptr);
     register_variable = var_ptr;
 }
 
 void register_root::accept(gc_visitor& visitor) noexcept {
-    std::lock_guard<std::mutex> register_lock(register_mutex);
+    std::lock_guard<profiled_mutex> register_lock(register_mutex);
     visitor.visit(*this);
 }
 
@@ -6,6 +6,7 @@
 #include "../common/header/header.hpp"
 #include "../common/root-set/root-set-base.hpp"
 #include "../common/gc/gc-visitor.hpp"
+#include "../common/profiled-mutex/profiled-mutex.hpp"
 
 /**
  * @class register_root
@@ -15,7 +16,7 @@
 class register_root final : public root_set_base {
 private:
     /// used for register synchronization.
-    mutable std::mutex register_mutex;
+    mutable profiled_mutex register_mutex{"register_mutex"};
 
     /// pointer to a header of the register variable on the heap.
     header* register_variable;
@@ -40,6 +41,7 @@ public:
     /**
      * @brief setter for the register variable
      * @param var_ptr - pointer to a header of the variable on the heap.
+     * @details objects of a scope region are recorded as escaped.
      * @returns void
     */
     void set_register_variable(header* var_ptr) noexcept;
@@ -4,80 +4,201 @@
 #include <stdexcept>
 #include <utility>
 
-thread_local_stack::thread_local_stack() : scope(1) {}
+#include "../alloc-trace/alloc-trace.hpp"
 
-thread_local_stack::thread_local_stack(size_t hash_map_capacity) : scope(1), var_to_idx(hash_map_capacity) {}
+thread_local_stack::thread_local_stack() : scope(1), releaser(nullptr) {}
+
+thread_local_stack::thread_local_stack(size_t hash_map_capacity) : scope(1), var_to_idx(hash_map_capacity), releaser(nullptr) {}
 
 thread_local_stack::~thread_local_stack() {
-    pop_scope(true);
+    while(scope > 0){
+        pop_scope(true);
+    }
 }
 
 thread_local_stack::thread_local_stack(thread_local_stack&& other) noexcept : scope(std::exchange(other.scope, 0)),
-    thread_stack(std::move(other.thread_stack)), var_to_idx(std::move(other.var_to_idx)) {}
+    thread_stack(std::move(other.thread_stack)), var_to_idx(std::move(other.var_to_idx)), regions(std::move(other.regions)),
+    releaser(std::exchange(other.releaser, nullptr)) {}
 
 thread_local_stack& thread_local_stack::operator=(thread_local_stack&& other) noexcept {
     if(this != &other){
         scope = std::exchange(other.scope, 0);
         thread_stack = std::move(other.thread_stack);
         var_to_idx = std::move(other.var_to_idx);
+        regions = std::move(other.regions);
+        releaser = std::exchange(other.releaser, nullptr);
     }
     return *this;
 }
 
 void thread_local_stack::init(std::string variable_name, header* heap_ptr){
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
 
     if(var_to_idx.contains(variable_name)){
         throw std::invalid_argument("Variable already exists");
     }
+    check_escape_unlocked(scope, heap_ptr);
+    alloc_trace::record_tls_init(get_trace_id(), thread_stack.get_size(), heap_ptr);
     var_to_idx.insert(variable_name, thread_stack.get_size());
     thread_stack.push(thread_local_stack_entry{.ref_to = heap_ptr, .scope = scope, .variable_name = std::move(variable_name)});
 }
 
 void thread_local_stack::reassign_ref(const std::string& variable_name, header* new_ref_to){
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
 
     if(!var_to_idx.contains(variable_name)){
         throw std::invalid_argument("Variable doesn't exist");
     }
     size_t idx = var_to_idx[variable_name];
+    check_escape_unlocked(thread_stack[idx].scope, new_ref_to);
+    alloc_trace::record_tls_assign(get_trace_id(), idx, new_ref_to);
     thread_stack[idx].ref_to = new_ref_to;
 }
 
 void thread_local_stack::remove_ref(const std::string& variable_name){
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
 
     if(!var_to_idx.contains(variable_name)){
         throw std::invalid_argument("Variable doesn't exist");
     }
     size_t idx = var_to_idx[variable_name];
+    alloc_trace::record_tls_assign(get_trace_id(), idx, nullptr);
     thread_stack[idx].ref_to = nullptr;
 }
 
+size_t thread_local_stack::get_variable_count() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    return thread_stack.get_size();
+}
+
+header* thread_local_stack::get_ref(size_t index) {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    return index < thread_stack.get_size() ? thread_stack[index].ref_to : nullptr;
+}
+
 void thread_local_stack::push_scope() noexcept {
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    alloc_trace::record_scope_push(get_trace_id(), false);
     ++scope;
 }
 
 void thread_local_stack::pop_scope(bool destr){
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    region_releaser* region_owner = nullptr;
+    {
+        std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+
+        if((scope <= 1 && !destr) || scope == 0){
+            return;
+        }
+
+        // region without a releaser has no chunks, otherwise the heap has to lock its segments before this stack
+        region_owner = current_region_unlocked() ? releaser : nullptr;
+        if(!region_owner){
+            if(!destr){
+                alloc_trace::record_scope_pop(get_trace_id(), false);
+            }
+            if(current_region_unlocked()){
+                regions.pop();
+            }
+            pop_scope_unlocked();
+            return;
+        }
+    }
 
-    if((scope <= 1 && !destr) || scope == 0){
-        return;
+    region_owner->pop_region_scope(*this, destr);
+}
+
+void thread_local_stack::push_region_scope() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    alloc_trace::record_scope_push(get_trace_id(), true);
+    ++scope;
+    regions.push(scope_region(scope));
+}
+
+scope_region thread_local_stack::pop_region_scope() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+
+    if(scope <= 1){
+        return scope_region();
     }
 
-    while(!thread_stack.empty() && thread_stack.peek().scope == scope){
-        var_to_idx.erase(thread_stack.peek().variable_name);
-        thread_stack.pop();
+    scope_region region;
+    if(current_region_unlocked()){
+        region = std::move(regions.peek());
+        regions.pop();
     }
-    --scope;
+    pop_scope_unlocked();
+
+    return region;
+}
+
+header* thread_local_stack::region_allocate(uint32_t bytes) {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    scope_region* region = current_region_unlocked();
+    return region ? region->allocate(bytes) : nullptr;
+}
+
+bool thread_local_stack::add_region_chunk(size_t segment_index, header* chunk, region_releaser& owner) {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    scope_region* region = current_region_unlocked();
+    if(!region){
+        return false;
+    }
+    region->add_chunk(segment_index, chunk);
+    releaser = &owner;
+    return true;
+}
+
+int thread_local_stack::region_segment() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    scope_region* region = current_region_unlocked();
+    return region ? region->current_segment() : -1;
+}
+
+bool thread_local_stack::has_region() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    return current_region_unlocked() != nullptr;
+}
+
+uint64_t thread_local_stack::region_segment_mask() {
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
+    scope_region* region = current_region_unlocked();
+    return region ? region->segment_mask() : 0;
 }
 
 void thread_local_stack::accept(gc_visitor& visitor) noexcept {
-    std::lock_guard<std::mutex> tls_lock(tls_mutex);
+    std::lock_guard<profiled_mutex> tls_lock(tls_mutex);
     visitor.visit(*this);
 }
 
 indexed_stack<thread_local_stack_entry>& thread_local_stack::get_thread_stack_unlocked() noexcept {
     return thread_stack;
+}
+
+indexed_stack<scope_region>& thread_local_stack::get_regions_unlocked() noexcept {
+    return regions;
+}
+
+scope_region* thread_local_stack::current_region_unlocked() noexcept {
+    if(regions.empty() || regions.peek().get_scope() != scope){
+        return nullptr;
+    }
+    return &regions.peek();
+}
+
+void thread_local_stack::check_escape_unlocked(size_t entry_scope, header* heap_ptr) noexcept {
+    if(!heap_ptr || !heap_ptr->is_region()) return;
+
+    if(!regions.empty() && regions.peek().get_scope() == entry_scope && regions.peek().get_id() == heap_ptr->region_id()){
+        return;
+    }
+    scope_region::record_escape(heap_ptr);
+}
+
+void thread_local_stack::pop_scope_unlocked() {
+    while(!thread_stack.empty() && thread_stack.peek().scope == scope){
+        var_to_idx.erase(thread_stack.peek().variable_name);
+        thread_stack.pop();
+    }
+    --scope;
 }
\ No newline at end of file
@@ -10,6 +10,9 @@
 #include "../common/root-set/root-set-base.hpp"
 #include "../common/gc/gc-visitor.hpp"
 #include "../common/root-set/thread-local-stack-entry.hpp"
+#include "../common/scope-region/scope-region.hpp"
+#include "../common/scope-region/region-releaser.hpp"
+#include "../common/profiled-mutex/profiled-mutex.hpp"
 
 /**
  * @class thread_local_stack
@@ -18,7 +21,7 @@
 class thread_local_stack final : public root_set_base {
 private:
     /// used for tls synchronization.
-    mutable std::mutex tls_mutex; 
+    mutable profiled_mutex tls_mutex{"tls_mutex"};
 
     /// id of the last pushed scope.
     size_t scope;
@@ -29,6 +32,12 @@ private:
     /// mapping the variable name to its index inside of the thread_stack.
     hash_map<std::string, size_t> var_to_idx;
 
+    /// regions of the scopes opened with push_region_scope, innermost on top.
+    indexed_stack<scope_region> regions;
+
+    /// heap that carved the region chunks, releases regions exited through pop_scope; nullptr until the first chunk.
+    region_releaser* releaser;
+
     /**
      * @brief getter for the thread_stack.
      * @warning must be called when lock is held already.
@@ -36,6 +45,34 @@ private:
     */
     indexed_stack<thread_local_stack_entry>& get_thread_stack_unlocked() noexcept;
 
+    /**
+     * @brief getter for the regions.
+     * @warning must be called when lock is held already.
+     * @returns reference to regions.
+    */
+    indexed_stack<scope_region>& get_regions_unlocked() noexcept;
+
+    /**
+     * @brief getter for the region of the current scope.
+     * @warning must be called when lock is held already.
+     * @returns pointer to the region, nullptr if current scope has no region.
+    */
+    scope_region* current_region_unlocked() noexcept;
+
+    /**
+     * @brief records escape if region object is stored outside of its scope.
+     * @param entry_scope - scope of the variable that references the object.
+     * @param heap_ptr - pointer to the stored object.
+     * @warning must be called when lock is held already.
+    */
+    void check_escape_unlocked(size_t entry_scope, header* heap_ptr) noexcept;
+
+    /**
+     * @brief removes the variables of the current scope and exits it.
+     * @warning must be called when lock is held already.
+    */
+    void pop_scope_unlocked();
+
     /// allowing gc to access getter for the variable.
     friend class garbage_collector;
 
@@ -55,7 +92,7 @@ public:
 
     /**
      * @brief deletes the thread_local_stack.
-     * @details frees final scope if not freed manually.
+     * @details frees the scopes that weren't freed manually, their regions are released by the heap.
     */
     ~thread_local_stack();
 
@@ -68,14 +105,14 @@ public:
     /**
      * @brief constructs the thread_local_stack instance from an existing one.
      * @param other - rvalue of the existing thread_local_stack.
-     * @details moves the ownership of the scope, thread_stack and var_to_idx map from other to this.
+     * @details moves the ownership of the scope, thread_stack, var_to_idx map, regions and their releaser from other to this.
     */
     thread_local_stack(thread_local_stack&& other) noexcept;
 
     /**
      * @brief constructs new thread_local_stack by assigning it an existing one.
      * @param other - rvalue of the existing thread_local_stack.
-     * @details moves the ownership of the scope, thread_stack and var_to_idx map from other to this.
+     * @details moves the ownership of the scope, thread_stack, var_to_idx map, regions and their releaser from other to this.
     */
     thread_local_stack& operator=(thread_local_stack&& other) noexcept;
 
@@ -84,6 +121,7 @@ public:
      * @param variable_name - name of the variable.
      * @param heap_ptr - pointer to the value of the variable on the heap.
      * @throws std::invalid_argument when variable already exists.
+     * @details objects of a region other than the one of the current scope are recorded as escaped.
     */
     void init(std::string variable_name, header* heap_ptr = nullptr);
 
@@ -92,6 +130,7 @@ public:
      * @param variable_name - name of the variable.
      * @param new_ref_to - pointer to a new value on the heap.
      * @throws std::invalid_argument when variable_name is not previously initialized.
+     * @details objects of a region other than the one of the variable's scope are recorded as escaped.
     */
     void reassign_ref(const std::string& variable_name, header* new_ref_to);
 
@@ -102,6 +141,20 @@ public:
     */
     void remove_ref(const std::string& variable_name);
 
+    /**
+     * @brief getter for the number of variables of the open scopes.
+     * @returns number of variables.
+    */
+    size_t get_variable_count();
+
+    /**
+     * @brief getter for the value of a variable.
+     * @param index - index of the variable, in the order variables were initialized.
+     * @returns pointer to the value of the variable on the heap, nullptr if it has none or index is out of range.
+     * @note simulation purposes, object stays reachable only while the calling thread keeps the variable.
+    */
+    header* get_ref(size_t index);
+
     /**
      * @brief simulates entering new scope.
      * @note simulation purposes.
@@ -111,10 +164,60 @@ public:
     /**
      * @brief simulates exiting scope.
      * @param destr - flag if pop_scope is called by destructor, defaults to false.
+     * @details scope with a region is exited through the heap that carved its chunks, so the region is released.
      * @note simulation purposes.
     */
     void pop_scope(bool destr = false);
 
+    /**
+     * @brief simulates entering new scope that allocates its objects inside of a region.
+     * @note simulation purposes.
+    */
+    void push_region_scope();
+
+    /**
+     * @brief simulates exiting scope, keeping its region for releasing.
+     * @returns region of the exited scope, empty region if scope has none.
+     * @warning segments of the region must be locked, see region_segment_mask.
+    */
+    scope_region pop_region_scope();
+
+    /**
+     * @brief bump-allocates object inside of the region of the current scope.
+     * @param bytes - required memory, aligned to 16 bytes.
+     * @returns pointer to the header of the object, nullptr if there is no region or its chunk is full.
+     * @warning segment of the region's current chunk must be locked.
+    */
+    header* region_allocate(uint32_t bytes);
+
+    /**
+     * @brief adds new chunk to the region of the current scope.
+     * @param segment_index - index of the segment the chunk was allocated from.
+     * @param chunk - header of the allocated block.
+     * @param owner - reference to the heap that carved the chunk, it releases the regions of the stack.
+     * @returns true if chunk was added, false if current scope has no region.
+     * @warning segment of the chunk must be locked.
+    */
+    bool add_region_chunk(size_t segment_index, header* chunk, region_releaser& owner);
+
+    /**
+     * @brief getter for the segment the region of the current scope allocates from.
+     * @returns index of the segment, -1 if there is no region or its chunk is full.
+    */
+    int region_segment();
+
+    /**
+     * @brief checks if current scope allocates inside of a region.
+     * @returns true if current scope has a region, false otherwise.
+    */
+    bool has_region();
+
+    /**
+     * @brief getter for the segments the region of the current scope has chunks in.
+     * @returns bit mask of the segment indices, 0 if current scope has no region.
+    */
+    uint64_t region_segment_mask();
+
     /**
      * @brief accepts the gc visitor.
      * @param visitor - reference to a gc visitor.
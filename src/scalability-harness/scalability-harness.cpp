@@ -0,0 +1,185 @@
+#include "scalability-harness.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <iostream>
+
+#include "../allocators/allocators.hpp"
+#include "../heap-manager/heap-manager.hpp"
+
+scalability_harness::scalability_harness(const workload_config& config) : config(config) {}
+
+template<typename T>
+T scalability_harness::median(indexed_stack<T>& values){
+    if(values.empty()) return T{};
+    std::sort(values.begin(), values.end());
+    const size_t middle = values.get_size() >> 1;
+    return values.get_size() % 2 == 1 ? values[middle] : static_cast<T>((values[middle - 1] + values[middle]) / 2);
+}
+
+scalability_point scalability_harness::run_point(size_t mutator_threads, size_t gc_threads, uint64_t heap_mb, results_document* results) const {
+    indexed_stack<double> throughputs;
+    indexed_stack<uint64_t> allocation_p99s;
+    indexed_stack<uint64_t> gc_pause_p99s;
+    indexed_stack<size_t> gc_counts;
+    uint64_t failed_allocations = 0;
+
+    for(size_t trial = 0; trial < config.trials; ++trial){
+        heap_manager heap_mng(config.hm_threads, gc_threads, config.policy);
+        heap_mng.set_heap_limit(heap_mb << 20);
+        heap_mng.set_sampling_interval(config.sampling_interval);
+        heap_mng.set_census_enabled(config.census);
+
+        allocators allocator(heap_mng, mutator_threads, config);
+        const simulation_result result = allocator.simulate_alloc(false);
+        throughputs.push(result.allocations_per_s());
+        allocation_p99s.push(result.allocation_p99_ns);
+        gc_pause_p99s.push(result.gc_pause_p99_ns);
+        gc_counts.push(result.gc_count);
+        failed_allocations += result.failed_allocations;
+    }
+
+    if(results != nullptr){
+        const std::string prefix = std::format("scalability/heap {} MB/gc threads {}/mutator threads {}",
+            heap_mb == 0 ? HEAP_CAPACITY >> 20 : heap_mb, gc_threads, mutator_threads
+        );
+        indexed_stack<double> throughput_samples;
+        indexed_stack<double> gc_pause_samples;
+        indexed_stack<double> allocation_samples;
+        for(size_t i = 0; i < throughputs.get_size(); ++i){
+            throughput_samples.push(throughputs[i]);
+            gc_pause_samples.push(static_cast<double>(gc_pause_p99s[i]));
+            allocation_samples.push(static_cast<double>(allocation_p99s[i]));
+        }
+        results->add_metric(prefix + "/throughput", "allocs/s", metric_goal::higher, std::move(throughput_samples));
+        results->add_metric(prefix + "/gc pause p99", "ns", metric_goal::lower, std::move(gc_pause_samples));
+        if constexpr (LATENCY_HISTOGRAMS_ENABLED){
+            results->add_metric(prefix + "/allocation p99", "ns", metric_goal::lower, std::move(allocation_samples));
+        }
+    }
+
+    // extremes are read before median reorders the throughputs
+    const auto [min_throughput, max_throughput] = std::minmax_element(throughputs.begin(), throughputs.end());
+    const double throughput_min = throughputs.empty() ? 0.0 : *min_throughput;
+    const double throughput_max = throughputs.empty() ? 0.0 : *max_throughput;
+    const double throughput_median = median(throughputs);
+    return scalability_point{
+        .mutator_threads = mutator_threads,
+        .gc_threads = gc_threads,
+        .heap_mb = heap_mb == 0 ? HEAP_CAPACITY >> 20 : heap_mb,
+        .trials = config.trials,
+        .throughput_median = throughput_median,
+        .throughput_min = throughput_min,
+        .throughput_max = throughput_max,
+        .speedup = 1.0,
+        .efficiency = 1.0,
+        .allocation_p99_ns = median(allocation_p99s),
+        .gc_pause_p99_ns = median(gc_pause_p99s),
+        .gc_count = median(gc_counts),
+        .failed_allocations = failed_allocations,
+        .plateau = false
+    };
+}
+
+void scalability_harness::finish_series(size_t first, size_t last){
+    if(first == last) return;
+    std::sort(points.begin() + first, points.begin() + last, [](const scalability_point& a, const scalability_point& b) -> bool {
+        return a.mutator_threads < b.mutator_threads;
+    });
+
+    const scalability_point& base = points[first];
+    for(size_t i = first; i < last; ++i){
+        scalability_point& point = points[i];
+        point.speedup = base.throughput_median == 0 ? 0.0 : point.throughput_median / base.throughput_median;
+        const double relative_threads = static_cast<double>(point.mutator_threads) / static_cast<double>(base.mutator_threads);
+        point.efficiency = point.speedup / relative_threads;
+        if(i > first){
+            const double previous = points[i - 1].throughput_median;
+            point.plateau = previous == 0 || point.throughput_median < previous * (1.0 + SCALING_MIN_GAIN);
+        }
+    }
+}
+
+void scalability_harness::run(results_document* results){
+    indexed_stack<size_t> gc_thread_counts;
+    for(size_t gc_threads : config.sweep_gc_threads) gc_thread_counts.push(gc_threads);
+    if(gc_thread_counts.empty()) gc_thread_counts.push(config.gc_threads);
+    indexed_stack<uint64_t> heap_sizes;
+    for(uint64_t heap_mb : config.sweep_heap_mb) heap_sizes.push(heap_mb);
+    if(heap_sizes.empty()) heap_sizes.push(config.heap_mb);
+
+    const size_t total_points = gc_thread_counts.get_size() * heap_sizes.get_size() * config.mutator_threads.get_size();
+    points = indexed_stack<scalability_point>();
+    for(uint64_t heap_mb : heap_sizes){
+        for(size_t gc_threads : gc_thread_counts){
+            const size_t series_start = points.get_size();
+            for(size_t mutator_threads : config.mutator_threads){
+                std::cout << std::format("[{}/{}] mutator threads {}, gc threads {}, heap {} MB, {} trials\n",
+                    points.get_size() + 1, total_points, mutator_threads, gc_threads, heap_mb == 0 ? HEAP_CAPACITY >> 20 : heap_mb, config.trials
+                );
+                points.push(run_point(mutator_threads, gc_threads, heap_mb, results));
+            }
+            finish_series(series_start, points.get_size());
+        }
+    }
+}
+
+const indexed_stack<scalability_point>& scalability_harness::get_points() const noexcept {
+    return points;
+}
+
+bool scalability_harness::write_csv(const std::string& path) const {
+    std::ofstream out(path);
+    if(!out) return false;
+
+    out << "mutator_threads,gc_threads,heap_mb,trials,throughput_median,throughput_min,throughput_max,speedup,efficiency,"
+           "allocation_p99_ns,gc_pause_p99_ns,gc_count,failed_allocations,plateau\n";
+    for(const scalability_point& point : points){
+        out << std::format("{},{},{},{},{:.1f},{:.1f},{:.1f},{:.4f},{:.4f},{},{},{},{},{}\n",
+            point.mutator_threads, point.gc_threads, point.heap_mb, point.trials, point.throughput_median, point.throughput_min,
+            point.throughput_max, point.speedup, point.efficiency, point.allocation_p99_ns, point.gc_pause_p99_ns, point.gc_count,
+            point.failed_allocations, point.plateau ? 1 : 0
+        );
+    }
+    return static_cast<bool>(out);
+}
+
+std::string scalability_harness::summary() const {
+    std::string text = std::format("Scalability ({} trials per point, median throughput):\n", config.trials);
+    text += std::format("  {:>8} {:>8} {:>8} {:>14} {:>14} {:>8} {:>10} {:>14} {:>14} {:>10}\n",
+        "heap MB", "gc thr", "mutators", "allocs/s", "range (+/-%)", "speedup", "efficiency", "alloc p99 (us)", "gc p99 (ms)", "failed"
+    );
+
+    for(size_t first = 0; first < points.get_size();){
+        size_t last = first;
+        while(last < points.get_size() && points[last].gc_threads == points[first].gc_threads && points[last].heap_mb == points[first].heap_mb){
+            ++last;
+        }
+
+        const scalability_point* stop = nullptr;
+        for(size_t i = first; i < last; ++i){
+            const scalability_point& point = points[i];
+            const double spread = point.throughput_median == 0 ? 0.0 : (point.throughput_max - point.throughput_min) / 2 / point.throughput_median * 100;
+            text += std::format("  {:>8} {:>8} {:>8} {:>14.0f} {:>14.1f} {:>8.2f} {:>9.1f}% {:>14.1f} {:>14.3f} {:>10}{}\n",
+                point.heap_mb, point.gc_threads, point.mutator_threads, point.throughput_median, spread, point.speedup,
+                point.efficiency * 100, point.allocation_p99_ns / 1e3, point.gc_pause_p99_ns / 1e6, point.failed_allocations,
+                point.plateau ? "  plateau" : ""
+            );
+            if(point.plateau && stop == nullptr) stop = &points[i - 1];
+        }
+
+        if(stop != nullptr){
+            text += std::format("  -> scaling stops at {} mutator threads (gc threads {}, heap {} MB)\n", stop->mutator_threads, stop->gc_threads, stop->heap_mb);
+        }
+        else {
+            text += std::format("  -> scales up to {} mutator threads (gc threads {}, heap {} MB)\n", points[last - 1].mutator_threads, points[first].gc_threads, points[first].heap_mb);
+        }
+        first = last;
+    }
+
+    if constexpr (!LATENCY_HISTOGRAMS_ENABLED){
+        text += "  alloc p99 is 0 unless built with GCSIM_LATENCY_HISTOGRAMS\n";
+    }
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#ifndef SCALABILITY_HARNESS_HPP
+#define SCALABILITY_HARNESS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "../common/indexed-stack/indexed-stack.hpp"
+#include "../workload-config/workload-config.hpp"
+#include "../common/results-document/results-document.hpp"
+
+/// smallest relative throughput gain over the previous thread count that still counts as scaling.
+constexpr double SCALING_MIN_GAIN = 0.05;
+
+/**
+ * @struct scalability_point
+ * @brief aggregated trials of a single mutator threads x gc threads x heap size combination.
+*/
+struct scalability_point {
+    /// number of mutator threads.
+    size_t mutator_threads;
+
+    /// number of gc threads.
+    size_t gc_threads;
+
+    /// usable heap size in MB.
+    uint64_t heap_mb;
+
+    /// number of trials the point aggregates.
+    size_t trials;
+
+    /// median allocation throughput of the trials in allocations per second.
+    double throughput_median;
+
+    /// lowest allocation throughput of the trials in allocations per second.
+    double throughput_min;
+
+    /// highest allocation throughput of the trials in allocations per second.
+    double throughput_max;
+
+    /// median throughput relative to the lowest mutator thread count of the series.
+    double speedup;
+
+    /// speedup divided by the relative thread count of the series.
+    double efficiency;
+
+    /// median of the trials' 99th percentile allocation latencies in nanoseconds.
+    uint64_t allocation_p99_ns;
+
+    /// median of the trials' 99th percentile gc pauses in nanoseconds.
+    uint64_t gc_pause_p99_ns;
+
+    /// median number of gc cycles of the trials.
+    size_t gc_count;
+
+    /// failed allocations summed over the trials.
+    uint64_t failed_allocations;
+
+    /// whether the gain over the previous thread count of the series is below SCALING_MIN_GAIN.
+    bool plateau;
+};
+
+/**
+ * @class scalability_harness
+ * @brief sweeps mutator threads x gc threads x heap size, repeating every combination on a fresh heap.
+ * @details a series is the points sharing gc threads and heap size, ordered by mutator threads.
+ * Speedup and efficiency are relative to the first point of the series.
+*/
+class scalability_harness {
+private:
+    /// parameters of the workload and the sweep.
+    const workload_config& config;
+
+    /// aggregated points in series order.
+    indexed_stack<scalability_point> points;
+
+    /**
+     * @brief runs the trials of a single combination.
+     * @param mutator_threads - number of mutator threads.
+     * @param gc_threads - number of gc threads.
+     * @param heap_mb - usable heap size in MB, 0 uses the whole heap.
+     * @param results - pointer to the document the trials are added to, nullptr if they aren't recorded.
+     * @returns aggregated point, without speedup, efficiency and plateau.
+    */
+    scalability_point run_point(size_t mutator_threads, size_t gc_threads, uint64_t heap_mb, results_document* results) const;
+
+    /**
+     * @brief fills speedup, efficiency and plateau of a series.
+     * @param first - index of the first point of the series.
+     * @param last - index past the last point of the series.
+    */
+    void finish_series(size_t first, size_t last);
+
+    /**
+     * @brief calculates the median of the values.
+     * @param values - values, reordered by the call.
+     * @returns median, 0 if there are no values.
+    */
+    template<typename T>
+    static T median(indexed_stack<T>& values);
+
+public:
+    /**
+     * @brief creates the harness.
+     * @param config - const reference to the parameters of the sweep, must outlive the harness.
+    */
+    explicit scalability_harness(const workload_config& config);
+
+    /**
+     * @brief deletes the harness.
+    */
+    ~scalability_harness() = default;
+
+    /// deleted copy constructor.
+    scalability_harness(const scalability_harness&) = delete;
+
+    /// deleted assignment operator.
+    scalability_harness& operator=(const scalability_harness&) = delete;
+
+    /**
+     * @brief runs the sweep, printing progress after every point.
+     * @param results - pointer to the document the trials of every point are added to, nullptr if they aren't recorded.
+    */
+    void run(results_document* results = nullptr);
+
+    /**
+     * @brief getter for the aggregated points.
+     * @returns const reference to the points in series order.
+    */
+    const indexed_stack<scalability_point>& get_points() const noexcept;
+
+    /**
+     * @brief writes the points as CSV.
+     * @param path - path of the file.
+     * @returns true if the file was written, false otherwise.
+    */
+    bool write_csv(const std::string& path) const;
+
+    /**
+     * @brief formats the points as a table with the thread count where scaling stops in every series.
+     * @returns summary of the sweep.
+    */
+    std::string summary() const;
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "trace-replayer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+#include "../root-set-table/thread-local-stack.hpp"
+#include "../root-set-table/global-root.hpp"
+#include "../root-set-table/register-root.hpp"
+
+trace_replayer::trace_replayer() : op_counts{}, root_count(0), current_epoch(0) {}
+
+bool trace_replayer::load(const std::string& path){
+    std::ifstream file(path, std::ios::binary);
+    if(!file) return false;
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if(contents.size() < ALLOC_TRACE_MAGIC_LENGTH || contents.compare(0, ALLOC_TRACE_MAGIC_LENGTH, ALLOC_TRACE_MAGIC) != 0){
+        return false;
+    }
+
+    size_t stream_index[MAX_ALLOC_TRACE_THREADS + 1];
+    std::fill(std::begin(stream_index), std::end(stream_index), std::numeric_limits<size_t>::max());
+    streams = indexed_stack<trace_stream>();
+
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(contents.data()) + ALLOC_TRACE_MAGIC_LENGTH;
+    const uint8_t* end = reinterpret_cast<const uint8_t*>(contents.data()) + contents.size();
+    while(ptr < end){
+        uint64_t thread_id = 0;
+        uint64_t length = 0;
+        if(!alloc_trace::read_varint(ptr, end, thread_id) || !alloc_trace::read_varint(ptr, end, length)) return false;
+        if(thread_id == 0 || thread_id > MAX_ALLOC_TRACE_THREADS || length > static_cast<uint64_t>(end - ptr)) return false;
+
+        if(stream_index[thread_id] == std::numeric_limits<size_t>::max()){
+            stream_index[thread_id] = streams.get_size();
+            streams.push(trace_stream{.thread_id = static_cast<uint32_t>(thread_id), .bytes = {}});
+        }
+        streams[stream_index[thread_id]].bytes.append(reinterpret_cast<const char*>(ptr), static_cast<size_t>(length));
+        ptr += length;
+    }
+
+    return scan();
+}
+
+bool trace_replayer::scan(){
+    std::fill(std::begin(op_counts), std::end(op_counts), 0);
+    root_count = 0;
+
+    indexed_stack<std::pair<uint64_t, root_kind>> added_roots;
+    for(const trace_stream& stream : streams){
+        const uint8_t* ptr = reinterpret_cast<const uint8_t*>(stream.bytes.data());
+        const uint8_t* end = ptr + stream.bytes.size();
+        replay_event event{};
+        while(ptr < end){
+            if(!next_event(ptr, end, event)) return false;
+            ++op_counts[static_cast<size_t>(event.op)];
+            if(event.op == alloc_trace_op::root_add){
+                if(event.operands[1] >= ROOT_KIND_COUNT) return false;
+                added_roots.push(std::pair{event.operands[0], static_cast<root_kind>(event.operands[1])});
+                root_count = std::max(root_count, event.operands[0] + 1);
+            }
+        }
+    }
+
+    root_kinds = std::make_unique<root_kind[]>(root_count);
+    for(const auto& [root_id, kind] : added_roots){
+        root_kinds[root_id] = kind;
+    }
+    return true;
+}
+
+bool trace_replayer::next_event(const uint8_t*& ptr, const uint8_t* end, replay_event& event) noexcept {
+    if(ptr >= end || *ptr >= ALLOC_TRACE_OP_COUNT) return false;
+    event.op = static_cast<alloc_trace_op>(*ptr++);
+    if(!alloc_trace::read_varint(ptr, end, event.delta_ns)) return false;
+
+    const size_t operand_count = alloc_trace::operand_count(event.op);
+    for(size_t i = 0; i < operand_count; ++i){
+        if(!alloc_trace::read_varint(ptr, end, event.operands[i])) return false;
+    }
+    return true;
+}
+
+replay_stats trace_replayer::replay(heap_manager& heap_mng, replay_timing timing){
+    const size_t stream_count = streams.get_size();
+    roots = std::make_unique<std::atomic<root_set_base*>[]>(root_count);
+    reached_epochs = std::make_unique<std::atomic<uint64_t>[]>(stream_count);
+    current_epoch.store(0, std::memory_order_relaxed);
+
+    std::unique_ptr<replay_stats[]> stream_stats = std::make_unique<replay_stats[]>(stream_count);
+    const uint64_t start_ns = gc_pause_report::clock_ns();
+    {
+        std::unique_ptr<std::jthread[]> threads = std::make_unique<std::jthread[]>(stream_count);
+        for(size_t i = 0; i < stream_count; ++i){
+            threads[i] = std::jthread([this, i, &heap_mng, timing, start_ns, &stream_stats] -> void {
+                replay_stream(i, heap_mng, timing, start_ns, stream_stats[i]);
+            });
+        }
+    }
+
+    replay_stats stats{};
+    for(size_t i = 0; i < stream_count; ++i){
+        stats.merge(stream_stats[i]);
+    }
+    stats.duration_ns = gc_pause_report::clock_ns() - start_ns;
+    stats.threads = stream_count;
+    return stats;
+}
+
+void trace_replayer::replay_stream(size_t index, heap_manager& heap_mng, replay_timing timing, uint64_t start_ns, replay_stats& stats){
+    const trace_stream& stream = streams[index];
+    const uint8_t* ptr = reinterpret_cast<const uint8_t*>(stream.bytes.data());
+    const uint8_t* end = ptr + stream.bytes.size();
+
+    header* recent[ALLOC_TRACE_RECENT_OBJECTS]{};
+    uint64_t allocations = 0;
+    uint64_t offset_ns = 0;
+    replay_event event{};
+
+    while(next_event(ptr, end, event)){
+        offset_ns += event.delta_ns;
+        if(timing == replay_timing::recorded){
+            const uint64_t now_ns = gc_pause_report::clock_ns();
+            if(start_ns + offset_ns > now_ns + MIN_REPLAY_SLEEP_NS){
+                std::this_thread::sleep_for(std::chrono::nanoseconds(start_ns + offset_ns - now_ns));
+            }
+        }
+
+        try {
+            apply(index, heap_mng, event, recent, allocations, stats);
+        }
+        catch(const std::exception&){
+            ++stats.errors;
+        }
+        ++stats.events;
+    }
+
+    reached_epochs[index].store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+    reached_epochs[index].notify_all();
+}
+
+void trace_replayer::apply(size_t index, heap_manager& heap_mng, const replay_event& event, header** recent, uint64_t& allocations, replay_stats& stats){
+    const uint64_t root_id = event.operands[0];
+    auto record_allocation = [&](header* obj) -> void {
+        recent[allocations % ALLOC_TRACE_RECENT_OBJECTS] = obj;
+        ++allocations;
+        ++stats.allocations;
+        if(!obj) ++stats.failed_allocations;
+    };
+
+    switch(event.op){
+        case alloc_trace_op::epoch: {
+            const uint64_t epoch = event.operands[0];
+            reached_epochs[index].store(epoch, std::memory_order_release);
+            reached_epochs[index].notify_all();
+            for(uint64_t current = current_epoch.load(std::memory_order_acquire); current < epoch; current = current_epoch.load(std::memory_order_acquire)){
+                current_epoch.wait(current, std::memory_order_acquire);
+            }
+            break;
+        }
+        case alloc_trace_op::alloc:
+            record_allocation(heap_mng.allocate(static_cast<uint32_t>(event.operands[0])));
+            break;
+        case alloc_trace_op::alloc_in_scope: {
+            const uint32_t bytes = static_cast<uint32_t>(event.operands[1]);
+            thread_local_stack* tls = static_cast<thread_local_stack*>(wait_for_root(root_id, stats));
+            record_allocation(tls ? heap_mng.allocate_in_scope(*tls, bytes) : heap_mng.allocate(bytes));
+            break;
+        }
+        case alloc_trace_op::root_add: {
+            if(root_id >= root_count) break;
+            std::unique_ptr<root_set_base> root;
+            switch(root_kinds[root_id]){
+                case root_kind::tls: root = std::make_unique<thread_local_stack>(); break;
+                case root_kind::global: root = std::make_unique<global_root>(nullptr); break;
+                case root_kind::reg: root = std::make_unique<register_root>(nullptr); break;
+            }
+            root_set_base* root_ptr = root.get();
+            heap_mng.add_root(root_key(root_id), std::move(root));
+            roots[root_id].store(root_ptr, std::memory_order_release);
+            ++stats.root_operations;
+            break;
+        }
+        case alloc_trace_op::root_remove:
+            if(root_id >= root_count) break;
+            roots[root_id].store(nullptr, std::memory_order_release);
+            heap_mng.remove_root(root_key(root_id));
+            ++stats.root_operations;
+            break;
+        case alloc_trace_op::root_set:
+        case alloc_trace_op::root_clear: {
+            root_set_base* root = wait_for_root(root_id, stats);
+            if(!root) break;
+            header* obj = event.op == alloc_trace_op::root_set ? resolve(event.operands[1], recent, allocations) : nullptr;
+            switch(root_kinds[root_id]){
+                case root_kind::tls: static_cast<thread_local_stack*>(root)->remove_ref(variable_name(event.operands[1])); break;
+                case root_kind::global: static_cast<global_root*>(root)->set_global_variable(obj); break;
+                case root_kind::reg: static_cast<register_root*>(root)->set_register_variable(obj); break;
+            }
+            ++stats.root_operations;
+            break;
+        }
+        case alloc_trace_op::tls_init:
+        case alloc_trace_op::tls_assign: {
+            thread_local_stack* tls = static_cast<thread_local_stack*>(wait_for_root(root_id, stats));
+            if(!tls) break;
+            header* obj = resolve(event.operands[2], recent, allocations);
+            if(event.op == alloc_trace_op::tls_init) tls->init(variable_name(event.operands[1]), obj);
+            else tls->reassign_ref(variable_name(event.operands[1]), obj);
+            ++stats.root_operations;
+            break;
+        }
+        case alloc_trace_op::scope_push: {
+            thread_local_stack* tls = static_cast<thread_local_stack*>(wait_for_root(root_id, stats));
+            if(!tls) break;
+            if(event.operands[1]) tls->push_region_scope();
+            else tls->push_scope();
+            ++stats.scope_operations;
+            break;
+        }
+        case alloc_trace_op::scope_pop:
+        case alloc_trace_op::region_release: {
+            thread_local_stack* tls = static_cast<thread_local_stack*>(wait_for_root(root_id, stats));
+            if(!tls) break;
+            if(event.op == alloc_trace_op::region_release) heap_mng.pop_region_scope(*tls);
+            else tls->pop_scope();
+            ++stats.scope_operations;
+            break;
+        }
+        case alloc_trace_op::reset: {
+            const uint64_t epoch = current_epoch.load(std::memory_order_acquire);
+            for(size_t i = 0; i < streams.get_size(); ++i){
+                if(i == index) continue;
+                for(uint64_t reached = reached_epochs[i].load(std::memory_order_acquire); reached <= epoch; reached = reached_epochs[i].load(std::memory_order_acquire)){
+                    reached_epochs[i].wait(reached, std::memory_order_acquire);
+                }
+            }
+
+            for(uint64_t i = 0; i < root_count; ++i){
+                roots[i].store(nullptr, std::memory_order_relaxed);
+            }
+            heap_mng.reset();
+            ++stats.resets;
+
+            reached_epochs[index].store(epoch + 1, std::memory_order_release);
+            current_epoch.store(epoch + 1, std::memory_order_release);
+            current_epoch.notify_all();
+            break;
+        }
+    }
+}
+
+root_set_base* trace_replayer::wait_for_root(uint64_t root_id, replay_stats& stats) const noexcept {
+    if(root_id >= root_count) return nullptr;
+
+    root_set_base* root = roots[root_id].load(std::memory_order_acquire);
+    const uint64_t deadline_ns = root ? 0 : gc_pause_report::clock_ns() + ROOT_WAIT_TIMEOUT_NS;
+    while(!root){
+        if(gc_pause_report::clock_ns() >= deadline_ns){
+            ++stats.unresolved_roots;
+            return nullptr;
+        }
+        std::this_thread::yield();
+        root = roots[root_id].load(std::memory_order_acquire);
+    }
+    return root;
+}
+
+header* trace_replayer::resolve(uint64_t ref, header* const* recent, uint64_t allocations) noexcept {
+    if(ref == 0 || ref > allocations || ref > ALLOC_TRACE_RECENT_OBJECTS) return nullptr;
+    return recent[(allocations - ref) % ALLOC_TRACE_RECENT_OBJECTS];
+}
+
+std::string trace_replayer::root_key(uint64_t root_id){
+    return std::format("replay-{}", root_id);
+}
+
+std::string trace_replayer::variable_name(uint64_t slot){
+    return std::format("v{}", slot);
+}
+
+size_t trace_replayer::get_stream_count() const noexcept {
+    return streams.get_size();
+}
+
+uint64_t trace_replayer::get_op_count(alloc_trace_op op) const noexcept {
+    return op_counts[static_cast<size_t>(op)];
+}
\ No newline at end of file
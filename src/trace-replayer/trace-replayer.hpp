@@ -0,0 +1,275 @@
+#ifndef TRACE_REPLAYER_HPP
+#define TRACE_REPLAYER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "../heap-manager/heap-manager.hpp"
+#include "../alloc-trace/alloc-trace.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
+
+/// maximum number of operands of a trace event.
+constexpr size_t MAX_TRACE_OPERANDS = 3;
+
+/// shortest wait before an event that is slept instead of replayed immediately, in nanoseconds.
+constexpr uint64_t MIN_REPLAY_SLEEP_NS = 50'000;
+
+/// longest wait for a root that another stream adds, in nanoseconds.
+constexpr uint64_t ROOT_WAIT_TIMEOUT_NS = 1'000'000'000;
+
+/**
+ * @enum replay_timing
+ * @brief defines how the events of a stream are spaced during replay.
+ * @details recorded - every event waits until its recorded time since the start of the trace.
+ * fast - events are replayed as fast as possible, threads still wait for the roots and resets they depend on.
+*/
+enum class replay_timing { recorded, fast };
+
+/**
+ * @struct replay_event
+ * @brief decoded event of a trace stream.
+*/
+struct replay_event {
+    /// opcode of the event.
+    alloc_trace_op op;
+
+    /// nanoseconds since the previous event of the stream.
+    uint64_t delta_ns;
+
+    /// operands of the event, see alloc_trace_op.
+    uint64_t operands[MAX_TRACE_OPERANDS];
+};
+
+/**
+ * @struct trace_stream
+ * @brief events of a single recorded thread.
+*/
+struct trace_stream {
+    /// id of the recorded thread.
+    uint32_t thread_id;
+
+    /// encoded events, in the order they were recorded.
+    std::string bytes;
+};
+
+/**
+ * @struct replay_stats
+ * @brief operations done by a replay.
+*/
+struct replay_stats {
+    /// number of replayed events.
+    uint64_t events;
+
+    /// number of replayed allocations.
+    uint64_t allocations;
+
+    /// number of replayed allocations that returned nullptr.
+    uint64_t failed_allocations;
+
+    /// number of replayed root additions, removals and variable updates.
+    uint64_t root_operations;
+
+    /// number of replayed scope pushes and pops.
+    uint64_t scope_operations;
+
+    /// number of replayed heap resets.
+    uint64_t resets;
+
+    /// number of events that threw, e.g. a tls variable that no longer exists.
+    uint64_t errors;
+
+    /// number of events skipped because their root wasn't added within ROOT_WAIT_TIMEOUT_NS.
+    uint64_t unresolved_roots;
+
+    /// wall time of the replay in nanoseconds.
+    uint64_t duration_ns;
+
+    /// number of replay threads.
+    size_t threads;
+
+    /**
+     * @brief adds the operations of other stats to this one.
+     * @param other - const reference to the stats that are merged.
+    */
+    void merge(const replay_stats& other) noexcept {
+        events += other.events;
+        allocations += other.allocations;
+        failed_allocations += other.failed_allocations;
+        root_operations += other.root_operations;
+        scope_operations += other.scope_operations;
+        resets += other.resets;
+        errors += other.errors;
+        unresolved_roots += other.unresolved_roots;
+    }
+
+    /**
+     * @brief calculates the allocation throughput of the replay.
+     * @returns allocations per second, 0 if replay took no time.
+    */
+    double allocations_per_s() const noexcept {
+        return duration_ns == 0 ? 0.0 : static_cast<double>(allocations) * 1e9 / static_cast<double>(duration_ns);
+    }
+};
+
+/**
+ * @class trace_replayer
+ * @brief replays an allocation trace on a heap, one thread per recorded thread.
+ * @details objects referenced by root operations are resolved among the recent allocations of the replaying thread,
+ * the same way they were encoded. A thread waits for the roots it uses to be added by other threads,
+ * and a reset waits for every other thread to finish its events of the current epoch.
+*/
+class trace_replayer {
+private:
+    /// event streams of the recorded threads.
+    indexed_stack<trace_stream> streams;
+
+    /// number of events of each opcode.
+    uint64_t op_counts[ALLOC_TRACE_OP_COUNT];
+
+    /// largest root id + 1.
+    uint64_t root_count;
+
+    /// kind of each root, indexed by root id.
+    std::unique_ptr<root_kind[]> root_kinds;
+
+    /// replayed roots, indexed by root id, nullptr until added.
+    std::unique_ptr<std::atomic<root_set_base*>[]> roots;
+
+    /// epoch each stream has finished the events before, UINT64_MAX once the stream is done.
+    std::unique_ptr<std::atomic<uint64_t>[]> reached_epochs;
+
+    /// number of replayed resets.
+    std::atomic<uint64_t> current_epoch;
+
+    /**
+     * @brief decodes the next event of a stream.
+     * @param ptr - reference to the read position, advanced past the event.
+     * @param end - end of the stream.
+     * @param event - reference to the decoded event.
+     * @returns true if an event was decoded, false at the end of the stream or on malformed input.
+    */
+    static bool next_event(const uint8_t*& ptr, const uint8_t* end, replay_event& event) noexcept;
+
+    /**
+     * @brief decodes every stream, counting the opcodes and collecting the roots.
+     * @returns true if all streams are well formed, false otherwise.
+    */
+    bool scan();
+
+    /**
+     * @brief replays the events of a stream.
+     * @param index - index of the stream.
+     * @param heap_mng - reference to the heap the events are replayed on.
+     * @param timing - spacing of the events.
+     * @param start_ns - start of the replay on the steady clock.
+     * @param stats - reference to the stats of the stream.
+    */
+    void replay_stream(size_t index, heap_manager& heap_mng, replay_timing timing, uint64_t start_ns, replay_stats& stats);
+
+    /**
+     * @brief replays a single event.
+     * @param index - index of the stream.
+     * @param heap_mng - reference to the heap the event is replayed on.
+     * @param event - const reference to the event.
+     * @param recent - most recent allocations of the stream, indexed by allocation count modulo ALLOC_TRACE_RECENT_OBJECTS.
+     * @param allocations - reference to the number of allocations of the stream.
+     * @param stats - reference to the stats of the stream.
+    */
+    void apply(size_t index, heap_manager& heap_mng, const replay_event& event, header** recent, uint64_t& allocations, replay_stats& stats);
+
+    /**
+     * @brief waits until the root is added.
+     * @param root_id - id of the root.
+     * @param stats - reference to the stats of the stream, counts the root as unresolved if the wait times out.
+     * @returns pointer to the root, nullptr if id isn't in the trace or root isn't added within ROOT_WAIT_TIMEOUT_NS.
+     * @details a root removed by another stream before the event is never added again, so the wait is bounded.
+    */
+    root_set_base* wait_for_root(uint64_t root_id, replay_stats& stats) const noexcept;
+
+    /**
+     * @brief resolves the encoded reference among the recent allocations.
+     * @param ref - encoded reference, see alloc_trace_op.
+     * @param recent - most recent allocations of the stream.
+     * @param allocations - number of allocations of the stream.
+     * @returns pointer to the object, nullptr for 0 or an unknown reference.
+    */
+    static header* resolve(uint64_t ref, header* const* recent, uint64_t allocations) noexcept;
+
+    /**
+     * @brief getter for the key of a replayed root.
+     * @param root_id - id of the root.
+     * @returns key of the root in the root-set table.
+    */
+    static std::string root_key(uint64_t root_id);
+
+    /**
+     * @brief getter for the name of a replayed tls variable.
+     * @param slot - index of the variable in the stack of the tls.
+     * @returns name of the variable.
+    */
+    static std::string variable_name(uint64_t slot);
+
+public:
+    /**
+     * @brief creates an empty replayer.
+    */
+    trace_replayer();
+
+    /**
+     * @brief deletes the replayer.
+    */
+    ~trace_replayer() = default;
+
+    /// deleted copy constructor.
+    trace_replayer(const trace_replayer&) = delete;
+
+    /// deleted assignment operator.
+    trace_replayer& operator=(const trace_replayer&) = delete;
+
+    /**
+     * @brief reads the trace file.
+     * @param path - path of the trace file.
+     * @returns true if the trace was read and is well formed, false otherwise.
+    */
+    bool load(const std::string& path);
+
+    /**
+     * @brief replays the loaded trace on the heap.
+     * @param heap_mng - reference to the heap, should be freshly created.
+     * @param timing - spacing of the events.
+     * @returns operations done by the replay.
+    */
+    replay_stats replay(heap_manager& heap_mng, replay_timing timing);
+
+    /**
+     * @brief getter for the number of streams.
+     * @returns number of recorded threads in the trace.
+    */
+    size_t get_stream_count() const noexcept;
+
+    /**
+     * @brief getter for the number of events of an opcode.
+     * @param op - opcode.
+     * @returns number of events of the opcode in the trace.
+    */
+    uint64_t get_op_count(alloc_trace_op op) const noexcept;
+
+    /**
+     * @brief getter for the name of the replay timing.
+     * @param timing - replay timing.
+     * @returns name of the timing.
+    */
+    static constexpr const char* replay_timing_name(replay_timing timing) noexcept {
+        switch(timing){
+            case replay_timing::recorded: return "recorded";
+            case replay_timing::fast: return "fast";
+        }
+        return "unknown";
+    }
+
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,425 @@
+#include "workload-config.hpp"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+workload_config::workload_config() {
+    for(size_t thread_count : DEFAULT_MUTATOR_THREADS){
+        mutator_threads.push(thread_count);
+    }
+}
+
+void workload_config::apply_preset(simulation_mode preset) noexcept {
+    mode = preset;
+    switch(preset){
+        case simulation_mode::stress:
+            tls_scopes = TLS_SCOPE_COUNT_STRESS;
+            tls_allocs_per_scope = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE;
+            tls_map_capacity = TLS_MAP_CAPACITY_STRESS;
+            global_allocs = GLOBAL_ALLOC_STRESS_THRESHOLD;
+            register_allocs = REGISTER_ALLOC_STRESS_THRESHOLD;
+            break;
+        case simulation_mode::relaxed:
+            tls_scopes = TLS_SCOPE_COUNT_RELAXED;
+            tls_allocs_per_scope = TLS_ALLOC_RELAXED_THRESHOLD_PER_SCOPE;
+            tls_map_capacity = TLS_MAP_CAPACITY_RELAXED;
+            global_allocs = GLOBAL_ALLOC_RELAXED_THRESHOLD;
+            register_allocs = REGISTER_ALLOC_RELAXED_THRESHOLD;
+            break;
+    }
+}
+
+size_range workload_config::parse_size_range(std::string_view key, std::string_view value){
+    const size_t dash = value.find('-');
+    if(dash == std::string_view::npos){
+        throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected min-max", value, key));
+    }
+    return size_range{parse_number<uint32_t>(key, value.substr(0, dash)), parse_number<uint32_t>(key, value.substr(dash + 1))};
+}
+
+std::string_view workload_config::trim(std::string_view text) noexcept {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if(first == std::string_view::npos) return {};
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+void workload_config::set(std::string_view key, std::string_view value){
+    if(key == "mode"){
+        if(value == "stress") apply_preset(simulation_mode::stress);
+        else if(value == "relaxed") apply_preset(simulation_mode::relaxed);
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected stress or relaxed", value, key));
+    }
+    else if(key == "hm-threads") hm_threads = parse_number<size_t>(key, value);
+    else if(key == "gc-threads") gc_threads = parse_number<size_t>(key, value);
+    else if(key == "mutator-threads") mutator_threads = parse_number_list<size_t>(key, value);
+    else if(key == "policy"){
+        if(value == "round-robin") policy = allocation_policy::round_robin;
+        else if(value == "fullest-first") policy = allocation_policy::fullest_first;
+        else if(value == "thread-affinity") policy = allocation_policy::thread_affinity;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected round-robin, fullest-first or thread-affinity", value, key));
+    }
+    else if(key == "backend"){
+        if(value == "gc") backend = allocation_backend::gc;
+        else if(value == "malloc") backend = allocation_backend::malloc;
+        else if(value == "both") backend = allocation_backend::both;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected gc, malloc or both", value, key));
+    }
+    else if(key == "tls-roots") tls_roots = parse_number<size_t>(key, value);
+    else if(key == "global-roots") global_roots = parse_number<size_t>(key, value);
+    else if(key == "register-roots") register_roots = parse_number<size_t>(key, value);
+    else if(key == "tls-scopes") tls_scopes = parse_number<size_t>(key, value);
+    else if(key == "tls-allocs-per-scope") tls_allocs_per_scope = parse_number<size_t>(key, value);
+    else if(key == "tls-map-capacity") tls_map_capacity = parse_number<size_t>(key, value);
+    else if(key == "scope-depth") scope_depth = parse_number<size_t>(key, value);
+    else if(key == "global-allocs") global_allocs = parse_number<size_t>(key, value);
+    else if(key == "register-allocs") register_allocs = parse_number<size_t>(key, value);
+    else if(key == "small-percent") small_percent = parse_number<uint32_t>(key, value);
+    else if(key == "medium-percent") medium_percent = parse_number<uint32_t>(key, value);
+    else if(key == "small-sizes") small_sizes = parse_size_range(key, value);
+    else if(key == "medium-sizes") medium_sizes = parse_size_range(key, value);
+    else if(key == "large-sizes") large_sizes = parse_size_range(key, value);
+    else if(key == "lifetime"){
+        if(value == "scoped") lifetime = lifetime_model::scoped;
+        else if(value == "region") lifetime = lifetime_model::region;
+        else if(value == "exponential") lifetime = lifetime_model::exponential;
+        else if(value == "generational") lifetime = lifetime_model::generational;
+        else if(value == "lru-cache") lifetime = lifetime_model::lru_cache;
+        else if(value == "phased") lifetime = lifetime_model::phased;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected scoped, region, exponential, generational, lru-cache or phased", value, key));
+    }
+    else if(key == "lifetime-mean") lifetime_mean = parse_number<uint64_t>(key, value);
+    else if(key == "young-percent") young_percent = parse_number<uint32_t>(key, value);
+    else if(key == "young-mean") young_mean = parse_number<uint64_t>(key, value);
+    else if(key == "old-mean") old_mean = parse_number<uint64_t>(key, value);
+    else if(key == "cache-capacity") cache_capacity = parse_number<size_t>(key, value);
+    else if(key == "cache-insert-percent") cache_insert_percent = parse_number<uint32_t>(key, value);
+    else if(key == "cache-hit-percent") cache_hit_percent = parse_number<uint32_t>(key, value);
+    else if(key == "phase-length") phase_length = parse_number<uint64_t>(key, value);
+    else if(key == "size-histogram"){
+        size_histogram_path = value;
+        size_histogram = indexed_stack<size_bucket>();
+        if(!size_histogram_path.empty()) load_size_histogram(size_histogram_path);
+    }
+    else if(key == "heap-mb") heap_mb = parse_number<uint64_t>(key, value);
+    else if(key == "scalability"){
+        if(value == "true" || value == "1") scalability = true;
+        else if(value == "false" || value == "0") scalability = false;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected true or false", value, key));
+    }
+    else if(key == "sweep-gc-threads") sweep_gc_threads = value.empty() ? indexed_stack<size_t>() : parse_number_list<size_t>(key, value);
+    else if(key == "sweep-heap-mb") sweep_heap_mb = value.empty() ? indexed_stack<uint64_t>() : parse_number_list<uint64_t>(key, value);
+    else if(key == "trials") trials = parse_number<size_t>(key, value);
+    else if(key == "scalability-csv") scalability_csv = value;
+    else if(key == "results-json") results_json = value;
+    else if(key == "request-rates") request_rates = value.empty() ? indexed_stack<uint64_t>() : parse_number_list<uint64_t>(key, value);
+    else if(key == "request-duration-ms") request_duration_ms = parse_number<uint64_t>(key, value);
+    else if(key == "request-objects") request_objects = parse_number<size_t>(key, value);
+    else if(key == "service-time-us") service_time_us = parse_number<uint64_t>(key, value);
+    else if(key == "duration-ms") duration_ms = parse_number<uint64_t>(key, value);
+    else if(key == "sampling-interval") sampling_interval = parse_number<uint64_t>(key, value);
+    else if(key == "census"){
+        if(value == "true" || value == "1") census = true;
+        else if(value == "false" || value == "0") census = false;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected true or false", value, key));
+    }
+    else if(key == "init-payload"){
+        if(value == "true" || value == "1") init_payload = true;
+        else if(value == "false" || value == "0") init_payload = false;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected true or false", value, key));
+    }
+    else if(key == "touch-intensity") touch_intensity = parse_number<size_t>(key, value);
+    else if(key == "record") record_path = value;
+    else if(key == "replay") replay_path = value;
+    else if(key == "replay-timing"){
+        if(value == "recorded") timing = replay_timing::recorded;
+        else if(value == "fast") timing = replay_timing::fast;
+        else throw std::invalid_argument(std::format("Invalid value '{}' for {}, expected recorded or fast", value, key));
+    }
+    else {
+        throw std::invalid_argument(std::format("Unknown parameter '{}'", key));
+    }
+}
+
+void workload_config::load_file(const std::string& path){
+    std::ifstream file(path);
+    if(!file){
+        throw std::invalid_argument(std::format("Failed to open config file {}", path));
+    }
+
+    std::string line;
+    for(size_t line_number = 1; std::getline(file, line); ++line_number){
+        const std::string_view entry = trim(line);
+        if(entry.empty() || entry.front() == '#') continue;
+        if(entry.size() > MAX_CONFIG_LINE_LENGTH){
+            throw std::invalid_argument(std::format("{}:{}: line is too long", path, line_number));
+        }
+
+        const size_t equals = entry.find('=');
+        if(equals == std::string_view::npos){
+            throw std::invalid_argument(std::format("{}:{}: expected key=value", path, line_number));
+        }
+        try {
+            set(trim(entry.substr(0, equals)), trim(entry.substr(equals + 1)));
+        }
+        catch(const std::invalid_argument& e){
+            throw std::invalid_argument(std::format("{}:{}: {}", path, line_number, e.what()));
+        }
+    }
+}
+
+void workload_config::load_size_histogram(const std::string& path){
+    std::ifstream file(path);
+    if(!file){
+        throw std::invalid_argument(std::format("Failed to open size histogram {}", path));
+    }
+
+    indexed_stack<size_bucket> buckets;
+    uint64_t total_weight = 0;
+    std::string line;
+    for(size_t line_number = 1; std::getline(file, line); ++line_number){
+        const std::string_view entry = trim(line);
+        if(entry.empty() || entry.front() == '#') continue;
+
+        const size_t separator = entry.find_first_of(" \t");
+        if(separator == std::string_view::npos){
+            throw std::invalid_argument(std::format("{}:{}: expected size weight or min-max weight", path, line_number));
+        }
+        const std::string_view sizes = entry.substr(0, separator);
+        const std::string_view weight = trim(entry.substr(separator + 1));
+
+        try {
+            const size_range range = sizes.find('-') == std::string_view::npos 
+                ? size_range{parse_number<uint32_t>("size", sizes), parse_number<uint32_t>("size", sizes)} 
+                : parse_size_range("size", sizes);
+            if(range.min == 0 || range.min > range.max || range.max > LARGE_OBJECT_THRESHOLD){
+                throw std::invalid_argument(std::format("sizes must be within 1-{}", LARGE_OBJECT_THRESHOLD));
+            }
+
+            total_weight += parse_number<uint64_t>("weight", weight);
+            buckets.push(size_bucket{.min = range.min, .max = range.max, .cumulative_weight = total_weight});
+        }
+        catch(const std::invalid_argument& e){
+            throw std::invalid_argument(std::format("{}:{}: {}", path, line_number, e.what()));
+        }
+    }
+
+    if(total_weight == 0){
+        throw std::invalid_argument(std::format("{}: size histogram has no weight", path));
+    }
+    size_histogram = std::move(buckets);
+}
+
+uint32_t workload_config::generate_size(std::mt19937& rng) const {
+    using size_param = std::uniform_int_distribution<uint32_t>::param_type;
+    std::uniform_int_distribution<uint32_t> size_dist;
+    if(!size_histogram.empty()){
+        const uint64_t total_weight = size_histogram[size_histogram.get_size() - 1].cumulative_weight;
+        const uint64_t weight = std::uniform_int_distribution<uint64_t>(1, total_weight)(rng);
+        const size_bucket* bucket = std::lower_bound(size_histogram.begin(), size_histogram.end(), weight, [](const size_bucket& bucket, uint64_t weight) -> bool {
+            return bucket.cumulative_weight < weight;
+        });
+        return size_dist(rng, size_param(bucket->min, bucket->max));
+    }
+
+    const uint32_t category = std::uniform_int_distribution<uint32_t>(0, 99)(rng);
+    if(category < small_percent){
+        return size_dist(rng, size_param(small_sizes.min, small_sizes.max));
+    }
+    else if(category < small_percent + medium_percent){
+        return size_dist(rng, size_param(medium_sizes.min, medium_sizes.max));
+    }
+    return size_dist(rng, size_param(large_sizes.min, large_sizes.max));
+}
+
+void workload_config::validate() const {
+    auto require = [](bool condition, std::string_view message) -> void {
+        if(!condition) throw std::invalid_argument(std::string(message));
+    };
+
+    require(hm_threads > 0, "hm-threads must be at least 1");
+    require(gc_threads > 0, "gc-threads must be at least 1");
+    require(!mutator_threads.empty(), "mutator-threads must list at least one thread count");
+    for(size_t thread_count : mutator_threads){
+        require(thread_count > 0, "mutator-threads must be at least 1");
+    }
+    require(tls_roots + global_roots + register_roots > 0, "at least one root is required");
+    require(tls_map_capacity > 0, "tls-map-capacity must be at least 1");
+    require(scope_depth > 0, "scope-depth must be at least 1");
+    require(record_path.empty() || replay_path.empty(), "record and replay can't be used together");
+    auto valid_heap_mb = [](uint64_t mb) -> bool {
+        return mb == 0 || (mb * 1024 * 1024 >= uint64_t{MIN_SEGMENT_HEAP_LIMIT} * TOTAL_SEGMENTS && mb * 1024 * 1024 <= HEAP_CAPACITY);
+    };
+    const std::string heap_mb_range = std::format("must be 0 or within {}-{}", uint64_t{MIN_SEGMENT_HEAP_LIMIT} * TOTAL_SEGMENTS >> 20, HEAP_CAPACITY >> 20);
+    require(valid_heap_mb(heap_mb), std::format("heap-mb {}", heap_mb_range));
+    for(uint64_t mb : sweep_heap_mb){
+        require(valid_heap_mb(mb), std::format("sweep-heap-mb {}", heap_mb_range));
+    }
+    for(size_t thread_count : sweep_gc_threads){
+        require(thread_count > 0, "sweep-gc-threads must be at least 1");
+    }
+    require(trials > 0, "trials must be at least 1");
+    require(backend == allocation_backend::gc || (request_rates.empty() && replay_path.empty() && record_path.empty() && !scalability),
+        "backend malloc and both can't be used with request-rates, record, replay or scalability"
+    );
+    require(!scalability || (request_rates.empty() && replay_path.empty() && record_path.empty()), "scalability can't be used with request-rates, record or replay");
+
+    for(uint64_t rate : request_rates){
+        require(rate > 0, "request-rates must be at least 1");
+    }
+    require(request_rates.empty() || replay_path.empty(), "request-rates and replay can't be used together");
+    require(request_rates.empty() || request_objects > 0, "request-objects must be at least 1");
+    require(small_percent + medium_percent <= 100, "small-percent + medium-percent must not exceed 100");
+    require(small_sizes.min > 0 && small_sizes.min <= small_sizes.max && small_sizes.max <= SMALL_OBJECT_THRESHOLD,
+        std::format("small-sizes must be within 1-{}", SMALL_OBJECT_THRESHOLD));
+    require(medium_sizes.min > SMALL_OBJECT_THRESHOLD && medium_sizes.min <= medium_sizes.max && medium_sizes.max <= MEDIUM_OBJECT_THRESHOLD,
+        std::format("medium-sizes must be within {}-{}", SMALL_OBJECT_THRESHOLD + 1, MEDIUM_OBJECT_THRESHOLD));
+    require(large_sizes.min > MEDIUM_OBJECT_THRESHOLD && large_sizes.min <= large_sizes.max && large_sizes.max <= LARGE_OBJECT_THRESHOLD,
+        std::format("large-sizes must be within {}-{}", MEDIUM_OBJECT_THRESHOLD + 1, LARGE_OBJECT_THRESHOLD));
+    require(young_percent <= 100, "young-percent must not exceed 100");
+    require(cache_insert_percent <= 100, "cache-insert-percent must not exceed 100");
+    require(cache_hit_percent <= 100, "cache-hit-percent must not exceed 100");
+    require(lifetime != lifetime_model::lru_cache || cache_capacity > 0, "cache-capacity must be at least 1");
+    require(phase_length > 0, "phase-length must be at least 1");
+}
+
+std::string workload_config::describe() const {
+    std::string description;
+    description += std::format("mode={}\n", simulation_mode_name(mode));
+    description += std::format("hm-threads={}\ngc-threads={}\nmutator-threads={}\npolicy={}\nbackend={}\n",
+        hm_threads, gc_threads, format_number_list(mutator_threads), allocation_policy_name(policy), allocation_backend_name(backend)
+    );
+    description += std::format("tls-roots={}\nglobal-roots={}\nregister-roots={}\n", tls_roots, global_roots, register_roots);
+    description += std::format("tls-scopes={}\ntls-allocs-per-scope={}\ntls-map-capacity={}\nscope-depth={}\n",
+        tls_scopes, tls_allocs_per_scope, tls_map_capacity, scope_depth
+    );
+    description += std::format("global-allocs={}\nregister-allocs={}\n", global_allocs, register_allocs);
+    description += std::format("small-percent={}\nmedium-percent={}\n", small_percent, medium_percent);
+    description += std::format("small-sizes={}-{}\nmedium-sizes={}-{}\nlarge-sizes={}-{}\n",
+        small_sizes.min, small_sizes.max, medium_sizes.min, medium_sizes.max, large_sizes.min, large_sizes.max
+    );
+    description += std::format("lifetime={}\nduration-ms={}\nsampling-interval={}\ncensus={}\n",
+        lifetime_model_name(lifetime), duration_ms, sampling_interval, census
+    );
+    description += std::format("lifetime-mean={}\nyoung-percent={}\nyoung-mean={}\nold-mean={}\n", lifetime_mean, young_percent, young_mean, old_mean);
+    description += std::format("cache-capacity={}\ncache-insert-percent={}\ncache-hit-percent={}\nphase-length={}\n",
+        cache_capacity, cache_insert_percent, cache_hit_percent, phase_length
+    );
+    if(!size_histogram_path.empty()) description += std::format("size-histogram={}\n", size_histogram_path);
+    if(!record_path.empty()) description += std::format("record={}\n", record_path);
+    description += std::format("heap-mb={}\n", heap_mb);
+    if(!results_json.empty()) description += std::format("results-json={}\n", results_json);
+    if(scalability){
+        description += std::format("scalability=true\nsweep-gc-threads={}\nsweep-heap-mb={}\nscalability-csv={}\n",
+            format_number_list(sweep_gc_threads), format_number_list(sweep_heap_mb), scalability_csv
+        );
+    }
+    if(scalability || !results_json.empty()) description += std::format("trials={}\n", trials);
+    description += std::format("init-payload={}\ntouch-intensity={}\n", init_payload, touch_intensity);
+    if(!request_rates.empty()){
+        description += std::format("request-rates={}\nrequest-duration-ms={}\nrequest-objects={}\nservice-time-us={}\n",
+            format_number_list(request_rates), request_duration_ms, request_objects, service_time_us
+        );
+    }
+    if(!replay_path.empty()) description += std::format("replay={}\nreplay-timing={}\n", replay_path, trace_replayer::replay_timing_name(timing));
+    return description;
+}
+
+workload_config workload_config::parse(int argc, char** argv){
+    workload_config config;
+    auto split_flag = [](std::string_view arg) -> std::pair<std::string_view, std::string_view> {
+        const size_t equals = arg.find('=');
+        return equals == std::string_view::npos ? std::pair{arg.substr(2), std::string_view{}} : std::pair{arg.substr(2, equals - 2), arg.substr(equals + 1)};
+    };
+
+    // config file is applied first, so flags override it regardless of their position
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg == "--config" && i + 1 < argc){
+            config.load_file(argv[++i]);
+        }
+        else if(arg.starts_with("--config=")){
+            config.load_file(std::string(split_flag(arg).second));
+        }
+    }
+
+    for(int i = 1; i < argc; ++i){
+        const std::string_view arg = argv[i];
+        if(arg == "--help" || arg == "-h"){
+            config.help = true;
+            return config;
+        }
+        if(!arg.starts_with("--")){
+            throw std::invalid_argument(std::format("Unexpected argument '{}'", arg));
+        }
+
+        auto [key, value] = split_flag(arg);
+        if(arg.find('=') == std::string_view::npos){
+            if(i + 1 >= argc){
+                throw std::invalid_argument(std::format("Missing value for {}", key));
+            }
+            value = argv[++i];
+        }
+        if(key == "config") continue;
+        config.set(key, value);
+    }
+
+    config.validate();
+    return config;
+}
+
+std::string workload_config::usage(std::string_view program){
+    std::string text = std::format("Usage: {} [--config FILE] [--KEY VALUE | --KEY=VALUE]...\n", program);
+    text += "Keys, also accepted as key=value lines of the config file (# starts a comment):\n";
+    text += "  mode                  stress | relaxed, resets the allocation counts to the preset (default stress)\n";
+    text += std::format("  hm-threads            heap manager threads (default {})\n", DEFAULT_HM_THREADS);
+    text += std::format("  gc-threads            gc threads (default {})\n", DEFAULT_GC_THREADS);
+    text += "  mutator-threads       comma separated allocator thread counts, one run each (default 1,2,5,10)\n";
+    text += "  policy                round-robin | fullest-first | thread-affinity (default round-robin)\n";
+    text += "  backend               gc | malloc | both, allocator the simulation runs against, malloc frees dropped objects (default gc)\n";
+    text += std::format("  tls-roots             thread local stacks (default {})\n", DEFAULT_ROOT_COUNT);
+    text += std::format("  global-roots          global roots (default {})\n", DEFAULT_ROOT_COUNT);
+    text += std::format("  register-roots        register roots (default {})\n", DEFAULT_ROOT_COUNT);
+    text += "  tls-scopes            top-level scopes per tls\n";
+    text += "  tls-allocs-per-scope  allocations per top-level scope, split between its nested scopes\n";
+    text += "  tls-map-capacity      initial capacity of the tls variable map\n";
+    text += "  scope-depth           nested scopes per top-level scope, including itself (default 1)\n";
+    text += "  global-allocs         allocations per global root\n";
+    text += "  register-allocs       allocations per register root\n";
+    text += std::format("  small-percent         percent of small objects (default {})\n", DEFAULT_SMALL_PERCENT);
+    text += std::format("  medium-percent        percent of medium objects, the rest are large (default {})\n", DEFAULT_MEDIUM_PERCENT);
+    text += std::format("  small-sizes           min-max small object size (default 1-{})\n", SMALL_OBJECT_THRESHOLD);
+    text += std::format("  medium-sizes          min-max medium object size (default {}-{})\n", SMALL_OBJECT_THRESHOLD + 1, MEDIUM_OBJECT_THRESHOLD);
+    text += std::format("  large-sizes           min-max large object size (default {}-{})\n", MEDIUM_OBJECT_THRESHOLD + 1, LARGE_OBJECT_THRESHOLD);
+    text += "  lifetime              scoped | region | exponential | generational | lru-cache | phased (default scoped)\n";
+    text += std::format("  lifetime-mean         mean object lifetime of exponential, in allocations of the thread (default {})\n", DEFAULT_LIFETIME_MEAN);
+    text += std::format("  young-percent         percent of young objects of generational (default {})\n", DEFAULT_YOUNG_PERCENT);
+    text += std::format("  young-mean            mean lifetime of young objects, in allocations (default {})\n", DEFAULT_YOUNG_MEAN);
+    text += std::format("  old-mean              mean lifetime of old objects, in allocations (default {})\n", DEFAULT_OLD_MEAN);
+    text += std::format("  cache-capacity        cache entries per tls of lru-cache (default {})\n", DEFAULT_CACHE_CAPACITY);
+    text += std::format("  cache-insert-percent  percent of objects inserted into the cache (default {})\n", DEFAULT_CACHE_INSERT_PERCENT);
+    text += std::format("  cache-hit-percent     percent of allocations followed by a cache access (default {})\n", DEFAULT_CACHE_HIT_PERCENT);
+    text += std::format("  phase-length          allocations per phase of phased, phases alternate young and old (default {})\n", DEFAULT_PHASE_LENGTH);
+    text += "  size-histogram        file of \"size weight\" or \"min-max weight\" lines, replaces the size categories\n";
+    text += "  duration-ms           minimum run duration, roots repeat their allocations until it passes (default 0, run once)\n";
+    text += std::format("  sampling-interval     bytes between sampled allocations, e.g. {}, 0 disables sampling (default 0)\n", DEFAULT_SAMPLING_INTERVAL);
+    text += "  census                true | false, live-object census during sweep (default false)\n";
+    text += std::format("  heap-mb               usable heap size in MB, {}-{}, 0 uses the whole heap (default 0)\n", uint64_t{MIN_SEGMENT_HEAP_LIMIT} * TOTAL_SEGMENTS >> 20, HEAP_CAPACITY >> 20);
+    text += "  scalability           true | false, sweep mutator-threads x sweep-gc-threads x sweep-heap-mb instead of the simulation (default false)\n";
+    text += "  sweep-gc-threads      comma separated gc thread counts of the sweep (default gc-threads)\n";
+    text += "  sweep-heap-mb         comma separated heap sizes in MB of the sweep (default heap-mb)\n";
+    text += std::format("  trials                runs of each simulation recorded to results-json and of each combination of the sweep (default {})\n", DEFAULT_TRIALS);
+    text += std::format("  scalability-csv       file the results of the sweep are written to (default {})\n", DEFAULT_SCALABILITY_CSV_PATH);
+    text += "  results-json          file config, environment, git revision and metrics are written to as JSON (default none)\n";
+    text += "  init-payload          true | false, write the payload of every allocated object (default false)\n";
+    text += "  touch-intensity       live objects of the root read and updated after each allocation (default 0)\n";
+    text += "  request-rates         comma separated offered loads in requests/s, runs the open-loop request mode instead of the simulation\n";
+    text += std::format("  request-duration-ms   duration of the arrivals of each offered load (default {})\n", DEFAULT_REQUEST_DURATION_MS);
+    text += std::format("  request-objects       objects allocated into the scope of a request (default {})\n", DEFAULT_REQUEST_OBJECTS);
+    text += std::format("  service-time-us       time a request holds its objects before its scope is popped (default {})\n", DEFAULT_SERVICE_TIME_US);
+    text += "  record                file the allocation trace of the simulation is recorded to\n";
+    text += "  replay                allocation trace replayed instead of the simulation, thread and heap keys still apply\n";
+    text += "  replay-timing         recorded | fast, spacing of the replayed events (default recorded)\n";
+    return text;
+}
\ No newline at end of file
@@ -0,0 +1,525 @@
+#ifndef WORKLOAD_CONFIG_HPP
+#define WORKLOAD_CONFIG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <charconv>
+#include <format>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "../heap-manager/heap-manager.hpp"
+#include "../trace-replayer/trace-replayer.hpp"
+#include "../common/indexed-stack/indexed-stack.hpp"
+
+/// number of allocations per tls in stress mode.
+size_t constexpr TLS_ALLOC_STRESS_THRESHOLD = 65536;
+
+/// number of scopes per tls for stress mode.
+size_t constexpr TLS_SCOPE_COUNT_STRESS = 8;
+
+/// number of allocations per scope for tls in stress mode.
+size_t constexpr TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE = TLS_ALLOC_STRESS_THRESHOLD / TLS_SCOPE_COUNT_STRESS;
+
+/// capacity of the hash-map that maps tls variable to its index in stress mode.
+size_t constexpr TLS_MAP_CAPACITY_STRESS = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE << 1;
+
+/// number of allocations per tls in relaxed mode.
+size_t constexpr TLS_ALLOC_RELAXED_THRESHOLD = 1024;
+
+/// number of scopes per tls in relaxed mode.
+size_t constexpr TLS_SCOPE_COUNT_RELAXED = 8;
+
+/// number of allocations per scope for tls in relaxed mode.
+size_t constexpr TLS_ALLOC_RELAXED_THRESHOLD_PER_SCOPE = TLS_ALLOC_RELAXED_THRESHOLD / TLS_SCOPE_COUNT_RELAXED;
+
+/// capacity of the hash-map that maps tls variable to its index in relaxed mode.
+size_t constexpr TLS_MAP_CAPACITY_RELAXED = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE << 1;
+
+/// number of allocations per global in stress mode.
+size_t constexpr GLOBAL_ALLOC_STRESS_THRESHOLD = 128;
+
+/// number of allocations per global in relaxed mode.
+size_t constexpr GLOBAL_ALLOC_RELAXED_THRESHOLD = 32;
+
+/// number of allocations per register in stress mode.
+size_t constexpr REGISTER_ALLOC_STRESS_THRESHOLD = 128;
+
+/// number of allocations per register in relaxed mode.
+size_t constexpr REGISTER_ALLOC_RELAXED_THRESHOLD = 32;
+
+/// default number of heap manager threads.
+size_t constexpr DEFAULT_HM_THREADS = 8;
+
+/// default number of gc threads.
+size_t constexpr DEFAULT_GC_THREADS = 8;
+
+/// default numbers of allocator threads, the simulation runs once for each.
+constexpr size_t DEFAULT_MUTATOR_THREADS[] = {1, 2, 5, 10};
+
+/// default number of roots of each kind.
+size_t constexpr DEFAULT_ROOT_COUNT = 5;
+
+/// default percent of small objects.
+uint32_t constexpr DEFAULT_SMALL_PERCENT = 80;
+
+/// default percent of medium objects, the rest of the objects are large.
+uint32_t constexpr DEFAULT_MEDIUM_PERCENT = 19;
+
+/// maximum length of a line of the config file.
+size_t constexpr MAX_CONFIG_LINE_LENGTH = 4096;
+
+/// default mean lifetime of the exponential model, in allocations of the thread.
+uint64_t constexpr DEFAULT_LIFETIME_MEAN = 1000;
+
+/// default percent of young objects of the generational model.
+uint32_t constexpr DEFAULT_YOUNG_PERCENT = 90;
+
+/// default mean lifetime of young objects, in allocations of the thread.
+uint64_t constexpr DEFAULT_YOUNG_MEAN = 100;
+
+/// default mean lifetime of old objects, in allocations of the thread.
+uint64_t constexpr DEFAULT_OLD_MEAN = 100000;
+
+/// default number of cache entries per tls of the lru-cache model.
+size_t constexpr DEFAULT_CACHE_CAPACITY = 4096;
+
+/// default percent of objects inserted into the cache.
+uint32_t constexpr DEFAULT_CACHE_INSERT_PERCENT = 10;
+
+/// default percent of allocations followed by an access to a cached object.
+uint32_t constexpr DEFAULT_CACHE_HIT_PERCENT = 50;
+
+/// default number of allocations of a phase of the phased model.
+uint64_t constexpr DEFAULT_PHASE_LENGTH = 16384;
+
+/// default number of trials of each recorded simulation and of each combination of the scalability sweep.
+size_t constexpr DEFAULT_TRIALS = 5;
+
+/// default file the scalability results are written to.
+constexpr const char* DEFAULT_SCALABILITY_CSV_PATH = "gcsim-scalability.csv";
+
+/// default duration of the arrivals of each offered load of the request mode, in milliseconds.
+uint64_t constexpr DEFAULT_REQUEST_DURATION_MS = 1000;
+
+/// default number of objects allocated by a request.
+size_t constexpr DEFAULT_REQUEST_OBJECTS = 32;
+
+/// default time a request holds its objects, in microseconds.
+uint64_t constexpr DEFAULT_SERVICE_TIME_US = 200;
+
+/**
+ * @enum simulation_mode
+ * @brief defines the preset of the allocation counts.
+*/
+enum class simulation_mode { stress, relaxed };
+
+/**
+ * @enum lifetime_model
+ * @brief defines how long the objects of the tls scopes stay reachable.
+ * @details scoped - objects are referenced by tls variables until their scope is popped.
+ * region - objects are allocated inside of scope regions, freed in bulk when their scope is popped.
+ * exponential - every object lives an exponentially distributed number of allocations.
+ * generational - mix of short-lived young objects and long-lived old objects, both exponentially distributed.
+ * lru_cache - part of the objects enter a fixed-size cache and live until evicted, the rest are young.
+ * phased - phases alternate between young and old object lifetimes.
+*/
+enum class lifetime_model { scoped, region, exponential, generational, lru_cache, phased };
+
+/**
+ * @enum allocation_backend
+ * @brief defines what the simulation allocates from.
+ * @details gc - the garbage-collected heap.
+ * malloc - the system allocator, objects are freed when the simulation drops their last reference;
+ * any allocator preloaded with LD_PRELOAD replaces it.
+ * both - the heap and the system allocator run the same workload one after another and are reported side by side.
+*/
+enum class allocation_backend { gc, malloc, both };
+
+/**
+ * @struct size_range
+ * @brief inclusive range of the object sizes of a size category.
+*/
+struct size_range {
+    /// smallest object size in bytes.
+    uint32_t min;
+
+    /// largest object size in bytes.
+    uint32_t max;
+};
+
+/**
+ * @struct size_bucket
+ * @brief inclusive range of object sizes of the empirical size distribution.
+*/
+struct size_bucket {
+    /// smallest object size in bytes.
+    uint32_t min;
+
+    /// largest object size in bytes.
+    uint32_t max;
+
+    /// sum of the weights of this bucket and the buckets before it.
+    uint64_t cumulative_weight;
+};
+
+/**
+ * @struct workload_config
+ * @brief parameters of the allocation workload, read from command-line flags and a config file.
+ * @details every key can be given as --key=value, --key value, or as a key=value line of the config file.
+ * Keys are applied in the order they appear, config file first, then the flags;
+ * mode resets the allocation counts to its preset, so it should precede them.
+*/
+struct workload_config {
+    /// preset the allocation counts were taken from.
+    simulation_mode mode = simulation_mode::stress;
+
+    /// number of heap manager threads.
+    size_t hm_threads = DEFAULT_HM_THREADS;
+
+    /// number of gc threads.
+    size_t gc_threads = DEFAULT_GC_THREADS;
+
+    /// numbers of allocator threads, the simulation runs once for each.
+    indexed_stack<size_t> mutator_threads;
+
+    /// order in which segments of a category are tried for allocation.
+    allocation_policy policy = allocation_policy::round_robin;
+
+    /// allocator the simulation runs against.
+    allocation_backend backend = allocation_backend::gc;
+
+    /// number of thread local stacks.
+    size_t tls_roots = DEFAULT_ROOT_COUNT;
+
+    /// number of global roots.
+    size_t global_roots = DEFAULT_ROOT_COUNT;
+
+    /// number of register roots.
+    size_t register_roots = DEFAULT_ROOT_COUNT;
+
+    /// number of top-level scopes per tls.
+    size_t tls_scopes = TLS_SCOPE_COUNT_STRESS;
+
+    /// number of allocations per top-level scope, split evenly between its nested scopes.
+    size_t tls_allocs_per_scope = TLS_ALLOC_STRESS_THRESHOLD_PER_SCOPE;
+
+    /// initial capacity of the hash-map that maps tls variable to its index.
+    size_t tls_map_capacity = TLS_MAP_CAPACITY_STRESS;
+
+    /// number of nested scopes pushed by each top-level scope, including itself.
+    size_t scope_depth = 1;
+
+    /// number of allocations per global.
+    size_t global_allocs = GLOBAL_ALLOC_STRESS_THRESHOLD;
+
+    /// number of allocations per register.
+    size_t register_allocs = REGISTER_ALLOC_STRESS_THRESHOLD;
+
+    /// percent of small objects.
+    uint32_t small_percent = DEFAULT_SMALL_PERCENT;
+
+    /// percent of medium objects, the rest of the objects are large.
+    uint32_t medium_percent = DEFAULT_MEDIUM_PERCENT;
+
+    /// sizes of small objects.
+    size_range small_sizes{1, SMALL_OBJECT_THRESHOLD};
+
+    /// sizes of medium objects.
+    size_range medium_sizes{SMALL_OBJECT_THRESHOLD + 1, MEDIUM_OBJECT_THRESHOLD};
+
+    /// sizes of large objects.
+    size_range large_sizes{MEDIUM_OBJECT_THRESHOLD + 1, LARGE_OBJECT_THRESHOLD};
+
+    /// lifetime of the objects of the tls scopes.
+    lifetime_model lifetime = lifetime_model::scoped;
+
+    /// mean lifetime of the exponential model, in allocations of the thread.
+    uint64_t lifetime_mean = DEFAULT_LIFETIME_MEAN;
+
+    /// percent of young objects of the generational model.
+    uint32_t young_percent = DEFAULT_YOUNG_PERCENT;
+
+    /// mean lifetime of young objects, in allocations of the thread.
+    uint64_t young_mean = DEFAULT_YOUNG_MEAN;
+
+    /// mean lifetime of old objects, in allocations of the thread.
+    uint64_t old_mean = DEFAULT_OLD_MEAN;
+
+    /// number of cache entries per tls of the lru-cache model.
+    size_t cache_capacity = DEFAULT_CACHE_CAPACITY;
+
+    /// percent of objects inserted into the cache.
+    uint32_t cache_insert_percent = DEFAULT_CACHE_INSERT_PERCENT;
+
+    /// percent of allocations followed by an access to a cached object.
+    uint32_t cache_hit_percent = DEFAULT_CACHE_HIT_PERCENT;
+
+    /// number of allocations of a phase of the phased model.
+    uint64_t phase_length = DEFAULT_PHASE_LENGTH;
+
+    /// histogram file the object sizes are sampled from, empty if size categories are used.
+    std::string size_histogram_path;
+
+    /// buckets of the size histogram, ordered as in the file; replace the size categories when not empty.
+    indexed_stack<size_bucket> size_histogram;
+
+    /// minimum duration of a simulation in milliseconds, roots repeat their allocations until it passes; 0 runs them once.
+    uint64_t duration_ms = 0;
+
+    /// average number of allocated bytes between two sampled allocations, 0 disables sampling.
+    uint64_t sampling_interval = 0;
+
+    /// whether gc takes the live-object census, off by default since it adds work per live object to every gc cycle.
+    bool census = false;
+
+    /// whether the payload of every allocated object is written once it's referenced.
+    bool init_payload = false;
+
+    /// number of live objects of the root read and updated after each allocation, 0 disables touching.
+    size_t touch_intensity = 0;
+
+    /// usable heap size in MB, 0 uses the whole heap.
+    uint64_t heap_mb = 0;
+
+    /// whether the scalability sweep runs instead of the simulation.
+    bool scalability = false;
+
+    /// gc thread counts of the scalability sweep, empty uses gc-threads.
+    indexed_stack<size_t> sweep_gc_threads;
+
+    /// heap sizes of the scalability sweep in MB, empty uses heap-mb.
+    indexed_stack<uint64_t> sweep_heap_mb;
+
+    /// number of trials of each simulation recorded to results-json and of each combination of the sweep.
+    size_t trials = DEFAULT_TRIALS;
+
+    /// file the results of the sweep are written to as CSV.
+    std::string scalability_csv = DEFAULT_SCALABILITY_CSV_PATH;
+
+    /// file the machine-readable results are written to, empty disables them.
+    std::string results_json;
+
+    /// offered loads of the open-loop request mode in requests per second, one run each; empty runs the closed-loop simulation.
+    indexed_stack<uint64_t> request_rates;
+
+    /// duration of the arrivals of each offered load, in milliseconds.
+    uint64_t request_duration_ms = DEFAULT_REQUEST_DURATION_MS;
+
+    /// number of objects allocated by a request.
+    size_t request_objects = DEFAULT_REQUEST_OBJECTS;
+
+    /// time a request holds its objects before popping its scope, in microseconds.
+    uint64_t service_time_us = DEFAULT_SERVICE_TIME_US;
+
+    /// file the allocation trace of the simulation is recorded to, empty if not recorded.
+    std::string record_path;
+
+    /// allocation trace that is replayed instead of the simulation, empty if simulation runs.
+    std::string replay_path;
+
+    /// spacing of the replayed events.
+    replay_timing timing = replay_timing::recorded;
+
+    /// whether usage was requested instead of a run.
+    bool help = false;
+
+    /**
+     * @brief creates the default configuration, stress preset with the default thread counts.
+    */
+    workload_config();
+
+    /**
+     * @brief sets the allocation counts to the preset of the mode.
+     * @param preset - mode whose allocation counts are used.
+    */
+    void apply_preset(simulation_mode preset) noexcept;
+
+    /**
+     * @brief sets the parameter of the key.
+     * @param key - name of the parameter, without leading dashes.
+     * @param value - textual value of the parameter.
+     * @throws std::invalid_argument if key is unknown or value can't be parsed.
+    */
+    void set(std::string_view key, std::string_view value);
+
+    /**
+     * @brief applies the key=value lines of the config file, empty lines and lines starting with # are skipped.
+     * @param path - path of the config file.
+     * @throws std::invalid_argument if file can't be opened or one of its lines is invalid.
+    */
+    void load_file(const std::string& path);
+
+    /**
+     * @brief reads the empirical size distribution, one "size weight" or "min-max weight" line per bucket.
+     * @param path - path of the histogram file, empty lines and lines starting with # are skipped.
+     * @throws std::invalid_argument if file can't be opened, a line is invalid or all weights are 0.
+    */
+    void load_size_histogram(const std::string& path);
+
+    /**
+     * @brief draws an object size from the size histogram, or from the size categories if there is none.
+     * @param rng - reference to the random number generator.
+     * @returns amount of bytes object needs for allocation.
+    */
+    uint32_t generate_size(std::mt19937& rng) const;
+
+    /**
+     * @brief checks that the parameters describe a runnable workload.
+     * @throws std::invalid_argument naming the first invalid parameter.
+    */
+    void validate() const;
+
+    /**
+     * @brief formats the parameters as key=value lines, accepted back by load_file.
+     * @returns resolved configuration.
+    */
+    std::string describe() const;
+
+    /**
+     * @brief creates the configuration from the command-line arguments.
+     * @param argc - number of arguments.
+     * @param argv - arguments, argv[0] is skipped.
+     * @returns validated configuration.
+     * @throws std::invalid_argument if an argument is invalid.
+    */
+    static workload_config parse(int argc, char** argv);
+
+    /**
+     * @brief getter for the description of the flags.
+     * @param program - name of the executable.
+     * @returns usage text.
+    */
+    static std::string usage(std::string_view program);
+
+    /**
+     * @brief parses the unsigned number.
+     * @tparam T - unsigned integer type of the number.
+     * @param key - name of the parameter, used in the error message.
+     * @param value - textual value of the number.
+     * @returns parsed number.
+     * @throws std::invalid_argument if value isn't a number of type T.
+    */
+    template <typename T>
+    static T parse_number(std::string_view key, std::string_view value){
+        T number{};
+        const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if(error != std::errc{} || end != value.data() + value.size()){
+            throw std::invalid_argument(std::format("Invalid value '{}' for {}", value, key));
+        }
+        return number;
+    }
+
+    /**
+     * @brief parses the comma separated list of unsigned numbers.
+     * @tparam T - unsigned integer type of the numbers.
+     * @param key - name of the parameter, used in the error message.
+     * @param value - textual value of the list.
+     * @returns parsed numbers, in the order they are listed.
+     * @throws std::invalid_argument if an element isn't a number of type T.
+    */
+    template <typename T>
+    static indexed_stack<T> parse_number_list(std::string_view key, std::string_view value){
+        indexed_stack<T> numbers;
+        for(size_t start = 0; start <= value.size();){
+            size_t end = value.find(',', start);
+            if(end == std::string_view::npos) end = value.size();
+            numbers.push(parse_number<T>(key, trim(value.substr(start, end - start))));
+            start = end + 1;
+        }
+        return numbers;
+    }
+
+    /**
+     * @brief formats the numbers as a comma separated list.
+     * @tparam T - type of the numbers.
+     * @param numbers - const reference to the numbers.
+     * @returns list accepted back by parse_number_list.
+    */
+    template <typename T>
+    static std::string format_number_list(const indexed_stack<T>& numbers){
+        std::string list;
+        for(size_t i = 0; i < numbers.get_size(); ++i){
+            list += std::format("{}{}", i == 0 ? "" : ",", numbers[i]);
+        }
+        return list;
+    }
+
+    /**
+     * @brief parses the inclusive size range written as min-max.
+     * @param key - name of the parameter, used in the error message.
+     * @param value - textual value of the range.
+     * @returns parsed range.
+     * @throws std::invalid_argument if value isn't a range.
+    */
+    static size_range parse_size_range(std::string_view key, std::string_view value);
+
+    /**
+     * @brief removes the leading and trailing whitespace.
+     * @param text - text that is trimmed.
+     * @returns trimmed view of the text.
+    */
+    static std::string_view trim(std::string_view text) noexcept;
+
+    /**
+     * @brief getter for the name of the simulation mode.
+     * @param mode - simulation mode.
+     * @returns name of the mode.
+    */
+    static constexpr const char* simulation_mode_name(simulation_mode mode) noexcept {
+        switch(mode){
+            case simulation_mode::stress: return "stress";
+            case simulation_mode::relaxed: return "relaxed";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief getter for the name of the lifetime model.
+     * @param lifetime - lifetime model.
+     * @returns name of the model.
+    */
+    static constexpr const char* lifetime_model_name(lifetime_model lifetime) noexcept {
+        switch(lifetime){
+            case lifetime_model::scoped: return "scoped";
+            case lifetime_model::region: return "region";
+            case lifetime_model::exponential: return "exponential";
+            case lifetime_model::generational: return "generational";
+            case lifetime_model::lru_cache: return "lru-cache";
+            case lifetime_model::phased: return "phased";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief getter for the name of the allocation policy.
+     * @param policy - allocation policy.
+     * @returns name of the policy.
+    */
+    static constexpr const char* allocation_policy_name(allocation_policy policy) noexcept {
+        switch(policy){
+            case allocation_policy::round_robin: return "round-robin";
+            case allocation_policy::fullest_first: return "fullest-first";
+            case allocation_policy::thread_affinity: return "thread-affinity";
+        }
+        return "unknown";
+    }
+
+    /**
+     * @brief getter for the name of the allocation backend.
+     * @param backend - allocation backend.
+     * @returns name of the backend.
+    */
+    static constexpr const char* allocation_backend_name(allocation_backend backend) noexcept {
+        switch(backend){
+            case allocation_backend::gc: return "gc";
+            case allocation_backend::malloc: return "malloc";
+            case allocation_backend::both: return "both";
+        }
+        return "unknown";
+    }
+};
+
+#endif
\ No newline at end of file
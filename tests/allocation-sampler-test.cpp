@@ -0,0 +1,85 @@
+#include "tests.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <latch>
+#include <memory>
+#include <thread>
+
+#include "../src/heap-manager/heap-manager.hpp"
+
+/// number of threads that allocate on the heap, each registers its own mutator context.
+constexpr size_t SAMPLER_TEST_THREADS = MAX_MUTATOR_THREADS;
+
+/// sampling interval of the test, every thread allocates about two intervals.
+constexpr uint64_t SAMPLER_TEST_INTERVAL = 32 * 1024;
+
+/// size of the allocated objects.
+constexpr uint32_t SAMPLER_TEST_OBJECT_SIZE = 64;
+
+/// number of allocations of each thread.
+constexpr size_t SAMPLER_TEST_ALLOCS = 2 * SAMPLER_TEST_INTERVAL / SAMPLER_TEST_OBJECT_SIZE;
+
+/// sampling interval of the region test, small enough for a single thread to take a few hundred samples.
+constexpr uint64_t SAMPLER_TEST_REGION_INTERVAL = 1024;
+
+/// number of region allocations, spread over several region chunks.
+constexpr size_t SAMPLER_TEST_REGION_ALLOCS = 256 * SAMPLER_TEST_REGION_INTERVAL / SAMPLER_TEST_OBJECT_SIZE;
+
+/// allowed relative error of the estimate, about 4 standard deviations of the expected number of samples.
+constexpr double SAMPLER_TEST_TOLERANCE = 0.35;
+
+void allocation_sampler_test::estimated_bytes_match_allocated_bytes(){
+    heap_manager heap_mng(1);
+    heap_mng.set_sampling_interval(SAMPLER_TEST_INTERVAL);
+
+    std::latch start_latch(SAMPLER_TEST_THREADS);
+    std::unique_ptr<std::jthread[]> threads = std::make_unique<std::jthread[]>(SAMPLER_TEST_THREADS);
+    for(size_t t = 0; t < SAMPLER_TEST_THREADS; ++t){
+        threads[t] = std::jthread([&] -> void {
+            start_latch.arrive_and_wait();
+            for(size_t i = 0; i < SAMPLER_TEST_ALLOCS; ++i){
+                heap_mng.allocate(SAMPLER_TEST_OBJECT_SIZE);
+            }
+        });
+    }
+    for(size_t t = 0; t < SAMPLER_TEST_THREADS; ++t){
+        threads[t].join();
+    }
+
+    double estimated_bytes = 0;
+    for(const allocation_site_stats& stats : heap_mng.get_allocation_sites()){
+        estimated_bytes += stats.estimated_bytes;
+    }
+    const double allocated_bytes = static_cast<double>(SAMPLER_TEST_THREADS * SAMPLER_TEST_ALLOCS * SAMPLER_TEST_OBJECT_SIZE);
+    const double error = std::abs(estimated_bytes - allocated_bytes) / allocated_bytes;
+    test_runner::check(error <= SAMPLER_TEST_TOLERANCE, std::format("estimated {:.0f} bytes, allocated {:.0f} bytes", estimated_bytes, allocated_bytes));
+}
+
+void allocation_sampler_test::region_allocations_are_sampled(){
+    heap_manager heap_mng(1);
+    heap_mng.set_sampling_interval(SAMPLER_TEST_REGION_INTERVAL);
+    heap_mng.add_root("tls", std::make_unique<thread_local_stack>());
+    thread_local_stack& tls = *static_cast<thread_local_stack*>(heap_mng.get_root("tls"));
+
+    tls.push_region_scope();
+    for(size_t i = 0; i < SAMPLER_TEST_REGION_ALLOCS; ++i){
+        header* obj = heap_mng.allocate_in_scope(tls, SAMPLER_TEST_OBJECT_SIZE);
+        test_runner::check(obj != nullptr && obj->is_region(), "object wasn't allocated in the region");
+    }
+    heap_mng.pop_region_scope(tls);
+
+    double estimated_bytes = 0;
+    for(const allocation_site_stats& stats : heap_mng.get_allocation_sites()){
+        estimated_bytes += stats.estimated_bytes;
+    }
+    const double allocated_bytes = static_cast<double>(SAMPLER_TEST_REGION_ALLOCS * SAMPLER_TEST_OBJECT_SIZE);
+    const double error = std::abs(estimated_bytes - allocated_bytes) / allocated_bytes;
+    test_runner::check(error <= SAMPLER_TEST_TOLERANCE, std::format("estimated {:.0f} bytes, allocated {:.0f} bytes", estimated_bytes, allocated_bytes));
+}
+
+void allocation_sampler_test::run(test_runner& runner){
+    runner.run("allocation_sampler: estimated bytes match allocated bytes", estimated_bytes_match_allocated_bytes);
+    runner.run("allocation_sampler: region allocations are sampled", region_allocations_are_sampled);
+}
\ No newline at end of file
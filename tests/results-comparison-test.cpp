@@ -0,0 +1,56 @@
+#include "tests.hpp"
+
+#include <cmath>
+#include <format>
+
+metric_comparison results_comparison_test::compare(std::initializer_list<double> baseline, std::initializer_list<double> candidate){
+    results_document baseline_results("test");
+    results_document candidate_results("test");
+    indexed_stack<double> baseline_samples;
+    indexed_stack<double> candidate_samples;
+    for(double sample : baseline) baseline_samples.push(sample);
+    for(double sample : candidate) candidate_samples.push(sample);
+    baseline_results.add_metric("duration", "ns", metric_goal::lower, std::move(baseline_samples));
+    candidate_results.add_metric("duration", "ns", metric_goal::lower, std::move(candidate_samples));
+
+    results_comparison comparison;
+    comparison.compare(baseline_results, candidate_results);
+    test_runner::check(comparison.get_comparisons().get_size() == 1, "expected a single comparison");
+    return comparison.get_comparisons()[0];
+}
+
+void results_comparison_test::three_samples_insufficient(){
+    const metric_comparison comparison = compare({100, 101, 102}, {120, 121, 122});
+    test_runner::check(comparison.verdict == comparison_verdict::insufficient_samples, std::format("verdict {}", results_comparison::verdict_name(comparison.verdict)));
+}
+
+void results_comparison_test::separated_four_samples_regress(){
+    const metric_comparison comparison = compare({100, 101, 102, 103}, {120, 121, 122, 123});
+    test_runner::check(std::abs(comparison.p_value - 2.0 / 70) < 1e-12, std::format("p-value {}, expected 2/70", comparison.p_value));
+    test_runner::check(comparison.verdict == comparison_verdict::regression, std::format("verdict {}", results_comparison::verdict_name(comparison.verdict)));
+}
+
+void results_comparison_test::separated_five_samples_regress(){
+    const metric_comparison comparison = compare({100, 101, 102, 103, 104}, {120, 121, 122, 123, 124});
+    test_runner::check(std::abs(comparison.p_value - 2.0 / 252) < 1e-12, std::format("p-value {}, expected 2/252", comparison.p_value));
+    test_runner::check(comparison.verdict == comparison_verdict::regression, std::format("verdict {}", results_comparison::verdict_name(comparison.verdict)));
+}
+
+void results_comparison_test::separated_improvement_same_p_value(){
+    const metric_comparison comparison = compare({120, 121, 122, 123, 124}, {100, 101, 102, 103, 104});
+    test_runner::check(std::abs(comparison.p_value - 2.0 / 252) < 1e-12, std::format("p-value {}, expected 2/252", comparison.p_value));
+    test_runner::check(comparison.verdict == comparison_verdict::improvement, std::format("verdict {}", results_comparison::verdict_name(comparison.verdict)));
+}
+
+void results_comparison_test::interleaved_samples_unchanged(){
+    const metric_comparison comparison = compare({100, 110, 120, 130, 140}, {105, 115, 125, 135, 145});
+    test_runner::check(comparison.verdict == comparison_verdict::unchanged, std::format("verdict {}", results_comparison::verdict_name(comparison.verdict)));
+}
+
+void results_comparison_test::run(test_runner& runner){
+    runner.run("results_comparison: 3 vs 3 samples are too few", three_samples_insufficient);
+    runner.run("results_comparison: separated 4 vs 4 samples regress", separated_four_samples_regress);
+    runner.run("results_comparison: separated 5 vs 5 samples regress", separated_five_samples_regress);
+    runner.run("results_comparison: improvement has the p-value of the mirrored regression", separated_improvement_same_p_value);
+    runner.run("results_comparison: interleaved samples are unchanged", interleaved_samples_unchanged);
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "tests.hpp"
+
+#include <memory>
+
+#include "../src/heap-manager/heap-manager.hpp"
+#include "../src/root-set-table/global-root.hpp"
+#include "../src/root-set-table/register-root.hpp"
+#include "../src/root-set-table/thread-local-stack.hpp"
+
+/// size of the region object of the tests.
+constexpr uint32_t REGION_TEST_OBJECT_SIZE = 64;
+
+template<typename fn>
+bool scope_region_test::survives_region_pop(fn&& make_root){
+    heap_manager heap_mng(1);
+    thread_local_stack tls;
+    tls.push_region_scope();
+
+    header* obj = heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE);
+    test_runner::check(obj != nullptr && obj->is_region(), "object wasn't allocated in the region");
+
+    auto root = make_root(obj);
+    test_runner::check(obj->is_escaped(), "creating the root didn't record the escape");
+
+    heap_mng.pop_region_scope(tls);
+    return !obj->is_free();
+}
+
+void scope_region_test::global_root_constructor_records_escape(){
+    const bool survived = survives_region_pop([](header* obj) -> std::unique_ptr<global_root> {
+        return std::make_unique<global_root>(obj);
+    });
+    test_runner::check(survived, "object was freed with its region");
+}
+
+void scope_region_test::register_root_constructor_records_escape(){
+    const bool survived = survives_region_pop([](header* obj) -> std::unique_ptr<register_root> {
+        return std::make_unique<register_root>(obj);
+    });
+    test_runner::check(survived, "object was freed with its region");
+}
+
+thread_local_stack& scope_region_test::add_stack(heap_manager& heap_mng){
+    heap_mng.add_root("tls", std::make_unique<thread_local_stack>());
+    return *static_cast<thread_local_stack*>(heap_mng.get_root("tls"));
+}
+
+uint64_t scope_region_test::region_chunk_bytes(heap_manager& heap_mng){
+    const heap_stats stats = heap_mng.stats();
+    uint64_t bytes = 0;
+    for(const segment_stats& segment : stats.segments){
+        bytes += segment.region_chunk_bytes;
+    }
+    return bytes;
+}
+
+void scope_region_test::nested_scopes_release_inner_region(){
+    heap_manager heap_mng(1);
+    thread_local_stack& tls = add_stack(heap_mng);
+
+    tls.push_region_scope();
+    header* outer = heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE);
+    tls.push_region_scope();
+    header* inner = heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE);
+    test_runner::check(outer != nullptr && inner != nullptr && outer->region_id() != inner->region_id(), "nested scopes don't have their own regions");
+
+    heap_mng.pop_region_scope(tls);
+    test_runner::check(inner->is_free(), "inner region wasn't released");
+    test_runner::check(!outer->is_free(), "outer region was released with the inner one");
+    test_runner::check(heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE) != nullptr, "outer region can't allocate after the inner pop");
+
+    heap_mng.pop_region_scope(tls);
+    test_runner::check(outer->is_free(), "outer region wasn't released");
+}
+
+void scope_region_test::pop_returns_chunks_to_free_list(){
+    heap_manager heap_mng(1);
+    thread_local_stack& tls = add_stack(heap_mng);
+    const uint64_t initial_free_bytes = heap_mng.stats().total_free_bytes();
+
+    tls.push_region_scope();
+    for(uint32_t allocated = 0; allocated < 2 * REGION_CHUNK_SIZE; allocated += REGION_TEST_OBJECT_SIZE){
+        heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE);
+    }
+    test_runner::check(heap_mng.stats().total_free_bytes() < initial_free_bytes, "region didn't take chunks from the free lists");
+
+    heap_mng.pop_region_scope(tls);
+    test_runner::check(heap_mng.stats().total_free_bytes() == initial_free_bytes, "chunks weren't returned to the free lists");
+}
+
+void scope_region_test::region_chunk_bytes_cleared_after_pop(){
+    heap_manager heap_mng(1);
+    thread_local_stack& tls = add_stack(heap_mng);
+    auto fill_region = [&heap_mng, &tls] -> void {
+        tls.push_region_scope();
+        heap_mng.allocate_in_scope(tls, REGION_TEST_OBJECT_SIZE);
+        test_runner::check(region_chunk_bytes(heap_mng) != 0, "region chunk wasn't counted");
+    };
+
+    fill_region();
+    heap_mng.pop_region_scope(tls);
+    test_runner::check(region_chunk_bytes(heap_mng) == 0, "pop_region_scope left region chunk bytes");
+
+    fill_region();
+    tls.pop_scope();
+    test_runner::check(region_chunk_bytes(heap_mng) == 0, "pop_scope left region chunk bytes");
+
+    fill_region();
+    heap_mng.remove_root("tls");
+    test_runner::check(region_chunk_bytes(heap_mng) == 0, "destroyed stack left region chunk bytes");
+}
+
+void scope_region_test::run(test_runner& runner){
+    runner.run("scope_region: nested scopes release the inner region", nested_scopes_release_inner_region);
+    runner.run("scope_region: pop returns chunks to the free list", pop_returns_chunks_to_free_list);
+    runner.run("scope_region: region chunk bytes cleared after pop", region_chunk_bytes_cleared_after_pop);
+    runner.run("scope_region: global root constructor records escape", global_root_constructor_records_escape);
+    runner.run("scope_region: register root constructor records escape", register_root_constructor_records_escape);
+}
\ No newline at end of file
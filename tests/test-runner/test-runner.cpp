@@ -0,0 +1,32 @@
+#include "test-runner.hpp"
+
+#include <exception>
+#include <format>
+#include <iostream>
+
+test_runner::test_runner() noexcept : passed(0), failed(0) {}
+
+void test_runner::run(std::string_view name, void (*test)()){
+    try {
+        test();
+        ++passed;
+        std::cout << std::format("[PASS] {}\n", name);
+    }
+    catch(const std::exception& e){
+        ++failed;
+        std::cout << std::format("[FAIL] {}: {}\n", name, e.what());
+    }
+}
+
+void test_runner::check(bool condition, std::string_view message, std::source_location location){
+    if(condition) return;
+    throw test_failure(std::format("{}:{}: {}", location.file_name(), location.line(), message));
+}
+
+void test_runner::summary() const {
+    std::cout << std::format("{} passed, {} failed\n", passed, failed);
+}
+
+size_t test_runner::get_failed_count() const noexcept {
+    return failed;
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef TEST_RUNNER_HPP
+#define TEST_RUNNER_HPP
+
+#include <cstddef>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @class test_failure
+ * @brief thrown by test_runner::check when the checked condition doesn't hold.
+*/
+class test_failure : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @class test_runner
+ * @brief runs test cases, reports each as passed or failed.
+ * @details test case fails if it throws, checks throw test_failure with the location of the failed check.
+*/
+class test_runner {
+private:
+    /// number of passed test cases.
+    size_t passed;
+
+    /// number of failed test cases.
+    size_t failed;
+
+public:
+    /**
+     * @brief creates the runner without results.
+    */
+    test_runner() noexcept;
+
+    /**
+     * @brief deletes the runner.
+    */
+    ~test_runner() = default;
+
+    /// deleted copy constructor.
+    test_runner(const test_runner&) = delete;
+
+    /// deleted assignment operator.
+    test_runner& operator=(const test_runner&) = delete;
+
+    /**
+     * @brief runs the test case and prints its result.
+     * @param name - name of the test case.
+     * @param test - pointer to the test case.
+    */
+    void run(std::string_view name, void (*test)());
+
+    /**
+     * @brief fails the test case if the condition doesn't hold.
+     * @param condition - checked condition.
+     * @param message - description of the failure.
+     * @param location - location of the check, defaults to the location of the caller.
+     * @throws test_failure if condition is false.
+    */
+    static void check(bool condition, std::string_view message, std::source_location location = std::source_location::current());
+
+    /**
+     * @brief prints the number of passed and failed test cases.
+    */
+    void summary() const;
+
+    /**
+     * @brief getter for the number of failed test cases.
+     * @returns number of failed test cases.
+    */
+    size_t get_failed_count() const noexcept;
+
+};
+
+#endif
\ No newline at end of file
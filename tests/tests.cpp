@@ -0,0 +1,12 @@
+#include "tests.hpp"
+
+int main() {
+    test_runner runner;
+
+    allocation_sampler_test::run(runner);
+    results_comparison_test::run(runner);
+    scope_region_test::run(runner);
+
+    runner.summary();
+    return runner.get_failed_count() == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#ifndef TESTS_HPP
+#define TESTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "test-runner/test-runner.hpp"
+#include "../src/results-comparison/results-comparison.hpp"
+#include "../src/heap-manager/heap-manager.hpp"
+#include "../src/root-set-table/thread-local-stack.hpp"
+
+/**
+ * @class allocation_sampler_test
+ * @brief tests of the poisson-sampled allocation site profiler.
+*/
+class allocation_sampler_test {
+private:
+    /**
+     * @brief checks that estimated bytes of many short-lived threads are close to the allocated bytes.
+     * @details first allocation of a thread mustn't be sampled more often than any other one.
+    */
+    static void estimated_bytes_match_allocated_bytes();
+
+    /**
+     * @brief checks that objects bump-allocated in a region are sampled like the ones of allocate.
+    */
+    static void region_allocations_are_sampled();
+
+public:
+    /**
+     * @brief runs the test cases of the group.
+     * @param runner - reference to the test runner.
+    */
+    static void run(test_runner& runner);
+
+};
+
+/**
+ * @class results_comparison_test
+ * @brief tests of the regression detection of the results comparison.
+*/
+class results_comparison_test {
+private:
+    /**
+     * @brief compares a metric of the baseline and the candidate.
+     * @param baseline - samples of the baseline.
+     * @param candidate - samples of the candidate.
+     * @returns comparison of the metric, lower values are better.
+    */
+    static metric_comparison compare(std::initializer_list<double> baseline, std::initializer_list<double> candidate);
+
+    /**
+     * @brief checks that 3 vs 3 samples, which can't reach the significance level two-sided, aren't tested.
+    */
+    static void three_samples_insufficient();
+
+    /**
+     * @brief checks that clearly separated 4 vs 4 samples are flagged as a regression with the exact two-sided p-value.
+    */
+    static void separated_four_samples_regress();
+
+    /**
+     * @brief checks that clearly separated 5 vs 5 samples are flagged as a regression with the exact two-sided p-value.
+    */
+    static void separated_five_samples_regress();
+
+    /**
+     * @brief checks that the p-value doesn't depend on the direction of the change.
+    */
+    static void separated_improvement_same_p_value();
+
+    /**
+     * @brief checks that interleaved samples aren't flagged.
+    */
+    static void interleaved_samples_unchanged();
+
+public:
+    /**
+     * @brief runs the test cases of the group.
+     * @param runner - reference to the test runner.
+    */
+    static void run(test_runner& runner);
+
+};
+
+/**
+ * @class scope_region_test
+ * @brief tests of the scope regions, their release and escape tracking.
+*/
+class scope_region_test {
+private:
+    /**
+     * @brief adds a thread local stack to the roots of the heap.
+     * @param heap_mng - reference to the heap manager.
+     * @returns reference to the stack, owned by the heap until its root is removed.
+    */
+    static thread_local_stack& add_stack(heap_manager& heap_mng);
+
+    /**
+     * @brief sums the bytes held by region chunks over the segments.
+     * @param heap_mng - reference to the heap manager.
+     * @returns number of bytes held by region chunks.
+    */
+    static uint64_t region_chunk_bytes(heap_manager& heap_mng);
+
+    /**
+     * @brief checks that popping the inner of two nested region scopes frees only its own objects.
+    */
+    static void nested_scopes_release_inner_region();
+
+    /**
+     * @brief checks that the free bytes of the heap return to their initial value once the region is popped.
+    */
+    static void pop_returns_chunks_to_free_list();
+
+    /**
+     * @brief checks that region chunk bytes go back to 0 after pop_region_scope, pop_scope and removing the stack.
+    */
+    static void region_chunk_bytes_cleared_after_pop();
+
+    /**
+     * @brief allocates an object in a region, roots it with the root created from it and pops the region.
+     * @param make_root - creates the root from the object and returns it, the root is kept until the region is popped.
+     * @returns true if the object survived the pop of its region.
+    */
+    template<typename fn>
+    static bool survives_region_pop(fn&& make_root);
+
+    /**
+     * @brief checks that a global root created from a region object keeps the object when the region is popped.
+    */
+    static void global_root_constructor_records_escape();
+
+    /**
+     * @brief checks that a register root created from a region object keeps the object when the region is popped.
+    */
+    static void register_root_constructor_records_escape();
+
+public:
+    /**
+     * @brief runs the test cases of the group.
+     * @param runner - reference to the test runner.
+    */
+    static void run(test_runner& runner);
+
+};
+
+#endif
\ No newline at end of file